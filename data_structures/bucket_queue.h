@@ -0,0 +1,272 @@
+#ifndef ALGO_BUCKET_QUEUE_H
+#define ALGO_BUCKET_QUEUE_H
+#include <memory>
+#include <vector>
+#include <bit>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+
+/** Monotone integer priority queues ********************************************************
+ * Both queues below have the surface of IndexMinPriorityQueue (insert / decreaseKey / pop
+ * returning the index) but only accept unsigned integer keys and require that no key is
+ * ever smaller than the last popped one - which always holds for Dijkstra with
+ * non-negative weights. In exchange pop-min is O(C) (BucketQueue, C = max edge weight)
+ * or amortized O(log C) (RadixHeap) instead of O(log V), and nothing is ever compared.
+ */
+namespace data_structures {
+    namespace detail {
+        /** Doubly linked lists threaded through three per-index arrays, so moving an
+         * element between buckets never allocates.
+         */
+        struct BucketLists {
+            static constexpr int none = -1;
+            static constexpr int absent = -2;
+
+            std::unique_ptr<int[]> next_{};
+            std::unique_ptr<int[]> prev_{};     // absent if the index is not queued
+            std::unique_ptr<size_t[]> bucket_{};
+
+            explicit BucketLists(size_t capacity)
+                    : next_{new int[capacity]},
+                      prev_{new int[capacity]},
+                      bucket_{new size_t[capacity]} {
+                std::fill(prev_.get(), prev_.get() + capacity, absent);
+            }
+
+            [[nodiscard]]
+            bool contains(int i) const {
+                return prev_[i] != absent;
+            }
+
+            void link(std::vector<int> &head, int i, size_t b) {
+                bucket_[i] = b;
+                prev_[i] = none;
+                next_[i] = head[b];
+                if (head[b] != none) prev_[head[b]] = i;
+                head[b] = i;
+            }
+
+            void unlink(std::vector<int> &head, int i) {
+                if (prev_[i] != none) next_[prev_[i]] = next_[i];
+                else head[bucket_[i]] = next_[i];
+                if (next_[i] != none) prev_[next_[i]] = prev_[i];
+                prev_[i] = absent;
+            }
+        };
+    }
+
+    /** Dial's algorithm queue: a ring of buckets, one per key value. The ring covers
+     * [cursor, cursor + ring size) and doubles whenever a key falls outside of it,
+     * so it ends up C+1 buckets wide without being told C up front.
+     */
+    template<typename Key = unsigned>
+    struct BucketQueue {
+        static_assert(std::is_unsigned_v<Key>);
+    private:
+        detail::BucketLists lists_;
+        std::unique_ptr<Key[]> keys_{};
+        std::vector<int> head_;
+        Key cursor_{0};
+        size_t size_, capacity_;
+
+        [[nodiscard]]
+        size_t slot(Key key) const {
+            return static_cast<size_t>(key) & (head_.size() - 1);
+        }
+
+        void validate(int i) const {
+            if (i < 0 || static_cast<size_t>(i) >= capacity_)
+                throw std::out_of_range("index is out of boundaries");
+        }
+
+        void reserve(Key key) {
+            if (key < cursor_) throw std::invalid_argument("key is below the last popped minimum");
+            const auto span = static_cast<size_t>(key - cursor_);
+            if (span < head_.size()) return;
+            std::vector<int> old(std::bit_ceil(span + 1), detail::BucketLists::none);
+            std::swap(old, head_);
+            for (int first : old)
+                for (int i = first, next; i != detail::BucketLists::none; i = next) {
+                    next = lists_.next_[i];
+                    lists_.link(head_, i, slot(keys_[i]));
+                }
+        }
+
+    public:
+        using key_type = Key;
+
+        explicit BucketQueue(size_t capacity)
+                : lists_(capacity),
+                  keys_{new Key[capacity]},
+                  head_(1, detail::BucketLists::none),
+                  size_(0),
+                  capacity_(capacity) {}
+
+        BucketQueue<Key> &
+        insert(int i, Key key) {
+            validate(i);
+            if (contains(i)) throw std::invalid_argument("index is already on the queue");
+            reserve(key);
+            keys_[i] = key;
+            lists_.link(head_, i, slot(key));
+            ++size_;
+            return *this;
+        }
+
+        BucketQueue<Key> &
+        decreaseKey(int i, Key key) {
+            validate(i);
+            if (!contains(i)) throw std::invalid_argument("index is not on the queue");
+            if (keys_[i] < key) throw std::invalid_argument("key would increase");
+            if (key < cursor_) throw std::invalid_argument("key is below the last popped minimum");
+            lists_.unlink(head_, i);
+            keys_[i] = key;
+            lists_.link(head_, i, slot(key));
+            return *this;
+        }
+
+        [[nodiscard]]
+        bool contains(int i) const {
+            return lists_.contains(i);
+        }
+
+        [[nodiscard]]
+        const Key &key(int i) const {
+            return keys_[i];
+        }
+
+        int pop() {
+            if (empty()) throw std::out_of_range("queue is empty");
+            while (head_[slot(cursor_)] == detail::BucketLists::none) ++cursor_;
+            int min = head_[slot(cursor_)];
+            lists_.unlink(head_, min);
+            --size_;
+            return min;
+        }
+
+        [[nodiscard]]
+        bool empty() const {
+            return size_ == 0;
+        }
+
+        [[nodiscard]]
+        size_t size() const {
+            return size_;
+        }
+
+        [[nodiscard]]
+        size_t capacity() const {
+            return capacity_;
+        }
+    };
+
+    /** Radix heap: bucket b holds the keys whose highest bit differing from the last
+     * popped key is b-1 (bucket 0 holds keys equal to it). Every element moves to a
+     * strictly lower bucket each time it is redistributed, hence amortized O(log C).
+     */
+    template<typename Key = unsigned>
+    struct RadixHeap {
+        static_assert(std::is_unsigned_v<Key>);
+    private:
+        detail::BucketLists lists_;
+        std::unique_ptr<Key[]> keys_{};
+        std::vector<int> head_;
+        Key last_{0};
+        size_t size_, capacity_;
+
+        [[nodiscard]]
+        size_t bucketOf(Key key) const {
+            return static_cast<size_t>(std::bit_width(static_cast<Key>(key ^ last_)));
+        }
+
+        void validate(int i) const {
+            if (i < 0 || static_cast<size_t>(i) >= capacity_)
+                throw std::out_of_range("index is out of boundaries");
+        }
+
+        void redistribute() {
+            size_t b = 1;
+            while (head_[b] == detail::BucketLists::none) ++b;
+            Key min = std::numeric_limits<Key>::max();
+            for (int i = head_[b]; i != detail::BucketLists::none; i = lists_.next_[i])
+                min = std::min(min, keys_[i]);
+            last_ = min;
+            int first = head_[b];
+            head_[b] = detail::BucketLists::none;
+            for (int i = first, next; i != detail::BucketLists::none; i = next) {
+                next = lists_.next_[i];
+                lists_.link(head_, i, bucketOf(keys_[i]));
+            }
+        }
+
+    public:
+        using key_type = Key;
+
+        explicit RadixHeap(size_t capacity)
+                : lists_(capacity),
+                  keys_{new Key[capacity]},
+                  head_(std::numeric_limits<Key>::digits + 1, detail::BucketLists::none),
+                  size_(0),
+                  capacity_(capacity) {}
+
+        RadixHeap<Key> &
+        insert(int i, Key key) {
+            validate(i);
+            if (contains(i)) throw std::invalid_argument("index is already on the queue");
+            if (key < last_) throw std::invalid_argument("key is below the last popped minimum");
+            keys_[i] = key;
+            lists_.link(head_, i, bucketOf(key));
+            ++size_;
+            return *this;
+        }
+
+        RadixHeap<Key> &
+        decreaseKey(int i, Key key) {
+            validate(i);
+            if (!contains(i)) throw std::invalid_argument("index is not on the queue");
+            if (keys_[i] < key) throw std::invalid_argument("key would increase");
+            if (key < last_) throw std::invalid_argument("key is below the last popped minimum");
+            lists_.unlink(head_, i);
+            keys_[i] = key;
+            lists_.link(head_, i, bucketOf(key));
+            return *this;
+        }
+
+        [[nodiscard]]
+        bool contains(int i) const {
+            return lists_.contains(i);
+        }
+
+        [[nodiscard]]
+        const Key &key(int i) const {
+            return keys_[i];
+        }
+
+        int pop() {
+            if (empty()) throw std::out_of_range("queue is empty");
+            if (head_[0] == detail::BucketLists::none) redistribute();
+            int min = head_[0];
+            lists_.unlink(head_, min);
+            --size_;
+            return min;
+        }
+
+        [[nodiscard]]
+        bool empty() const {
+            return size_ == 0;
+        }
+
+        [[nodiscard]]
+        size_t size() const {
+            return size_;
+        }
+
+        [[nodiscard]]
+        size_t capacity() const {
+            return capacity_;
+        }
+    };
+}
+#endif //ALGO_BUCKET_QUEUE_H
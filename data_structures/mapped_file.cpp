@@ -0,0 +1,77 @@
+#include "mapped_file.h"
+#include <utility>
+#include <fstream>
+#include <stdexcept>
+
+#if __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#define ALGO_HAVE_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace data_structures {
+    MappedFile::MappedFile(const std::string& path) {
+#ifdef ALGO_HAVE_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open " + path);
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map " + path);
+            }
+            data_ = static_cast<const char*>(p);
+            mapped_ = true;
+        }
+        ::close(fd);
+#else
+        std::ifstream is(path, std::ios::binary | std::ios::ate);
+        if (!is) throw std::runtime_error("Cannot open " + path);
+        size_ = static_cast<size_t>(is.tellg());
+        buffer_.resize((size_ + sizeof(Line) - 1) / sizeof(Line));
+        is.seekg(0);
+        if (!is.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(size_)))
+            throw std::runtime_error("Cannot read " + path);
+        data_ = reinterpret_cast<const char*>(buffer_.data());
+#endif
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+        , mapped_(std::exchange(other.mapped_, false))
+        , buffer_(std::move(other.buffer_))
+    {}
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            mapped_ = std::exchange(other.mapped_, false);
+            buffer_ = std::move(other.buffer_);
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile() {
+        release();
+    }
+
+    void MappedFile::release() noexcept {
+#ifdef ALGO_HAVE_MMAP
+        if (mapped_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+        mapped_ = false;
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef ALGO_MAPPED_FILE_H
+#define ALGO_MAPPED_FILE_H
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <string_view>
+
+namespace data_structures {
+    /** Read-only view of a whole file: mmap where POSIX has it, a plain read otherwise.
+     * The data is page aligned when mapped and cache-line (64-byte) aligned when read,
+     * so arrays laid out at such offsets, SIMD blocks included, can be used in place
+     * either way.
+     */
+    class MappedFile {
+    private:
+        struct alignas(64) Line {
+            char bytes[64];
+        };
+
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+        bool mapped_ = false;
+        std::vector<Line> buffer_;
+
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const std::string& path);
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile();
+        [[nodiscard]]
+        const char* data() const noexcept { return data_; }
+        [[nodiscard]]
+        size_t size() const noexcept { return size_; }
+        [[nodiscard]]
+        std::string_view view() const noexcept { return {data_, size_}; }
+
+    private:
+        void release() noexcept;
+    };
+}
+
+#endif //ALGO_MAPPED_FILE_H
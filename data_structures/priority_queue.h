@@ -2,6 +2,10 @@
 #define ALGO_PRIORITY_QUEUE_H
 #include <limits>
 #include <type_traits>
+#include <memory>
+#include <stdexcept>
+#include <algorithm>
+#include <concepts>
 
 namespace data_structures {
     template<typename T, bool Min>
@@ -59,15 +63,16 @@ namespace data_structures {
 
     public:
         explicit PriorityQueue(size_t capacity)
-                : pq_{new T[capacity]},
+                : pq_{new T[capacity + 1]},     // 1-based heap
                   size_(0),
                   capacity_(capacity) {
-            for (int i = 0; i < capacity_; i++)
+            for (size_t i = 0; i <= capacity_; i++)
                 pq_[i] = T{this->reverse_extremum};
         }
 
         PriorityQueue<T, Min> &
         insert(T a) {
+            if (size_ == capacity_) throw std::out_of_range("queue is full");
             pq_[++size_] = a;
             swim(size_);
             return *this;
@@ -110,5 +115,150 @@ namespace data_structures {
     using MinPriorityQueue = PriorityQueue<T, true>;
     template<typename T>
     using MaxPriorityQueue = PriorityQueue<T, false>;
+
+    /** Indexed priority queue ********************************************************
+     * Binary heap over the indices [0, capacity) with a key attached to every index.
+     * Unlike PriorityQueue the key of an element already on the queue can be lowered,
+     * which is what Dijkstra/Prim need; pop() hands back the index, not the key.
+     */
+    template<typename Key>
+    struct IndexMinPriorityQueue {
+    private:
+        std::unique_ptr<int[]> pq_{};   // heap position -> index (1-based)
+        std::unique_ptr<int[]> qp_{};   // index -> heap position, -1 if absent
+        std::unique_ptr<Key[]> keys_{};
+        size_t size_, capacity_;
+
+        bool greater(size_t i, size_t j) const {
+            return keys_[pq_[j]] < keys_[pq_[i]];
+        }
+
+        void exch(size_t i, size_t j) {
+            std::swap(pq_[i], pq_[j]);
+            qp_[pq_[i]] = static_cast<int>(i);
+            qp_[pq_[j]] = static_cast<int>(j);
+        }
+
+        void swim(size_t k) {
+            while (k > 1 && greater(k / 2, k)) {
+                exch(k, k / 2);
+                k /= 2;
+            }
+        }
+
+        void sink(size_t k) {
+            while (2 * k <= size_) {
+                size_t j = 2 * k;
+                if (j < size_ && greater(j, j + 1)) j++;
+                if (!greater(k, j)) break;
+                exch(k, j);
+                k = j;
+            }
+        }
+
+        void validate(int i) const {
+            if (i < 0 || static_cast<size_t>(i) >= capacity_)
+                throw std::out_of_range("index is out of boundaries");
+        }
+
+    public:
+        using key_type = Key;
+
+        explicit IndexMinPriorityQueue(size_t capacity)
+                : pq_{new int[capacity + 1]},
+                  qp_{new int[capacity]},
+                  keys_{new Key[capacity]},
+                  size_(0),
+                  capacity_(capacity) {
+            std::fill(qp_.get(), qp_.get() + capacity_, -1);
+        }
+
+        IndexMinPriorityQueue<Key> &
+        insert(int i, Key key) {
+            validate(i);
+            if (contains(i)) throw std::invalid_argument("index is already on the queue");
+            qp_[i] = static_cast<int>(++size_);
+            pq_[size_] = i;
+            keys_[i] = key;
+            swim(size_);
+            return *this;
+        }
+
+        IndexMinPriorityQueue<Key> &
+        decreaseKey(int i, Key key) {
+            validate(i);
+            if (!contains(i)) throw std::invalid_argument("index is not on the queue");
+            if (keys_[i] < key) throw std::invalid_argument("key would increase");
+            keys_[i] = key;
+            swim(qp_[i]);
+            return *this;
+        }
+
+        [[nodiscard]]
+        bool contains(int i) const {
+            validate(i);
+            return qp_[i] != -1;
+        }
+
+        [[nodiscard]]
+        const Key &key(int i) const {
+            validate(i);
+            return keys_[i];
+        }
+
+        [[nodiscard]]
+        int minIndex() const {
+            if (empty()) throw std::out_of_range("queue is empty");
+            return pq_[1];
+        }
+
+        [[nodiscard]]
+        const Key &minKey() const {
+            return keys_[minIndex()];
+        }
+
+        int pop() {
+            if (empty()) throw std::out_of_range("queue is empty");
+            int min = pq_[1];
+            exch(1, size_--);
+            sink(1);
+            qp_[min] = -1;
+            return min;
+        }
+
+        // O(size), not O(capacity): a queue reused across searches only pays for what it held
+        void clear() {
+            for (size_t k = 1; k <= size_; ++k) qp_[pq_[k]] = -1;
+            size_ = 0;
+        }
+
+        [[nodiscard]]
+        bool empty() const {
+            return size_ == 0;
+        }
+
+        [[nodiscard]]
+        size_t size() const {
+            return size_;
+        }
+
+        [[nodiscard]]
+        size_t capacity() const {
+            return capacity_;
+        }
+    };
+
+    /** Anything a shortest-path search can use as its frontier: IndexMinPriorityQueue,
+     * BucketQueue or RadixHeap.
+     */
+    template<typename Q>
+    concept IndexedMinQueue = requires(Q q, const Q cq, int i, typename Q::key_type k) {
+        q.insert(i, k);
+        q.decreaseKey(i, k);
+        { q.pop() } -> std::convertible_to<int>;
+        { cq.contains(i) } -> std::convertible_to<bool>;
+        { cq.key(i) } -> std::convertible_to<typename Q::key_type>;
+        { cq.empty() } -> std::convertible_to<bool>;
+    };
 }
 #endif //ALGO_PRIORITY_QUEUE_H
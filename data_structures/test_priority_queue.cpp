@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
+#include <random>
 #include "priority_queue.h"
+#include "bucket_queue.h"
 using namespace data_structures;
 
 TEST(test_priority_queue, MaxPQ) {
@@ -52,4 +54,89 @@ TEST(test_priority_queue, MinPQ) {
     std::cerr << min << ' ';
     EXPECT_EQ(min, 5);
     EXPECT_THROW(minpq.pop(), std::out_of_range);
-}
\ No newline at end of file
+}
+TEST(test_priority_queue, IndexMinPQ) {
+    IndexMinPriorityQueue<double> pq(5);
+    pq.insert(0, 5.0)
+      .insert(1, 3.0)
+      .insert(2, 4.0)
+      .insert(3, 1.5);
+    EXPECT_EQ(pq.minIndex(), 3);
+    pq.decreaseKey(0, 1.0);
+    EXPECT_EQ(pq.pop(), 0);
+    EXPECT_EQ(pq.pop(), 3);
+    EXPECT_FALSE(pq.contains(3));
+    EXPECT_EQ(pq.pop(), 1);
+    EXPECT_EQ(pq.pop(), 2);
+    EXPECT_THROW(pq.pop(), std::out_of_range);
+    EXPECT_THROW(pq.insert(5, 0.0), std::out_of_range);
+    EXPECT_THROW((void)pq.contains(-1), std::out_of_range);
+    EXPECT_THROW((void)pq.contains(5), std::out_of_range);
+    EXPECT_THROW((void)pq.key(5), std::out_of_range);
+    pq.insert(4, 2.0).insert(1, 1.0);
+    pq.clear();
+    EXPECT_TRUE(pq.empty());
+    EXPECT_FALSE(pq.contains(4));
+    pq.insert(4, 0.5);
+    EXPECT_EQ(pq.pop(), 4);
+}
+
+// Dijkstra over a fixed random digraph with small integer weights: popped keys never
+// decrease and every queue must end up with the same distances, whatever order it breaks
+// ties in.
+template<typename Q>
+static std::vector<unsigned> dijkstra_run(unsigned seed) {
+    constexpr int n = 1000, out = 4;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<unsigned> weight(0, 100);
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    std::vector<std::pair<int, unsigned>> adj(n * out);
+    for (auto& [w, c] : adj) { w = vertex(gen); c = weight(gen); }
+
+    Q q(n);
+    std::vector<unsigned> dist(n, std::numeric_limits<unsigned>::max());
+    dist[0] = 0;
+    q.insert(0, 0u);
+    unsigned last = 0;
+    while (!q.empty()) {
+        int v = q.pop();
+        EXPECT_LE(last, dist[v]);
+        last = dist[v];
+        for (int k = v * out; k < (v + 1) * out; ++k) {
+            auto [w, c] = adj[k];
+            if (dist[v] + c >= dist[w]) continue;
+            dist[w] = dist[v] + c;
+            if (q.contains(w)) q.decreaseKey(w, dist[w]);
+            else q.insert(w, dist[w]);
+        }
+    }
+    return dist;
+}
+
+TEST(test_priority_queue, BucketQueue) {
+    BucketQueue<unsigned> bq(4);
+    bq.insert(0, 7u).insert(1, 2u).insert(2, 300u);
+    EXPECT_EQ(bq.pop(), 1);
+    bq.decreaseKey(2, 3u);
+    EXPECT_EQ(bq.pop(), 2);
+    EXPECT_THROW(bq.insert(3, 1u), std::invalid_argument);
+    EXPECT_EQ(bq.pop(), 0);
+    EXPECT_THROW(bq.pop(), std::out_of_range);
+
+    EXPECT_EQ(dijkstra_run<BucketQueue<unsigned>>(42),
+              dijkstra_run<IndexMinPriorityQueue<unsigned>>(42));
+}
+
+TEST(test_priority_queue, RadixHeap) {
+    RadixHeap<unsigned> rh(4);
+    rh.insert(0, 7u).insert(1, 2u).insert(2, 300u);
+    EXPECT_EQ(rh.pop(), 1);
+    rh.decreaseKey(2, 3u);
+    EXPECT_EQ(rh.pop(), 2);
+    EXPECT_THROW(rh.insert(3, 1u), std::invalid_argument);
+    EXPECT_EQ(rh.pop(), 0);
+    EXPECT_THROW(rh.pop(), std::out_of_range);
+
+    EXPECT_EQ(dijkstra_run<RadixHeap<unsigned>>(7),
+              dijkstra_run<IndexMinPriorityQueue<unsigned>>(7));
+}
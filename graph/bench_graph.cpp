@@ -0,0 +1,237 @@
+// Traversal benchmarks: plain chrono timings, best of a few runs.
+//   bench_graph [side [threads]]    grid side length, default 1000 (a side^2-vertex graph);
+//                                   threads for the vertex programs, default all cores
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <string>
+#include "graph.h"
+#include "reorder.h"
+#include "msbfs.h"
+#include "p2p.h"
+#include "ch.h"
+#include "vertex_program.h"
+#include "cohesion.h"
+#include "flow.h"
+
+using namespace graph;
+
+template<typename F>
+static double best(F&& f, int runs = 3) {
+    double best = 1e300;
+    for (int r = 0; r < runs; ++r) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const std::chrono::duration<double> took = std::chrono::steady_clock::now() - start;
+        best = std::min(best, took.count());
+    }
+    return best;
+}
+
+template<size_t Width>
+static void multiSource(const char* name, const Graph& g, const std::vector<int>& sources) {
+    long long sink = 0;
+    const double took = best([&] {
+        multiSourceBFS<Width>(g, sources, [&sink](const auto& batch, size_t) {
+            sink += batch.distTo(0, 0);
+        }, false, 1);
+    }, 1);
+    std::printf("%-12s %10.3f%s\n", name, took * 1e3 / sources.size(), sink < -1 ? "!" : "");
+}
+
+// a grid with a few random shortcuts, every id shuffled: good locality hidden behind
+// ids from "an external system"
+static Graph shuffledGrid(int side, std::mt19937& gen) {
+    const int V = side * side;
+    std::vector<int> id(V);
+    std::iota(id.begin(), id.end(), 0);
+    std::shuffle(id.begin(), id.end(), gen);
+    std::uniform_int_distribution<int> any(0, V - 1);
+    std::vector<std::pair<int, int>> edges;
+    for (int r = 0; r < side; ++r)
+        for (int c = 0; c < side; ++c) {
+            const int v = r * side + c;
+            if (c + 1 < side) edges.emplace_back(id[v], id[v + 1]);
+            if (r + 1 < side) edges.emplace_back(id[v], id[v + side]);
+        }
+    for (int i = 0; i < V / 100; ++i) edges.emplace_back(any(gen), any(gen));
+    return {V, edges};
+}
+
+static void row(const char* name, const Graph& g, double reorder) {
+    int sink = 0;
+    const double bfs = best([&] { sink += BreadthFirstPaths(g, 0).hasPathTo(g.V() - 1); });
+    const double cc = best([&] { sink += CC(g).count(); });
+    std::printf("%-12s %10.1f %10.1f %12.1f%s\n", name, bfs * 1e3, cc * 1e3, reorder * 1e3, sink < 0 ? "!" : "");
+}
+
+int main(int argc, char** argv) {
+    const int side = argc > 1 ? std::atoi(argv[1]) : 1000;
+    std::mt19937 gen(1);
+    const Graph g = shuffledGrid(side, gen);
+    std::printf("%d vertices, %d edges\n", g.V(), g.E());
+    std::printf("%-12s %10s %10s %12s\n", "order", "BFS ms", "CC ms", "reorder ms");
+    row("shuffled", g, 0);
+
+    Permutation p;
+    double took = best([&] { p = rcmOrder(g); }, 1);
+    row("rcm", apply(g, p), took);
+    took = best([&] { p = degreeOrder(g); }, 1);
+    row("degree", apply(g, p), took);
+    took = best([&] { p = communityOrder(g); }, 1);
+    row("community", apply(g, p), took);
+
+    // cost per source, single thread: one BFS at a time vs. bit-parallel batches, on a
+    // small-world graph where the searches overlap level by level
+    const int n = g.V() / 4;
+    std::uniform_int_distribution<int> any(0, n - 1);
+    std::vector<std::pair<int, int>> edges(5 * static_cast<size_t>(n));
+    for (auto& [v, w] : edges) v = any(gen), w = any(gen);
+    const Graph local(n, edges);
+    std::vector<int> sources(512);
+    for (int& s : sources) s = any(gen);
+    std::printf("\n%-12s %10s\n", "BFS kind", "ms/source");
+    int sink = 0;
+    const double single = best([&] {
+        for (int i = 0; i < 16; ++i) sink += BreadthFirstPaths(local, sources[i]).hasPathTo(0);
+    }, 1);
+    std::printf("%-12s %10.3f%s\n", "one-by-one", single * 1e3 / 16, sink < 0 ? "!" : "");
+    multiSource<64>("ms-bfs 64", local, sources);
+    multiSource<256>("ms-bfs 256", local, sources);
+    multiSource<512>("ms-bfs 512", local, sources);
+
+    // point-to-point queries on a stand-in for a road network: a street grid where every
+    // 8th row and column is a road twice as fast and every 32nd a highway, four times
+    const int roads = side / 4;
+    std::uniform_real_distribution<double> length(1.0, 2.0);
+    auto speed = [](int line) { return line % 32 == 0 ? 4.0 : line % 8 == 0 ? 2.0 : 1.0; };
+    std::vector<DirectedEdge> streets;
+    for (int r = 0; r < roads; ++r)
+        for (int c = 0; c < roads; ++c) {
+            const int v = r * roads + c;
+            if (c + 1 < roads) {
+                const double l = length(gen) / speed(r);
+                streets.emplace_back(v, v + 1, l);
+                streets.emplace_back(v + 1, v, l);
+            }
+            if (r + 1 < roads) {
+                const double l = length(gen) / speed(c);
+                streets.emplace_back(v, v + roads, l);
+                streets.emplace_back(v + roads, v, l);
+            }
+        }
+    const EdgeWeightedDigraph grid(roads * roads, streets);
+    std::uniform_int_distribution<int> spot(0, grid.V() - 1);
+    std::vector<std::pair<int, int>> queries(32);
+    for (auto& [s, t] : queries) s = spot(gen), t = spot(gen);
+    std::optional<Landmarks> alt;
+    const double prep = best([&] { alt.emplace(grid, 16); }, 1);
+    BidirectionalDijkstra bidi(grid);
+    AStarSearch astar(grid, *alt);
+    double sum = 0;
+    std::printf("\n%-12s %10s %10s   (%d vertices, landmarks %.0f ms)\n", "search", "ms/query", "settled",
+                grid.V(), prep * 1e3);
+    const double dijkstra = best([&] {
+        for (auto [s, t] : queries) sum += DijkstraSP(grid, s).distTo(t);
+    }, 1);
+    std::printf("%-12s %10.3f %10d\n", "dijkstra", dijkstra * 1e3 / queries.size(), grid.V());
+    size_t settled = 0;
+    const double twoWay = best([&] {
+        for (auto [s, t] : queries) sum += bidi.distance(s, t), settled += bidi.settled();
+    }, 1);
+    std::printf("%-12s %10.3f %10zu\n", "bidirection", twoWay * 1e3 / queries.size(), settled / queries.size());
+    settled = 0;
+    const double landmarks = best([&] {
+        for (auto [s, t] : queries) sum += astar.distance(s, t), settled += astar.settled();
+    }, 1);
+    std::printf("%-12s %10.3f %10zu\n", "alt", landmarks * 1e3 / queries.size(), settled / queries.size());
+    std::optional<ContractionHierarchy> ch;
+    const double contraction = best([&] { ch.emplace(grid); }, 1);
+    CHSearch hierarchy(*ch);
+    settled = 0;
+    const double upward = best([&] {
+        for (auto [s, t] : queries) sum += hierarchy.distance(s, t), settled += hierarchy.settled();
+    }, 1);
+    std::printf("%-12s %10.3f %10zu   (%zu shortcuts, contraction %.0f ms)%s\n", "ch", upward * 1e3 / queries.size(),
+                settled / queries.size(), ch->shortcuts(), contraction * 1e3, sum < 0 ? "!" : "");
+
+    // vertex programs on a digraph of side^2 vertices and 16 edges each, the targets
+    // skewed towards low ids so that a few vertices get most in-edges, as on the web
+    const int pages = side * side;
+    const unsigned threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 0;
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<std::pair<int, int>> links(16 * static_cast<size_t>(pages));
+    for (size_t i = 0; i < links.size(); ++i)
+        links[i] = {static_cast<int>(i / 16), static_cast<int>(pages * std::pow(unit(gen), 3))};
+    const CSRGraph web = CSRGraph::fromEdges(pages, links, true);
+    std::optional<VertexProgramEngine> engine;
+    const double reverse = best([&] { engine.emplace(web, threads); }, 1);
+    std::printf("\n%-12s %10s %10s   (%d vertices, %zu edges, %u threads, reverse %.0f ms)\n", "program",
+                "ms/iter", "iters", pages, web.E(), engine->threads(), reverse * 1e3);
+    for (auto [name, mode] : {std::pair{"pr pull", PageRank::Mode::Pull}, std::pair{"pr push", PageRank::Mode::Push}}) {
+        int iterations = 0;
+        const double took = best([&] { iterations = PageRank(*engine, 0.85, 1e-9, 20, mode).iterations(); }, 1);
+        std::printf("%-12s %10.1f %10d\n", name, took * 1e3 / iterations, iterations);
+    }
+    int rounds = 0, communities = 0;
+    const double lp = best([&] {
+        const LabelPropagation labels(*engine, 10);
+        rounds = labels.iterations();
+        communities = labels.count();
+    }, 1);
+    std::printf("%-12s %10.1f %10d   (%d communities)\n", "label prop", lp * 1e3 / rounds, rounds, communities);
+
+    // the same links read as undirected edges: triangles and cores, as for clustering scores
+    const CSRGraph social = CSRGraph::fromEdges(pages, links, false);
+    std::printf("\n%-12s %10s %10s   (%zu edges)\n", "cohesion", "ms", "ns/edge", social.E());
+    uint64_t triangles = 0;
+    const double count = best([&] { triangles = countTriangles(social, threads); }, 1);
+    std::printf("%-12s %10.1f %10.1f   (%llu triangles)\n", "triangles", count * 1e3, count * 1e9 / social.E(),
+                static_cast<unsigned long long>(triangles));
+    const double perVertex = best([&] { triangles = TriangleCount(social, threads).total(); }, 1);
+    std::printf("%-12s %10.1f %10.1f\n", "per vertex", perVertex * 1e3, perVertex * 1e9 / social.E());
+    int top = 0;
+    for (unsigned t : {1u, std::max(2u, parallel::threads(threads))}) {
+        const double peel = best([&] { top = CoreDecomposition(social, t).maxCore(); }, 1);
+        std::printf("%-12s %10.1f %10.1f   (max core %d)\n", t == 1 ? "cores" : "cores par", peel * 1e3,
+                    peel * 1e9 / social.E(), top);
+    }
+
+    // max-flow on a segmentation-style instance: every pixel of a side x side image linked
+    // to its 8 neighbours, and to the source and the sink with random preferences
+    const int pixels = side * side;
+    std::uniform_int_distribution<int> smoothness(1, 10), preference(0, 40);
+    std::vector<FlowEdge> arcs;
+    arcs.reserve(10 * static_cast<size_t>(pixels));
+    const int source = pixels, target = pixels + 1;
+    for (int r = 0; r < side; ++r)
+        for (int c = 0; c < side; ++c) {
+            const int v = r * side + c;
+            for (auto [dr, dc] : {std::pair{0, 1}, {1, -1}, {1, 0}, {1, 1}}) {
+                if (r + dr >= side || c + dc < 0 || c + dc >= side) continue;
+                const int w = (r + dr) * side + c + dc, capacity = smoothness(gen);
+                arcs.emplace_back(v, w, capacity);
+                arcs.emplace_back(w, v, capacity);
+            }
+            arcs.emplace_back(source, v, preference(gen));
+            arcs.emplace_back(v, target, preference(gen));
+        }
+    const FlowNetwork image(pixels + 2, std::move(arcs));
+    int64_t value = 0;
+    const double flow = best([&] { value = MaxFlow(image, source, target).value(); }, 1);
+    std::printf("\n%-12s %10s   (%d vertices, %d edges)\n", "flow", "ms", image.V(), image.E());
+    std::printf("%-12s %10.1f   (value %lld)\n", "push-relabel", flow * 1e3, static_cast<long long>(value));
+
+    // a random bipartite graph with side^2 / 2 vertices a side and 8 edges a vertex
+    const int half = pixels / 2;
+    std::uniform_int_distribution<int> right(half, 2 * half - 1);
+    std::vector<std::pair<int, int>> pairs(8 * static_cast<size_t>(half));
+    for (size_t i = 0; i < pairs.size(); ++i) pairs[i] = {static_cast<int>(i / 8), right(gen)};
+    const Graph bipartite(2 * half, pairs);
+    int matched = 0;
+    const double hk = best([&] { matched = BipartiteMatching(bipartite).size(); }, 1);
+    std::printf("%-12s %10.1f   (%d edges, %d pairs)\n", "hopcroft-karp", hk * 1e3, bipartite.E(), matched);
+}
@@ -0,0 +1,431 @@
+#include "ch.h"
+#include <queue>
+#include <limits>
+#include <climits>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <algorithm>
+#include <stdexcept>
+
+namespace graph {
+    namespace {
+        using Arc = ContractionHierarchy::Arc;
+        constexpr double infinity = std::numeric_limits<double>::infinity();
+
+        // the remaining graph while vertices are contracted; in_[w] stores u -> w with to = u
+        class Contractor {
+        private:
+            std::vector<std::vector<Arc>> out_, in_;
+            std::vector<int> deleted_;      // contracted neighbours so far
+            data_structures::IndexMinPriorityQueue<double> pq_;
+            std::vector<uint32_t> seen_;
+            std::vector<double> distTo_;
+            std::vector<uint32_t> target_;
+            std::vector<double> need_;
+            uint32_t stamp_ = 0;
+            int limit_;
+
+        public:
+            struct Shortcut {
+                int from, to;
+                double weight;
+            };
+
+            Contractor(const EdgeWeightedDigraph& g, int limit)
+                : out_(g.V())
+                , in_(g.V())
+                , deleted_(g.V(), 0)
+                , pq_(g.V())
+                , seen_(g.V(), 0)
+                , distTo_(g.V())
+                , target_(g.V(), 0)
+                , need_(g.V())
+                , limit_(limit)
+            {
+                for (const auto& e : g.edges()) {
+                    if (e.weight() < 0)
+                        throw std::invalid_argument("Contraction hierarchies do not accept negative weights");
+                    if (e.from() != e.to()) addArc(e.from(), e.to(), e.weight(), -1);
+                }
+            }
+
+            // twice the edge difference plus the contracted neighbours, estimated with
+            // searches a tenth as long: the order only needs a rough count, and these
+            // searches run for every neighbour of every contracted vertex
+            [[nodiscard]]
+            int priority(int v) {
+                const int added = shortcuts(v, nullptr, std::max(1, limit_ / 10));
+                return 2 * (added - static_cast<int>(in_[v].size() + out_[v].size())) + deleted_[v];
+            }
+
+            // removes v; its remaining arcs are the ones that lead up from it
+            void contract(int v, std::vector<Arc>& up, std::vector<Arc>& down, std::vector<int>& neighbours) {
+                std::vector<Shortcut> added;
+                shortcuts(v, &added, limit_);
+                up = std::move(out_[v]);
+                down = std::move(in_[v]);
+                out_[v].clear();
+                in_[v].clear();
+                neighbours.clear();
+                auto drop = [v](std::vector<Arc>& arcs) {
+                    std::erase_if(arcs, [v](const Arc& a) { return a.to == v; });
+                };
+                for (const Arc& a : up) {
+                    drop(in_[a.to]);
+                    neighbours.push_back(a.to);
+                }
+                for (const Arc& a : down) {
+                    drop(out_[a.to]);
+                    neighbours.push_back(a.to);
+                }
+                for (const auto& s : added) addArc(s.from, s.to, s.weight, v);
+                std::sort(neighbours.begin(), neighbours.end());
+                neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+                for (int n : neighbours) ++deleted_[n];
+            }
+
+        private:
+            // parallel arcs collapse into the shortest one
+            void addArc(int u, int w, double weight, int middle) {
+                for (Arc& a : out_[u])
+                    if (a.to == w) {
+                        if (weight < a.weight) {
+                            a = {w, middle, weight};
+                            for (Arc& b : in_[w])
+                                if (b.to == u) b = {u, middle, weight};
+                        }
+                        return;
+                    }
+                out_[u].push_back({w, middle, weight});
+                in_[w].push_back({u, middle, weight});
+            }
+
+            // the shortcuts contracting v needs, appended to added if given; returns how many
+            int shortcuts(int v, std::vector<Shortcut>* added, int limit) {
+                int count = 0;
+                for (const Arc& a : in_[v]) {
+                    const int u = a.to;
+                    if (!witness(u, v, a.weight, limit)) continue;
+                    for (const Arc& b : out_[v]) {
+                        if (b.to == u || need_[b.to] < 0) continue;
+                        ++count;
+                        if (added) added->push_back({u, b.to, a.weight + b.weight});
+                    }
+                }
+                return count;
+            }
+
+            // Dijkstra from u that avoids v; stops once every w behind v has a path no
+            // longer than u -> v -> w, past the longest such, or after limit vertices.
+            // need_[w] < 0 marks a w that has its witness. False if there are no targets.
+            bool witness(int u, int v, double first, int limit) {
+                if (++stamp_ == 0) {
+                    std::fill(seen_.begin(), seen_.end(), 0);
+                    std::fill(target_.begin(), target_.end(), 0);
+                    stamp_ = 1;
+                }
+                int pending = 0;
+                double bound = -1;
+                for (const Arc& b : out_[v]) {
+                    if (b.to == u) continue;
+                    target_[b.to] = stamp_;
+                    need_[b.to] = first + b.weight;
+                    bound = std::max(bound, need_[b.to]);
+                    ++pending;
+                }
+                if (pending == 0) return false;
+                pq_.clear();
+                seen_[u] = stamp_;
+                distTo_[u] = 0;
+                pq_.insert(u, 0);
+                for (int settled = 0; !pq_.empty() && settled < limit; ++settled) {
+                    if (pq_.minKey() > bound) break;
+                    const int x = pq_.pop();
+                    for (const Arc& a : out_[x]) {
+                        const int w = a.to;
+                        const double d = distTo_[x] + a.weight;
+                        if (w == v || (seen_[w] == stamp_ && !(d < distTo_[w]))) continue;
+                        distTo_[w] = d;
+                        if (seen_[w] != stamp_) {
+                            seen_[w] = stamp_;
+                            pq_.insert(w, d);
+                        } else if (pq_.contains(w)) {
+                            pq_.decreaseKey(w, d);
+                        }
+                        if (target_[w] == stamp_ && need_[w] >= 0 && d <= need_[w]) {
+                            need_[w] = -1;
+                            if (--pending == 0) return true;
+                        }
+                    }
+                }
+                return true;
+            }
+        };
+
+        void flatten(std::vector<std::vector<Arc>>& lists, std::vector<size_t>& offsets, std::vector<Arc>& arcs) {
+            offsets.assign(lists.size() + 1, 0);
+            for (size_t v = 0; v < lists.size(); ++v)
+                offsets[v + 1] = offsets[v] + lists[v].size();
+            arcs.clear();
+            arcs.reserve(offsets.back());
+            for (auto& list : lists) {
+                std::sort(list.begin(), list.end(), [](const Arc& a, const Arc& b) { return a.to < b.to; });
+                arcs.insert(arcs.end(), list.begin(), list.end());
+                list = {};
+            }
+        }
+    }
+
+    // lazy updates: a vertex taken off the heap is re-evaluated and goes back if it is
+    // no longer the minimum; the neighbours of a contracted vertex are re-evaluated at once
+    ContractionHierarchy::ContractionHierarchy(const EdgeWeightedDigraph& g, int witnessLimit)
+        : V_(g.V())
+        , rank_(g.V(), -1)
+    {
+        if (witnessLimit <= 0) throw std::invalid_argument("Witness limit must be positive");
+        Contractor c(g, witnessLimit);
+        using Entry = std::pair<int, int>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<>> heap;
+        std::vector<int> priority(V_);
+        for (int v = 0; v < V_; ++v) {
+            priority[v] = c.priority(v);
+            heap.emplace(priority[v], v);
+        }
+        std::vector<std::vector<Arc>> up(V_), down(V_);
+        std::vector<int> neighbours;
+        int next = 0;
+        while (!heap.empty()) {
+            const auto [p, v] = heap.top();
+            heap.pop();
+            if (rank_[v] >= 0 || p != priority[v]) continue;
+            const int now = c.priority(v);
+            if (now > p && !heap.empty() && now > heap.top().first) {
+                priority[v] = now;
+                heap.emplace(now, v);
+                continue;
+            }
+            c.contract(v, up[v], down[v], neighbours);
+            rank_[v] = next++;
+            for (int n : neighbours) {
+                priority[n] = c.priority(n);
+                heap.emplace(priority[n], n);
+            }
+        }
+        flatten(up, upOffsets_, up_);
+        flatten(down, downOffsets_, down_);
+    }
+
+    int ContractionHierarchy::V() const noexcept {
+        return V_;
+    }
+
+    int ContractionHierarchy::rank(int v) const {
+        return rank_.at(v);
+    }
+
+    std::span<const ContractionHierarchy::Arc> ContractionHierarchy::up(int v) const {
+        if (v < 0 || v >= V_) throw std::out_of_range("Vertex is out of boundaries");
+        return {up_.data() + upOffsets_[v], up_.data() + upOffsets_[v + 1]};
+    }
+
+    std::span<const ContractionHierarchy::Arc> ContractionHierarchy::down(int v) const {
+        if (v < 0 || v >= V_) throw std::out_of_range("Vertex is out of boundaries");
+        return {down_.data() + downOffsets_[v], down_.data() + downOffsets_[v + 1]};
+    }
+
+    size_t ContractionHierarchy::shortcuts() const noexcept {
+        auto isShortcut = [](const Arc& a) { return a.middle >= 0; };
+        return std::count_if(up_.begin(), up_.end(), isShortcut) + std::count_if(down_.begin(), down_.end(), isShortcut);
+    }
+
+    // a shortcut u -> w via m was made from u -> m and m -> w, both still stored at m
+    void ContractionHierarchy::unpack(int u, const Arc& arc, std::vector<DirectedEdge>& path) const {
+        if (arc.middle < 0) {
+            path.emplace_back(u, arc.to, arc.weight);
+            return;
+        }
+        const int m = arc.middle;
+        auto in = down(m), out = up(m);
+        auto first = std::find_if(in.begin(), in.end(), [u](const Arc& a) { return a.to == u; });
+        auto second = std::find_if(out.begin(), out.end(), [&arc](const Arc& a) { return a.to == arc.to; });
+        if (first == in.end() || second == out.end()) throw std::logic_error("Shortcut halves are missing");
+        unpack(u, {m, first->middle, first->weight}, path);
+        unpack(m, *second, path);
+    }
+
+    namespace {
+        constexpr char magic[8] = {'A', 'L', 'G', 'O', 'C', 'H', '\0', '\0'};
+        constexpr uint32_t version = 1;
+
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t reserved;
+            uint64_t V;
+            uint64_t up;
+            uint64_t down;
+        };
+        static_assert(sizeof(Header) == 40);
+        static_assert(sizeof(Arc) == 16 && sizeof(size_t) == sizeof(uint64_t), "arrays are written as they are");
+
+        template<typename T>
+        void put(std::ostream& out, const std::vector<T>& v) {
+            out.write(reinterpret_cast<const char*>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(T)));
+        }
+
+        // a chunk at a time, so a corrupt count runs into the end of the stream before it
+        // allocates much more than the stream holds
+        template<typename T>
+        void get(std::istream& in, std::vector<T>& v, size_t n) {
+            constexpr size_t chunk = (size_t{1} << 20) / sizeof(T);
+            v.clear();
+            while (v.size() < n && in) {
+                const size_t at = v.size(), k = std::min(chunk, n - at);
+                v.resize(at + k);
+                in.read(reinterpret_cast<char*>(v.data() + at), static_cast<std::streamsize>(k * sizeof(T)));
+            }
+        }
+
+        void checkCSR(const std::vector<size_t>& offsets, const std::vector<Arc>& arcs, int V) {
+            if (offsets.front() != 0 || offsets.back() != arcs.size()
+                || !std::is_sorted(offsets.begin(), offsets.end()))
+                throw std::invalid_argument("Offsets do not cover the arc array");
+            for (const Arc& a : arcs)
+                if (a.to < 0 || a.to >= V || a.middle < -1 || a.middle >= V)
+                    throw std::invalid_argument("Arc out of range");
+        }
+    }
+
+    void ContractionHierarchy::save(std::ostream& out) const {
+        Header h{};
+        std::memcpy(h.magic, magic, sizeof magic);
+        h.version = version;
+        h.V = static_cast<uint64_t>(V_);
+        h.up = up_.size();
+        h.down = down_.size();
+        const char zeros[8] = {};
+        out.write(reinterpret_cast<const char*>(&h), sizeof h);
+        put(out, rank_);
+        out.write(zeros, static_cast<std::streamsize>(V_ % 2 * sizeof(int32_t)));
+        put(out, upOffsets_);
+        put(out, up_);
+        put(out, downOffsets_);
+        put(out, down_);
+        if (!out) throw std::runtime_error("Cannot write the hierarchy");
+    }
+
+    ContractionHierarchy ContractionHierarchy::load(std::istream& in) {
+        Header h{};
+        if (!in.read(reinterpret_cast<char*>(&h), sizeof h) || std::memcmp(h.magic, magic, sizeof magic) != 0)
+            throw std::invalid_argument("Not a contraction hierarchy");
+        if (h.version != version)
+            throw std::invalid_argument("Unsupported hierarchy version or byte order");
+        if (h.V > static_cast<uint64_t>(INT_MAX))
+            throw std::invalid_argument("Vertex count out of range");
+        ContractionHierarchy ch;
+        ch.V_ = static_cast<int>(h.V);
+        char pad[8];
+        get(in, ch.rank_, h.V);
+        in.read(pad, static_cast<std::streamsize>(h.V % 2 * sizeof(int32_t)));
+        get(in, ch.upOffsets_, h.V + 1);
+        get(in, ch.up_, h.up);
+        get(in, ch.downOffsets_, h.V + 1);
+        get(in, ch.down_, h.down);
+        if (!in) throw std::invalid_argument("Truncated contraction hierarchy");
+        checkCSR(ch.upOffsets_, ch.up_, ch.V_);
+        checkCSR(ch.downOffsets_, ch.down_, ch.V_);
+        return ch;
+    }
+
+    CHSearch::CHSearch(const ContractionHierarchy& ch)
+        : ch_(ch)
+        , pq_{data_structures::IndexMinPriorityQueue<double>(ch.V()),
+              data_structures::IndexMinPriorityQueue<double>(ch.V())}
+    {
+        for (int side = 0; side < 2; ++side) {
+            seen_[side].assign(ch.V(), 0);
+            distTo_[side].resize(ch.V());
+            parent_[side].resize(ch.V());
+            via_[side].resize(ch.V());
+        }
+    }
+
+    double CHSearch::distance(int s, int t) {
+        return search(s, t);
+    }
+
+    std::vector<DirectedEdge> CHSearch::path(int s, int t) {
+        if (search(s, t) == infinity) return {};
+        std::vector<int> upward;
+        for (int x = meet_; x != s; x = parent_[0][x])
+            upward.push_back(x);
+        std::vector<DirectedEdge> path;
+        for (auto x = upward.rbegin(); x != upward.rend(); ++x)
+            ch_.unpack(parent_[0][*x], via_[0][*x], path);
+        for (int x = meet_; x != t; x = parent_[1][x])
+            ch_.unpack(x, via_[1][x], path);
+        return path;
+    }
+
+    size_t CHSearch::settled() const noexcept {
+        return settled_;
+    }
+
+    double CHSearch::search(int s, int t) {
+        if (s < 0 || s >= ch_.V() || t < 0 || t >= ch_.V()) throw std::out_of_range("Vertex is out of boundaries");
+        if (++stamp_ == 0) {
+            for (auto& seen : seen_) std::fill(seen.begin(), seen.end(), 0);
+            stamp_ = 1;
+        }
+        settled_ = 0;
+        const int ends[2] = {s, t};
+        for (int side = 0; side < 2; ++side) {
+            pq_[side].clear();
+            seen_[side][ends[side]] = stamp_;
+            distTo_[side][ends[side]] = 0;
+            parent_[side][ends[side]] = ends[side];
+            pq_[side].insert(ends[side], 0);
+        }
+        meet_ = s;
+        if (s == t) return 0;
+
+        double mu = infinity;
+        for (;;) {
+            const bool open[2] = {!pq_[0].empty() && pq_[0].minKey() < mu, !pq_[1].empty() && pq_[1].minKey() < mu};
+            if (!open[0] && !open[1]) break;
+            const int side = !open[1] || (open[0] && pq_[0].minKey() <= pq_[1].minKey()) ? 0 : 1;
+            auto& seen = seen_[side];
+            auto& dist = distTo_[side];
+            const int v = pq_[side].pop();
+            ++settled_;
+            if (seen_[1 - side][v] == stamp_ && distTo_[0][v] + distTo_[1][v] < mu) {
+                mu = distTo_[0][v] + distTo_[1][v];
+                meet_ = v;
+            }
+            // stall-on-demand: arcs of the other direction at v come down from higher vertices
+            bool stalled = false;
+            for (const Arc& a : side == 0 ? ch_.down(v) : ch_.up(v))
+                if (seen[a.to] == stamp_ && dist[a.to] + a.weight < dist[v]) {
+                    stalled = true;
+                    break;
+                }
+            if (stalled) continue;
+            for (const Arc& a : side == 0 ? ch_.up(v) : ch_.down(v)) {
+                const int w = a.to;
+                const double d = dist[v] + a.weight;
+                if (seen[w] == stamp_ && !(d < dist[w])) continue;
+                dist[w] = d;
+                parent_[side][w] = v;
+                via_[side][w] = side == 0 ? a : Arc{v, a.middle, a.weight};
+                if (seen[w] != stamp_) {
+                    seen[w] = stamp_;
+                    pq_[side].insert(w, d);
+                } else if (pq_[side].contains(w)) {
+                    pq_[side].decreaseKey(w, d);
+                }
+            }
+        }
+        return mu;
+    }
+}
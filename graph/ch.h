@@ -0,0 +1,99 @@
+#ifndef ALGO_CH_H
+#define ALGO_CH_H
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <iosfwd>
+#include "graph.h"
+
+namespace graph {
+    /** Contraction hierarchies (Geisberger, Sanders, Schultes, Delling) *****************************
+     * Preprocessing contracts the vertices one by one, least important first: a vertex
+     * v is removed and, for every pair u -> v -> w of its remaining neighbours, a
+     * shortcut u -> w of the same length is added unless a local Dijkstra that avoids v
+     * (the witness search) finds a path that is no longer. Importance is twice the edge
+     * difference, shortcuts added minus arcs removed, plus the number of neighbours
+     * already contracted, which spreads contraction evenly; it is re-evaluated lazily as
+     * the graph shrinks. The contraction order is the rank of a vertex.
+     *
+     * The result is two CSR arrays of arcs that all lead upward in rank: up(v) holds
+     * v -> w, down(v) holds u -> v stored at v with `to` = u, so that both query
+     * directions only ever climb. A query runs Dijkstra upward from s and upward over
+     * down() from t; the two searches stay tiny on road-like graphs, which is where the
+     * hierarchy pays off. Dense random graphs need many shortcuts and gain little.
+     *
+     * save()/load() write the arrays as they are in memory (version 1, native byte
+     * order): a 40-byte header
+     *     char magic[8] = "ALGOCH", uint32 version, uint32 0, uint64 V, uint64 up, uint64 down
+     * then V int32 ranks padded to 8 bytes, V+1 uint64 up offsets, `up` arcs, V+1 uint64
+     * down offsets, `down` arcs; an arc is 16 bytes: int32 to, int32 middle, double weight.
+     */
+    class ContractionHierarchy {
+    public:
+        struct Arc {
+            int to;
+            int middle;     // the contracted vertex a shortcut bypasses, -1 for a graph edge
+            double weight;
+        };
+
+    private:
+        int V_ = 0;
+        std::vector<int> rank_;
+        std::vector<size_t> upOffsets_, downOffsets_;
+        std::vector<Arc> up_, down_;
+
+        ContractionHierarchy() = default;
+    public:
+        // non-negative weights only; a witness search gives up after settling
+        // witnessLimit vertices and keeps the shortcut, which is always safe
+        explicit ContractionHierarchy(const EdgeWeightedDigraph& g, int witnessLimit = 500);
+        [[nodiscard]]
+        int V() const noexcept;
+        [[nodiscard]]
+        int rank(int v) const;
+        [[nodiscard]]
+        std::span<const Arc> up(int v) const;
+        [[nodiscard]]
+        std::span<const Arc> down(int v) const;
+        [[nodiscard]]
+        size_t shortcuts() const noexcept;
+        // the graph edges a shortcut u -> w stands for, in order, appended to path
+        void unpack(int u, const Arc& arc, std::vector<DirectedEdge>& path) const;
+
+        void save(std::ostream& out) const;
+        static ContractionHierarchy load(std::istream& in);
+    };
+
+    // Bidirectional upward search with stall-on-demand: a vertex that can be reached
+    // more cheaply through a higher neighbour is not expanded. Each side stops once
+    // its queue minimum reaches the best meeting length. Query object like the ones in
+    // p2p.h: stamped scratch, one per thread.
+    class CHSearch {
+    private:
+        const ContractionHierarchy& ch_;
+        data_structures::IndexMinPriorityQueue<double> pq_[2];
+        std::vector<uint32_t> seen_[2];
+        std::vector<double> distTo_[2];
+        std::vector<int> parent_[2];
+        std::vector<ContractionHierarchy::Arc> via_[2];  // the arc parent -> v, or v -> parent going down
+        uint32_t stamp_ = 0;
+        int meet_ = -1;
+        size_t settled_ = 0;
+
+    public:
+        explicit CHSearch(const ContractionHierarchy& ch);
+        // +infinity if t is unreachable
+        [[nodiscard]]
+        double distance(int s, int t);
+        // the graph edges s -> t, shortcuts unpacked; empty for s == t or no path
+        [[nodiscard]]
+        std::vector<DirectedEdge> path(int s, int t);
+        [[nodiscard]]
+        size_t settled() const noexcept;
+
+    private:
+        double search(int s, int t);
+    };
+}
+
+#endif //ALGO_CH_H
@@ -0,0 +1,383 @@
+#include "cohesion.h"
+#include <bit>
+#include <span>
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include "parallel.h"
+#if !defined(ALGO_NO_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define ALGO_COHESION_SSE2 1
+#endif
+
+namespace graph {
+    namespace {
+        // one per thread, a cache line each
+        struct alignas(64) Tally {
+            uint64_t value = 0;
+        };
+
+        template<typename T>
+        void atomicAdd(T& target, T x) noexcept {
+            std::atomic_ref<T>(target).fetch_add(x, std::memory_order_relaxed);
+        }
+
+        void requireUndirected(const CSRGraph& g) {
+            if (g.directed()) throw std::invalid_argument("Graph must be undirected");
+        }
+
+        /** Every edge kept once, at the end first in (degree, id) order, with the vertices
+         * renumbered in that order: vertex order[r] becomes r and keeps only neighbours above
+         * r. The hubs, whose lists most triangles go through, end up next to each other.
+         * The kept lists are sorted and free of duplicates.
+         */
+        struct Oriented {
+            std::vector<int> order;
+            std::vector<size_t> offsets;
+            std::vector<int> targets;
+
+            Oriented(const CSRGraph& g, unsigned threads)
+                    : order(g.V())
+                    , offsets(static_cast<size_t>(g.V()) + 1, 0)
+            {
+                requireUndirected(g);
+                const int V = g.V();
+                // counting sort by degree, stable so that ties stay in id order
+                std::vector<int> rank(V);
+                std::vector<size_t> bucket;
+                for (int v = 0; v < V; ++v) {
+                    const auto d = static_cast<size_t>(g.degree(v));
+                    if (d + 1 >= bucket.size()) bucket.resize(d + 2, 0);
+                    ++bucket[d + 1];
+                }
+                for (size_t d = 1; d < bucket.size(); ++d) bucket[d] += bucket[d - 1];
+                for (int v = 0; v < V; ++v) {
+                    rank[v] = static_cast<int>(bucket[g.degree(v)]++);
+                    order[rank[v]] = v;
+                }
+
+                std::vector<int> size(V);
+                parallel::forRange(V, [&](size_t begin, size_t end, unsigned) {
+                    for (size_t r = begin; r < end; ++r)
+                        for (int w : g.adj(order[r]))
+                            if (static_cast<size_t>(rank[w]) > r) ++offsets[r + 1];
+                }, 1024, threads);
+                for (int r = 0; r < V; ++r) offsets[r + 1] += offsets[r];
+                targets.resize(offsets[V]);
+                parallel::forRange(V, [&](size_t begin, size_t end, unsigned) {
+                    for (size_t r = begin; r < end; ++r) {
+                        int* const first = targets.data() + offsets[r];
+                        int* last = first;
+                        for (int w : g.adj(order[r]))
+                            if (static_cast<size_t>(rank[w]) > r) *last++ = rank[w];
+                        std::sort(first, last);
+                        size[r] = static_cast<int>(std::unique(first, last) - first);
+                    }
+                }, 1024, threads);
+                // drop the duplicates' slots: every list moves left, so in order is safe
+                size_t kept = 0;
+                for (int r = 0; r < V; ++r) {
+                    const size_t from = offsets[r];
+                    offsets[r] = kept;
+                    std::copy_n(targets.begin() + static_cast<ptrdiff_t>(from), size[r],
+                                targets.begin() + static_cast<ptrdiff_t>(kept));
+                    kept += size[r];
+                }
+                offsets[V] = kept;
+                targets.resize(kept);
+            }
+
+            [[nodiscard]]
+            int V() const noexcept {
+                return static_cast<int>(order.size());
+            }
+
+            [[nodiscard]]
+            std::span<const int> list(int r) const noexcept {
+                return {targets.data() + offsets[r], offsets[r + 1] - offsets[r]};
+            }
+
+            // list(a[k]), with the reads for the next two started early so that they overlap
+            // this intersection: the ids of the next list, the offsets of the one after
+            [[nodiscard]]
+            std::span<const int> list(std::span<const int> a, size_t k) const noexcept {
+#if defined(__GNUC__)
+                if (k + 2 < a.size()) __builtin_prefetch(&offsets[a[k + 2]]);
+                if (k + 1 < a.size()) __builtin_prefetch(targets.data() + offsets[a[k + 1]]);
+#endif
+                return list(a[k]);
+            }
+        };
+
+        /** Size of the intersection of the sorted, duplicate-free a[0, na) and b[0, nb),
+         * calling match(x) for every common x when Report. Lists of similar length are
+         * merged, blocks of four compared all-against-all with three rotations and the block
+         * with the smaller last id moving on: each pair of blocks that can share an id meets
+         * once.
+         */
+        template<bool Report, typename F>
+        uint64_t intersect(const int* a, size_t na, const int* b, size_t nb, F&& match) {
+            uint64_t n = 0;
+            size_t i = 0, j = 0;
+            // a short list against a hub's: binary search for each id instead of a scan
+            if (na > nb) std::swap(a, b), std::swap(na, nb);
+            if (na * 32 < nb) {
+                const int* from = b;
+                for (; i < na; ++i) {
+                    from = std::lower_bound(from, b + nb, a[i]);
+                    if (from == b + nb) break;
+                    if (*from == a[i]) {
+                        if constexpr (Report) match(a[i]);
+                        ++n;
+                    }
+                }
+                return n;
+            }
+#ifdef ALGO_COHESION_SSE2
+            while (i + 4 <= na && j + 4 <= nb) {
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+                const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+                __m128i m = _mm_cmpeq_epi32(x, y);
+                m = _mm_or_si128(m, _mm_cmpeq_epi32(x, _mm_shuffle_epi32(y, _MM_SHUFFLE(0, 3, 2, 1))));
+                m = _mm_or_si128(m, _mm_cmpeq_epi32(x, _mm_shuffle_epi32(y, _MM_SHUFFLE(1, 0, 3, 2))));
+                m = _mm_or_si128(m, _mm_cmpeq_epi32(x, _mm_shuffle_epi32(y, _MM_SHUFFLE(2, 1, 0, 3))));
+                auto bits = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(m)));
+                n += std::popcount(bits);
+                if constexpr (Report)
+                    for (; bits; bits &= bits - 1) match(a[i + std::countr_zero(bits)]);
+                const int lastA = a[i + 3], lastB = b[j + 3];
+                i += static_cast<size_t>(lastA <= lastB) * 4;
+                j += static_cast<size_t>(lastB <= lastA) * 4;
+            }
+#endif
+            while (i < na && j < nb) {
+                const int x = a[i], y = b[j];
+                if constexpr (Report)
+                    if (x == y) match(x);
+                n += x == y;
+                i += x <= y;
+                j += y <= x;
+            }
+            return n;
+        }
+    }
+
+    uint64_t countTriangles(const CSRGraph& g, unsigned threads) {
+        threads = parallel::threads(threads);
+        const Oriented o(g, threads);
+        std::vector<Tally> sums(threads);
+        parallel::forEdgeBalanced(o.offsets, [&](size_t begin, size_t end, unsigned tid) {
+            uint64_t found = 0;
+            for (size_t v = begin; v < end; ++v) {
+                const auto a = o.list(static_cast<int>(v));
+                for (size_t k = 0; k < a.size(); ++k) {
+                    const auto b = o.list(a, k);
+                    found += intersect<false>(a.data(), a.size(), b.data(), b.size(), [](int) {});
+                }
+            }
+            sums[tid].value += found;
+        }, 4096, threads);
+        uint64_t total = 0;
+        for (const auto& s : sums) total += s.value;
+        return total;
+    }
+
+    uint64_t countTriangles(const Graph& g, unsigned threads) {
+        return countTriangles(CSRGraph(g), threads);
+    }
+
+    TriangleCount::TriangleCount(const CSRGraph& g, unsigned threads)
+            : count_(g.V(), 0)
+            , degree_(g.V(), 0)
+    {
+        threads = parallel::threads(threads);
+        const Oriented o(g, threads);
+        // counted under the new numbering, then handed back to the original ids
+        std::vector<uint64_t> count(o.V(), 0);
+        std::vector<int> degree(o.V(), 0);
+        std::vector<Tally> sums(threads);
+        // v, u and w: the lowest, middle and highest corner
+        parallel::forEdgeBalanced(o.offsets, [&](size_t begin, size_t end, unsigned tid) {
+            for (size_t v = begin; v < end; ++v) {
+                const auto a = o.list(static_cast<int>(v));
+                uint64_t atV = 0;
+                for (size_t k = 0; k < a.size(); ++k) {
+                    const int u = a[k];
+                    const auto b = o.list(a, k);
+                    atomicAdd(degree[u], 1);
+                    const uint64_t atU = intersect<true>(a.data(), a.size(), b.data(), b.size(),
+                                                         [&count](int w) { atomicAdd(count[w], uint64_t{1}); });
+                    if (atU) atomicAdd(count[u], atU);
+                    atV += atU;
+                }
+                atomicAdd(degree[v], static_cast<int>(a.size()));
+                if (atV) atomicAdd(count[v], atV);
+                sums[tid].value += atV;
+            }
+        }, 4096, threads);
+        for (const auto& s : sums) total_ += s.value;
+        for (int r = 0; r < o.V(); ++r) {
+            count_[o.order[r]] = count[r];
+            degree_[o.order[r]] = degree[r];
+        }
+    }
+
+    TriangleCount::TriangleCount(const Graph& g, unsigned threads)
+            : TriangleCount(CSRGraph(g), threads)
+    {}
+
+    uint64_t TriangleCount::total() const noexcept {
+        return total_;
+    }
+
+    uint64_t TriangleCount::count(int v) const {
+        return count_.at(v);
+    }
+
+    const std::vector<uint64_t>& TriangleCount::counts() const noexcept {
+        return count_;
+    }
+
+    double TriangleCount::clustering(int v) const {
+        const double d = degree_.at(v);
+        return d < 2 ? 0.0 : 2.0 * static_cast<double>(count_[v]) / (d * (d - 1));
+    }
+
+    double TriangleCount::averageClustering() const {
+        if (count_.empty()) return 0;
+        double sum = 0;
+        for (int v = 0; v < static_cast<int>(count_.size()); ++v) sum += clustering(v);
+        return sum / static_cast<double>(count_.size());
+    }
+
+    double TriangleCount::transitivity() const {
+        double triples = 0;
+        for (double d : degree_) triples += d * (d - 1) / 2;
+        return triples == 0 ? 0.0 : 3.0 * static_cast<double>(total_) / triples;
+    }
+
+    CoreDecomposition::CoreDecomposition(const CSRGraph& g, unsigned threads)
+            : core_(g.V(), 0)
+    {
+        requireUndirected(g);
+        threads = parallel::threads(threads);
+        if (threads == 1) peel(g);
+        else peel(g, threads);
+        for (int c : core_) maxCore_ = std::max(maxCore_, c);
+    }
+
+    CoreDecomposition::CoreDecomposition(const Graph& g, unsigned threads)
+            : CoreDecomposition(CSRGraph(g), threads)
+    {}
+
+    // core_ holds the remaining degree, and the core number once the vertex is removed;
+    // vert is sorted by remaining degree, bin[d] being where degree d starts
+    void CoreDecomposition::peel(const CSRGraph& g) {
+        const int V = g.V();
+        int top = 0;
+        for (int v = 0; v < V; ++v) {
+            for (int w : g.adj(v)) core_[v] += w != v;
+            top = std::max(top, core_[v]);
+        }
+        std::vector<int> bin(top + 2, 0), vert(V), pos(V);
+        for (int v = 0; v < V; ++v) ++bin[core_[v] + 1];
+        for (int d = 0; d <= top; ++d) bin[d + 1] += bin[d];
+        for (int v = 0; v < V; ++v) {
+            pos[v] = bin[core_[v]]++;
+            vert[pos[v]] = v;
+        }
+        for (int d = top; d > 0; --d) bin[d] = bin[d - 1];
+        bin[0] = 0;
+
+        for (int i = 0; i < V; ++i) {
+            const int v = vert[i];
+            for (int w : g.adj(v)) {
+                if (core_[w] <= core_[v]) continue;
+                // w moves to the front of its bucket, which then starts one later
+                const int dw = core_[w], front = bin[dw], u = vert[front];
+                if (u != w) {
+                    std::swap(vert[front], vert[pos[w]]);
+                    pos[u] = pos[w];
+                    pos[w] = front;
+                }
+                ++bin[dw];
+                --core_[w];
+            }
+        }
+    }
+
+    // degree holds the remaining degree; a vertex is removed at level k, and given core
+    // number k, by the one thread whose decrement takes its degree from k + 1 to k, or at the
+    // start of the level if it is already at most k
+    void CoreDecomposition::peel(const CSRGraph& g, unsigned threads) {
+        const int V = g.V();
+        std::vector<int> degree(V, 0), alive(V), survivors(V), frontier;
+        std::vector<std::vector<int>> next(threads);
+        const auto gather = [&] {
+            frontier.clear();
+            for (auto& part : next) {
+                frontier.insert(frontier.end(), part.begin(), part.end());
+                part.clear();
+            }
+        };
+        parallel::forRange(V, [&](size_t begin, size_t end, unsigned) {
+            for (size_t v = begin; v < end; ++v) {
+                alive[v] = static_cast<int>(v);
+                for (int w : g.adj(static_cast<int>(v))) degree[v] += w != static_cast<int>(v);
+            }
+        }, 4096, threads);
+
+        for (size_t remaining = V; remaining;) {
+            std::vector<int> least(threads, std::numeric_limits<int>::max());
+            parallel::forRange(remaining, [&](size_t begin, size_t end, unsigned tid) {
+                for (size_t i = begin; i < end; ++i) least[tid] = std::min(least[tid], degree[alive[i]]);
+            }, 4096, threads);
+            const int k = *std::min_element(least.begin(), least.end());
+            parallel::forRange(remaining, [&](size_t begin, size_t end, unsigned tid) {
+                for (size_t i = begin; i < end; ++i)
+                    if (degree[alive[i]] <= k) next[tid].push_back(alive[i]);
+            }, 4096, threads);
+            gather();
+
+            while (!frontier.empty()) {
+                parallel::forRange(frontier.size(), [&](size_t begin, size_t end, unsigned tid) {
+                    for (size_t i = begin; i < end; ++i) {
+                        const int v = frontier[i];
+                        core_[v] = k;
+                        for (int w : g.adj(v)) {
+                            if (w == v) continue;
+                            std::atomic_ref<int> d(degree[w]);
+                            if (d.load(std::memory_order_relaxed) > k
+                                && d.fetch_sub(1, std::memory_order_relaxed) == k + 1)
+                                next[tid].push_back(w);
+                        }
+                    }
+                }, 64, threads);
+                gather();
+            }
+            remaining = parallel::partition(alive.data(), remaining, survivors.data(),
+                                            [&degree, k](int v) { return degree[v] > k; }, threads);
+            alive.swap(survivors);
+        }
+    }
+
+    int CoreDecomposition::core(int v) const {
+        return core_.at(v);
+    }
+
+    const std::vector<int>& CoreDecomposition::cores() const noexcept {
+        return core_;
+    }
+
+    int CoreDecomposition::maxCore() const noexcept {
+        return maxCore_;
+    }
+
+    std::vector<int> CoreDecomposition::kCore(int k) const {
+        std::vector<int> members;
+        for (int v = 0; v < static_cast<int>(core_.size()); ++v)
+            if (core_[v] >= k) members.push_back(v);
+        return members;
+    }
+}
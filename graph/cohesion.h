@@ -0,0 +1,84 @@
+#ifndef ALGO_COHESION_H
+#define ALGO_COHESION_H
+#include <vector>
+#include <cstdint>
+#include "csr.h"
+
+namespace graph {
+    /** Triangle counting by degree ordering and sorted-set intersection ************************
+     * Every edge is kept only at the end that comes first in (degree, id) order, so a
+     * triangle is seen once, from its lowest vertex v through its middle vertex u, as the
+     * common part of the kept lists of v and u. No kept list is longer than sqrt(2E), which
+     * bounds the work by O(E^1.5) even around hubs. Vertices are renumbered in that order,
+     * which puts the hubs' lists, read by most intersections, next to each other; the lists
+     * are sorted and compared four ids at a time with SSE2, the next one prefetched.
+     * countTriangles() only counts; TriangleCount also credits every triangle to its three
+     * corners, which costs two atomic adds per triangle. Self-loops and parallel edges are
+     * ignored. Undirected graphs only.
+     */
+    [[nodiscard]]
+    uint64_t countTriangles(const CSRGraph& g, unsigned threads = 0);
+    [[nodiscard]]
+    uint64_t countTriangles(const Graph& g, unsigned threads = 0);
+
+    class TriangleCount {
+    private:
+        std::vector<uint64_t> count_;
+        std::vector<int> degree_;
+        uint64_t total_ = 0;
+
+    public:
+        explicit TriangleCount(const CSRGraph& g, unsigned threads = 0);
+        explicit TriangleCount(const Graph& g, unsigned threads = 0);
+        [[nodiscard]]
+        uint64_t total() const noexcept;
+        // triangles v is a corner of
+        [[nodiscard]]
+        uint64_t count(int v) const;
+        [[nodiscard]]
+        const std::vector<uint64_t>& counts() const noexcept;
+        // the share of pairs of v's neighbours that are adjacent; 0 below degree 2
+        [[nodiscard]]
+        double clustering(int v) const;
+        [[nodiscard]]
+        double averageClustering() const;
+        // 3 * triangles / connected triples, over the whole graph
+        [[nodiscard]]
+        double transitivity() const;
+    };
+
+    /** k-core decomposition *****************************************************************
+     * The core number of v is the largest k such that v belongs to a subgraph in which
+     * every vertex has degree at least k. With one thread: Batagelj and Zaversnik's bucket
+     * peeling, which removes the vertex of least remaining degree one at a time from
+     * degree-sorted buckets, O(V + E). With more: level by level, every vertex whose degree
+     * has dropped to k is removed at once and its neighbours' degrees decremented
+     * atomically; the survivors are compacted after each level, so a level only scans
+     * what is left. Both give the same core numbers.
+     * Self-loops are ignored, a parallel edge counts once per copy. Undirected graphs only.
+     */
+    class CoreDecomposition {
+    private:
+        std::vector<int> core_;
+        int maxCore_ = 0;
+
+    public:
+        explicit CoreDecomposition(const CSRGraph& g, unsigned threads = 0);
+        explicit CoreDecomposition(const Graph& g, unsigned threads = 0);
+        [[nodiscard]]
+        int core(int v) const;
+        [[nodiscard]]
+        const std::vector<int>& cores() const noexcept;
+        [[nodiscard]]
+        int maxCore() const noexcept;
+        // the vertices of the k-core, ascending
+        [[nodiscard]]
+        std::vector<int> kCore(int k) const;
+
+    private:
+        void peel(const CSRGraph& g);
+        void peel(const CSRGraph& g, unsigned threads);
+    };
+}
+
+#endif //ALGO_COHESION_H
@@ -0,0 +1,15 @@
+#include "components.h"
+
+namespace graph {
+    bool ParallelCC::connected(int v, int w) const {
+        return id_.at(v) == id_.at(w);
+    }
+
+    int ParallelCC::id(int v) const {
+        return id_.at(v);
+    }
+
+    int ParallelCC::count() const {
+        return count_;
+    }
+}
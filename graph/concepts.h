@@ -0,0 +1,24 @@
+#ifndef ALGO_GRAPH_CONCEPTS_H
+#define ALGO_GRAPH_CONCEPTS_H
+#include <ranges>
+#include <concepts>
+#include <utility>
+
+namespace graph {
+    /** Graph concepts ********************************************************
+     * The traversals only need V() and adj(v) yielding neighbour ids, so they run
+     * unchanged over Graph, Digraph and the frozen CSRGraph (csr.h).
+     */
+    template<typename G>
+    concept AdjacencyGraph = requires(const G& g, int v) {
+        { g.V() } -> std::convertible_to<int>;
+        { g.adj(v) } -> std::ranges::random_access_range;
+    } && std::convertible_to<std::ranges::range_value_t<decltype(std::declval<const G&>().adj(0))>, int>;
+
+    template<typename G>
+    concept DirectedAdjacencyGraph = AdjacencyGraph<G> && requires(const G& g) {
+        { g.reverse() } -> AdjacencyGraph;
+    };
+}
+
+#endif //ALGO_GRAPH_CONCEPTS_H
@@ -0,0 +1,188 @@
+#include "csr.h"
+#include <stdexcept>
+
+namespace graph {
+    namespace {
+        template<typename Adj, typename Emit>
+        void copyAdjacency(int V, Adj adj, std::vector<size_t>& offsets, Emit emit) {
+            offsets.assign(V + 1, 0);
+            for (int v = 0; v < V; ++v)
+                offsets[v + 1] = offsets[v] + adj(v).size();
+            for (int v = 0; v < V; ++v)
+                for (const auto& x : adj(v))
+                    emit(v, x);
+        }
+
+        template<typename Edges, typename Ends, typename Store>
+        std::vector<size_t> scatter(int V, const Edges& edges, bool directed, Ends ends, Store store) {
+            std::vector<size_t> offsets(V + 1, 0);
+            for (const auto& e : edges) {
+                auto [v, w] = ends(e);
+                if (v < 0 || v >= V || w < 0 || w >= V)
+                    throw std::out_of_range("Edge endpoint is out of boundaries");
+                ++offsets[v + 1];
+                if (!directed) ++offsets[w + 1];
+            }
+            for (int v = 0; v < V; ++v)
+                offsets[v + 1] += offsets[v];
+            std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+            for (const auto& e : edges) {
+                auto [v, w] = ends(e);
+                store(next[v]++, e, w);
+                if (!directed) store(next[w]++, e, v);
+            }
+            return offsets;
+        }
+    }
+
+    CSRGraph::CSRGraph(std::vector<size_t> offsets, std::vector<int> targets,
+                       std::vector<double> weights, bool directed)
+        : V_(offsets.empty() ? 0 : static_cast<int>(offsets.size() - 1))
+        , directed_(directed)
+        , offsets_(std::move(offsets))
+        , targets_(std::move(targets))
+        , weights_(std::move(weights))
+    {
+        if (offsets_.empty()) offsets_.push_back(0);
+        if (offsets_.front() != 0 || offsets_.back() != targets_.size())
+            throw std::invalid_argument("Offsets do not cover the target array");
+        if (!weights_.empty() && weights_.size() != targets_.size())
+            throw std::invalid_argument("Weights and targets differ in length");
+    }
+
+    CSRGraph::CSRGraph(const Graph &g)
+        : V_(g.V())
+        , directed_(false)
+    {
+        targets_.reserve(2 * static_cast<size_t>(g.E()));
+        copyAdjacency(V_, [&g](int v) -> const auto& { return g.adj(v); }, offsets_,
+                      [this](int, int w) { targets_.push_back(w); });
+    }
+
+    CSRGraph::CSRGraph(const Digraph &g)
+        : V_(g.V())
+        , directed_(true)
+    {
+        targets_.reserve(g.E());
+        copyAdjacency(V_, [&g](int v) -> const auto& { return g.adj(v); }, offsets_,
+                      [this](int, int w) { targets_.push_back(w); });
+    }
+
+    CSRGraph::CSRGraph(const EdgeWeightedGraph &g)
+        : V_(g.V())
+        , directed_(false)
+    {
+        targets_.reserve(2 * static_cast<size_t>(g.E()));
+        weights_.reserve(2 * static_cast<size_t>(g.E()));
+        copyAdjacency(V_, [&g](int v) -> const auto& { return g.adj(v); }, offsets_,
+                      [this](int v, const Edge& e) {
+                          targets_.push_back(e.other(v));
+                          weights_.push_back(e.weight());
+                      });
+    }
+
+    CSRGraph::CSRGraph(const EdgeWeightedDigraph &g)
+        : V_(g.V())
+        , directed_(true)
+    {
+        targets_.reserve(g.E());
+        weights_.reserve(g.E());
+        copyAdjacency(V_, [&g](int v) { return g.adj(v); }, offsets_,
+                      [this](int, const DirectedEdge& e) {
+                          targets_.push_back(e.to());
+                          weights_.push_back(e.weight());
+                      });
+    }
+
+    CSRGraph CSRGraph::fromEdges(int V, std::span<const std::pair<int, int>> edges, bool directed) {
+        std::vector<int> targets(directed ? edges.size() : 2 * edges.size());
+        auto offsets = scatter(V, edges, directed,
+                               [](const std::pair<int, int>& e) { return e; },
+                               [&targets](size_t at, const std::pair<int, int>&, int w) { targets[at] = w; });
+        return {std::move(offsets), std::move(targets), {}, directed};
+    }
+
+    CSRGraph CSRGraph::fromEdges(int V, std::span<const DirectedEdge> edges, bool directed) {
+        const size_t n = directed ? edges.size() : 2 * edges.size();
+        std::vector<int> targets(n);
+        std::vector<double> weights(n);
+        auto offsets = scatter(V, edges, directed,
+                               [](const DirectedEdge& e) { return std::pair{e.from(), e.to()}; },
+                               [&](size_t at, const DirectedEdge& e, int w) {
+                                   targets[at] = w;
+                                   weights[at] = e.weight();
+                               });
+        return {std::move(offsets), std::move(targets), std::move(weights), directed};
+    }
+
+    int CSRGraph::V() const noexcept {
+        return V_;
+    }
+
+    size_t CSRGraph::E() const noexcept {
+        return directed_ ? targets_.size() : targets_.size() / 2;
+    }
+
+    bool CSRGraph::directed() const noexcept {
+        return directed_;
+    }
+
+    bool CSRGraph::weighted() const noexcept {
+        return !weights_.empty();
+    }
+
+    std::span<const int> CSRGraph::adj(int v) const {
+        return {targets_.data() + offsets_[v], targets_.data() + offsets_[v + 1]};
+    }
+
+    std::span<const double> CSRGraph::weights(int v) const {
+        if (weights_.empty()) return {};
+        return {weights_.data() + offsets_[v], weights_.data() + offsets_[v + 1]};
+    }
+
+    int CSRGraph::degree(int v) const {
+        return static_cast<int>(offsets_[v + 1] - offsets_[v]);
+    }
+
+    CSRGraph CSRGraph::reverse() const {
+        if (!directed_) return *this;
+        std::vector<size_t> offsets(V_ + 1, 0);
+        for (int w : targets_)
+            ++offsets[w + 1];
+        for (int v = 0; v < V_; ++v)
+            offsets[v + 1] += offsets[v];
+        std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+        std::vector<int> targets(targets_.size());
+        std::vector<double> weights(weights_.size());
+        for (int v = 0; v < V_; ++v)
+            for (size_t i = offsets_[v]; i < offsets_[v + 1]; ++i) {
+                const size_t at = next[targets_[i]]++;
+                targets[at] = v;
+                if (!weights_.empty()) weights[at] = weights_[i];
+            }
+        return {std::move(offsets), std::move(targets), std::move(weights), true};
+    }
+
+    const std::vector<size_t> &CSRGraph::offsets() const noexcept {
+        return offsets_;
+    }
+
+    const std::vector<int> &CSRGraph::targets() const noexcept {
+        return targets_;
+    }
+
+    const std::vector<double> &CSRGraph::weights() const noexcept {
+        return weights_;
+    }
+
+    std::ostream &operator<<(std::ostream &os, const CSRGraph &g) {
+        os << g.V() << " verticies, " << g.E() << " edges\n";
+        for (int v = 0; v < g.V(); ++v) {
+            os << v << ": ";
+            for (int w : g.adj(v))
+                os << w << ' ';
+            os << '\n';
+        }
+        return os;
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef ALGO_CSR_H
+#define ALGO_CSR_H
+#include <vector>
+#include <span>
+#include <utility>
+#include "graph.h"
+
+namespace graph {
+    /** Compressed sparse row graph ********************************************************
+     * Frozen adjacency: the neighbours of v are targets[offsets[v] .. offsets[v+1]), with
+     * an optional parallel weights array. Three flat arrays instead of one heap block per
+     * vertex, so adj() is a pointer bump and a scan is a sequential read. Offsets are
+     * 64-bit, vertex ids stay int like everywhere else in graph::.
+     * An undirected graph stores every edge in both directions, as Graph does.
+     */
+    class CSRGraph {
+    private:
+        int V_;
+        bool directed_;
+        std::vector<size_t> offsets_;
+        std::vector<int> targets_;
+        std::vector<double> weights_;
+
+    public:
+        CSRGraph(std::vector<size_t> offsets, std::vector<int> targets,
+                 std::vector<double> weights, bool directed);
+        explicit CSRGraph(const Graph& g);
+        explicit CSRGraph(const Digraph& g);
+        explicit CSRGraph(const EdgeWeightedGraph& g);
+        explicit CSRGraph(const EdgeWeightedDigraph& g);
+
+        // two passes over the list: count degrees, then scatter into place
+        static CSRGraph fromEdges(int V, std::span<const std::pair<int, int>> edges, bool directed);
+        static CSRGraph fromEdges(int V, std::span<const DirectedEdge> edges, bool directed);
+
+        [[nodiscard]]
+        int V() const noexcept;
+        // logical edges: an undirected edge is counted once
+        [[nodiscard]]
+        size_t E() const noexcept;
+        [[nodiscard]]
+        bool directed() const noexcept;
+        [[nodiscard]]
+        bool weighted() const noexcept;
+        [[nodiscard]]
+        std::span<const int> adj(int v) const;
+        [[nodiscard]]
+        std::span<const double> weights(int v) const;
+        [[nodiscard]]
+        int degree(int v) const;
+        [[nodiscard]]
+        CSRGraph reverse() const;
+
+        [[nodiscard]]
+        const std::vector<size_t>& offsets() const noexcept;
+        [[nodiscard]]
+        const std::vector<int>& targets() const noexcept;
+        [[nodiscard]]
+        const std::vector<double>& weights() const noexcept;
+
+        friend std::ostream& operator<<(std::ostream& os, const CSRGraph& g);
+    };
+}
+
+#endif //ALGO_CSR_H
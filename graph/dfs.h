@@ -0,0 +1,80 @@
+#ifndef ALGO_DFS_H
+#define ALGO_DFS_H
+#include <vector>
+#include "concepts.h"
+
+namespace graph {
+    /** Hooks of DepthFirstEngine; a visitor derives from this and hides the ones it needs.
+     * nonTreeEdge(v, w) reports an edge to an already marked w (back, forward or cross);
+     * finishTreeEdge(v, w) fires back in v once the subtree under the tree edge v-w is done.
+     * stop() is polled after every hook and aborts the whole search once it turns true.
+     */
+    struct DfsVisitor {
+        void preorder(int) {}
+        void treeEdge(int, int) {}
+        void nonTreeEdge(int, int) {}
+        void postorder(int) {}
+        void finishTreeEdge(int, int) {}
+        [[nodiscard]]
+        bool stop() const { return false; }
+    };
+
+    /** Iterative depth-first search ********************************************************
+     * Same visiting order as the textbook recursion, but the recursion lives in an explicit
+     * stack of (vertex, next neighbour) frames on the heap, so a 1e8-vertex path needs
+     * 800MB of heap instead of overflowing the call stack. The stack is kept between
+     * run() calls: sweeping every root of a graph allocates once.
+     */
+    template<AdjacencyGraph G>
+    class DepthFirstEngine {
+    private:
+        struct Frame {
+            int v;
+            unsigned next;
+        };
+        std::vector<Frame> stack_;
+
+    public:
+        template<typename Visitor>
+        void run(const G& g, int s, std::vector<bool>& marked, Visitor& visitor) {
+            marked.at(s) = true;
+            visitor.preorder(s);
+            stack_.push_back({s, 0});
+            while (!stack_.empty()) {
+                if (visitor.stop()) {
+                    stack_.clear();
+                    return;
+                }
+                auto& frame = stack_.back();
+                const int v = frame.v;
+                auto&& adj = g.adj(v);
+                const auto degree = std::ranges::size(adj);
+                int w = -1;
+                while (frame.next < degree) {
+                    const int x = adj[frame.next++];
+                    if (!marked[x]) {
+                        w = x;
+                        break;
+                    }
+                    visitor.nonTreeEdge(v, x);
+                    if (visitor.stop()) {
+                        stack_.clear();
+                        return;
+                    }
+                }
+                if (w < 0) {
+                    visitor.postorder(v);
+                    stack_.pop_back();
+                    if (!stack_.empty()) visitor.finishTreeEdge(stack_.back().v, v);
+                    continue;
+                }
+                marked[w] = true;
+                visitor.treeEdge(v, w);
+                visitor.preorder(w);
+                stack_.push_back({w, 0});
+            }
+        }
+    };
+}
+
+#endif //ALGO_DFS_H
@@ -0,0 +1,433 @@
+#include "flow.h"
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+
+namespace graph {
+    FlowEdge::FlowEdge(int v, int w, int64_t capacity)
+        : v_(v)
+        , w_(w)
+        , capacity_(capacity)
+    {
+        if (capacity < 0) throw std::invalid_argument("Capacity must be non-negative");
+    }
+
+    int FlowEdge::from() const {
+        return v_;
+    }
+
+    int FlowEdge::to() const {
+        return w_;
+    }
+
+    int64_t FlowEdge::capacity() const {
+        return capacity_;
+    }
+
+    FlowNetwork::FlowNetwork(int v)
+        : V_(v)
+        , offsets_(v + 1, 0)
+    {}
+
+    FlowNetwork::FlowNetwork(int v, std::vector<FlowEdge> edges)
+        : V_(v)
+        , edges_(std::move(edges))
+    {
+        for (const auto& e : edges_)
+            if (e.from() < 0 || e.from() >= V_ || e.to() < 0 || e.to() >= V_)
+                throw std::out_of_range("Edge endpoint is out of boundaries");
+        group();
+    }
+
+    // counting sort of the arcs by tail, both arcs of an edge placed in the same pass
+    void FlowNetwork::group() {
+        offsets_.assign(V_ + 1, 0);
+        for (const auto& e : edges_) {
+            ++offsets_[e.from() + 1];
+            ++offsets_[e.to() + 1];
+        }
+        for (int v = 0; v < V_; ++v)
+            offsets_[v + 1] += offsets_[v];
+        const size_t arcs = offsets_[V_];
+        heads_.resize(arcs);
+        mates_.resize(arcs);
+        capacities_.resize(arcs);
+        arcs_.resize(edges_.size());
+        std::vector<size_t> next(offsets_.begin(), offsets_.end() - 1);
+        for (size_t e = 0; e < edges_.size(); ++e) {
+            const auto& edge = edges_[e];
+            const size_t forward = next[edge.from()]++, backward = next[edge.to()]++;
+            heads_[forward] = edge.to();
+            heads_[backward] = edge.from();
+            mates_[forward] = backward;
+            mates_[backward] = forward;
+            capacities_[forward] = edge.capacity();
+            capacities_[backward] = 0;
+            arcs_[e] = forward;
+        }
+    }
+
+    // appends an arc to v's slice; every stored arc index at or past it moves up by one
+    size_t FlowNetwork::insertArc(int v, int head, int64_t capacity) {
+        const size_t at = offsets_[v + 1];
+        for (auto* indices : {&mates_, &arcs_})
+            for (auto& i : *indices)
+                if (i >= at) ++i;
+        const auto pos = static_cast<std::ptrdiff_t>(at);
+        heads_.insert(heads_.begin() + pos, head);
+        mates_.insert(mates_.begin() + pos, at);
+        capacities_.insert(capacities_.begin() + pos, capacity);
+        for (int u = v + 1; u <= V_; ++u)
+            ++offsets_[u];
+        return at;
+    }
+
+    int FlowNetwork::V() const noexcept {
+        return V_;
+    }
+
+    int FlowNetwork::E() const noexcept {
+        return static_cast<int>(edges_.size());
+    }
+
+    int FlowNetwork::addEdge(FlowEdge e) {
+        if (e.from() < 0 || e.from() >= V_ || e.to() < 0 || e.to() >= V_)
+            throw std::out_of_range("Edge endpoint is out of boundaries");
+        edges_.push_back(e);
+        arcs_.push_back(insertArc(e.from(), e.to(), e.capacity()));
+        const size_t backward = insertArc(e.to(), e.from(), 0);
+        mates_[arcs_.back()] = backward;
+        mates_[backward] = arcs_.back();
+        return E() - 1;
+    }
+
+    const FlowEdge& FlowNetwork::edge(int e) const {
+        return edges_.at(e);
+    }
+
+    std::span<const FlowEdge> FlowNetwork::edges() const noexcept {
+        return edges_;
+    }
+
+    const std::vector<size_t>& FlowNetwork::offsets() const {
+        return offsets_;
+    }
+
+    const std::vector<int>& FlowNetwork::heads() const {
+        return heads_;
+    }
+
+    const std::vector<size_t>& FlowNetwork::mates() const {
+        return mates_;
+    }
+
+    const std::vector<int64_t>& FlowNetwork::capacities() const {
+        return capacities_;
+    }
+
+    size_t FlowNetwork::arc(int e) const {
+        return arcs_.at(e);
+    }
+
+    namespace {
+        constexpr int none = -1;
+
+        /** Push-relabel towards `sink` over the residual arcs of a network. Height V marks
+         * a vertex that cannot reach the sink; `blocked` stays there and never moves flow.
+         * Every height below V has a stack of its active vertices and a doubly linked list
+         * of all of them, threaded through per-vertex arrays.
+         */
+        class Preflow {
+        private:
+            const std::vector<size_t>& offsets_;
+            const std::vector<int>& heads_;
+            const std::vector<size_t>& mates_;
+            const int V_;
+            std::vector<int> height_;
+            std::vector<size_t> current_;
+            std::vector<int> active_, nextActive_;
+            std::vector<int> all_, nextAll_, prevAll_;
+            int top_ = none;        // highest height with an active vertex, or above it
+            int highest_ = none;    // highest height with any vertex
+            size_t work_ = 0;
+
+        public:
+            std::vector<int64_t> residual;
+            std::vector<int64_t> excess;
+
+            explicit Preflow(const FlowNetwork& g)
+                    : offsets_(g.offsets())
+                    , heads_(g.heads())
+                    , mates_(g.mates())
+                    , V_(g.V())
+                    , height_(g.V())
+                    , current_(g.V())
+                    , active_(g.V(), none)
+                    , nextActive_(g.V())
+                    , all_(g.V(), none)
+                    , nextAll_(g.V())
+                    , prevAll_(g.V())
+                    , residual(g.capacities())
+                    , excess(g.V(), 0)
+            {}
+
+            void push(size_t a, int64_t delta) noexcept {
+                residual[a] -= delta;
+                residual[mates_[a]] += delta;
+                excess[heads_[a]] += delta;
+            }
+
+            // until no vertex but the sink and `blocked` has excess and can still reach the sink
+            void run(int sink, int blocked) {
+                relabelGlobally(sink, blocked);
+                // global relabelling costs O(V + E); doing it once per a few times that much
+                // relabelling work keeps it a constant share of the running time. More often
+                // only pays on long, thin networks: on image grids it doubled the time
+                const size_t period = 4 * (6 * static_cast<size_t>(V_) + heads_.size());
+                while (top_ >= 0) {
+                    const int v = active_[top_];
+                    if (v == none) {
+                        --top_;
+                        continue;
+                    }
+                    active_[top_] = nextActive_[v];
+                    discharge(v, sink);
+                    if (work_ > period) relabelGlobally(sink, blocked);
+                }
+            }
+
+            [[nodiscard]]
+            bool reaches(int v) const noexcept {
+                return height_[v] < V_;
+            }
+
+            // exact heights: residual distance to the sink by a backward BFS
+            void relabelGlobally(int sink, int blocked) {
+                work_ = 0;
+                std::fill(height_.begin(), height_.end(), V_);
+                std::fill(active_.begin(), active_.end(), none);
+                std::fill(all_.begin(), all_.end(), none);
+                top_ = highest_ = none;
+                std::vector<int> queue{sink};
+                height_[sink] = 0;
+                for (size_t i = 0; i < queue.size(); ++i) {
+                    const int u = queue[i];
+                    for (size_t a = offsets_[u]; a < offsets_[u + 1]; ++a) {
+                        const int w = heads_[a];
+                        if (height_[w] == V_ && w != blocked && residual[mates_[a]] > 0) {
+                            height_[w] = height_[u] + 1;
+                            queue.push_back(w);
+                        }
+                    }
+                }
+                for (size_t i = 1; i < queue.size(); ++i) {
+                    const int v = queue[i];
+                    current_[v] = offsets_[v];
+                    link(v);
+                    if (excess[v] > 0) activate(v);
+                }
+            }
+
+        private:
+            void activate(int v) noexcept {
+                nextActive_[v] = active_[height_[v]];
+                active_[height_[v]] = v;
+                top_ = std::max(top_, height_[v]);
+            }
+
+            void link(int v) noexcept {
+                const int h = height_[v];
+                prevAll_[v] = none;
+                nextAll_[v] = all_[h];
+                if (all_[h] != none) prevAll_[all_[h]] = v;
+                all_[h] = v;
+                highest_ = std::max(highest_, h);
+            }
+
+            void unlink(int v) noexcept {
+                if (prevAll_[v] != none) nextAll_[prevAll_[v]] = nextAll_[v];
+                else all_[height_[v]] = nextAll_[v];
+                if (nextAll_[v] != none) prevAll_[nextAll_[v]] = prevAll_[v];
+            }
+
+            // v is the highest active vertex, so nothing above it is active
+            void discharge(int v, int sink) {
+                for (;;) {
+                    const int h = height_[v];
+                    for (size_t& a = current_[v]; a < offsets_[v + 1]; ++a) {
+                        const int w = heads_[a];
+                        if (residual[a] == 0 || height_[w] != h - 1) continue;
+                        const int64_t delta = std::min(excess[v], residual[a]);
+                        const bool wasIdle = excess[w] == 0;
+                        excess[v] -= delta;
+                        push(a, delta);
+                        if (wasIdle && w != sink) activate(w);
+                        if (excess[v] == 0) return;
+                    }
+
+                    if (all_[h] == v && nextAll_[v] == none) {
+                        gap(h);
+                        return;
+                    }
+                    unlink(v);
+                    int lowest = V_;
+                    size_t at = offsets_[v];
+                    for (size_t a = offsets_[v]; a < offsets_[v + 1]; ++a)
+                        if (residual[a] > 0 && height_[heads_[a]] + 1 < lowest) {
+                            lowest = height_[heads_[a]] + 1;
+                            at = a;
+                        }
+                    work_ += offsets_[v + 1] - offsets_[v] + 12;
+                    height_[v] = lowest;
+                    if (lowest >= V_) return;
+                    current_[v] = at;
+                    link(v);
+                    top_ = std::max(top_, lowest);
+                }
+            }
+
+            // height h is empty once v leaves it: v and everything above are cut off
+            void gap(int h) noexcept {
+                for (int k = h; k <= highest_; ++k) {
+                    for (int v = all_[k]; v != none; v = nextAll_[v]) height_[v] = V_;
+                    all_[k] = active_[k] = none;
+                }
+                highest_ = h - 1;
+            }
+        };
+    }
+
+    MaxFlow::MaxFlow(const FlowNetwork& g, int s, int t)
+            : flow_(g.E(), 0)
+            , cut_(g.V(), false)
+    {
+        if (s < 0 || s >= g.V() || t < 0 || t >= g.V()) throw std::out_of_range("Vertex is out of boundaries");
+        if (s == t) throw std::invalid_argument("Source and sink must differ");
+        Preflow p(g);
+        const auto& offsets = g.offsets();
+        const auto& heads = g.heads();
+        for (size_t a = offsets[s]; a < offsets[s + 1]; ++a)
+            if (heads[a] != s && p.residual[a] > 0) p.push(a, p.residual[a]);
+
+        // a maximum preflow: whatever can still reach t is outside the cut
+        p.run(t, s);
+        p.relabelGlobally(t, s);
+        for (int v = 0; v < g.V(); ++v) cut_[v] = !p.reaches(v);
+        value_ = p.excess[t];
+
+        // the excess left on the source side goes back to s
+        p.run(s, t);
+        for (int e = 0; e < g.E(); ++e)
+            flow_[e] = g.edge(e).capacity() - p.residual[g.arc(e)];
+    }
+
+    int64_t MaxFlow::value() const noexcept {
+        return value_;
+    }
+
+    int64_t MaxFlow::flow(int e) const {
+        return flow_.at(e);
+    }
+
+    bool MaxFlow::inCut(int v) const {
+        return cut_.at(v);
+    }
+
+    std::vector<int> MaxFlow::cut(const FlowNetwork& g) const {
+        std::vector<int> crossing;
+        for (int e = 0; e < g.E(); ++e) {
+            const auto& edge = g.edge(e);
+            if (cut_.at(edge.from()) && !cut_.at(edge.to())) crossing.push_back(e);
+        }
+        return crossing;
+    }
+
+    BipartiteMatching::BipartiteMatching(const Graph& g)
+            : mate_(g.V(), none)
+    {
+        const TwoColor sides(g);
+        if (!sides.isBipartite()) throw std::invalid_argument("Graph must be bipartite");
+        const int V = g.V();
+        std::vector<int> left;
+        for (int v = 0; v < V; ++v)
+            if (!sides.color(v)) left.push_back(v);
+
+        for (int u : left)
+            for (int w : g.adj(u))
+                if (mate_[w] == none) {
+                    mate_[u] = w;
+                    mate_[w] = u;
+                    ++size_;
+                    break;
+                }
+
+        constexpr int unreached = std::numeric_limits<int>::max();
+        std::vector<int> dist(V), queue, stack;
+        std::vector<size_t> next(V);
+        for (;;) {
+            // layers of left vertices, from the free ones; `limit` is the length of the
+            // shortest augmenting path, counted in left vertices
+            queue.clear();
+            for (int u : left) {
+                dist[u] = mate_[u] == none ? 0 : unreached;
+                if (mate_[u] == none) queue.push_back(u);
+            }
+            int limit = unreached;
+            for (size_t i = 0; i < queue.size(); ++i) {
+                const int u = queue[i];
+                if (dist[u] + 1 >= limit) continue;
+                for (int w : g.adj(u)) {
+                    const int x = mate_[w];
+                    if (x == none) limit = dist[u] + 1;
+                    else if (dist[x] == unreached) {
+                        dist[x] = dist[u] + 1;
+                        queue.push_back(x);
+                    }
+                }
+            }
+            if (limit == unreached) break;
+
+            // augment along vertex-disjoint shortest paths; a left vertex that leads
+            // nowhere is taken out of its layer
+            for (int u : left) next[u] = 0;
+            for (int root : left) {
+                if (mate_[root] != none) continue;
+                stack.assign(1, root);
+                while (!stack.empty()) {
+                    const int u = stack.back();
+                    const auto& adj = g.adj(u);
+                    if (next[u] == adj.size()) {
+                        dist[u] = unreached;
+                        stack.pop_back();
+                        if (!stack.empty()) ++next[stack.back()];
+                        continue;
+                    }
+                    const int w = adj[next[u]], x = mate_[w];
+                    if (x == none && dist[u] + 1 == limit) {
+                        for (int v : stack) {
+                            const int partner = g.adj(v)[next[v]];
+                            mate_[v] = partner;
+                            mate_[partner] = v;
+                        }
+                        ++size_;
+                        break;
+                    }
+                    if (x != none && dist[x] == dist[u] + 1) stack.push_back(x);
+                    else ++next[u];
+                }
+            }
+        }
+    }
+
+    int BipartiteMatching::size() const noexcept {
+        return size_;
+    }
+
+    int BipartiteMatching::mate(int v) const {
+        return mate_.at(v);
+    }
+
+    bool BipartiteMatching::isMatched(int v) const {
+        return mate_.at(v) != none;
+    }
+}
@@ -0,0 +1,133 @@
+#ifndef ALGO_FLOW_H
+#define ALGO_FLOW_H
+#include <span>
+#include <vector>
+#include <cstdint>
+#include "graph.h"
+
+namespace graph {
+    struct FlowEdge {
+    private:
+        int v_, w_;
+        int64_t capacity_;
+    public:
+        FlowEdge(int v, int w, int64_t capacity);
+        [[nodiscard]]
+        int from() const;
+        [[nodiscard]]
+        int to() const;
+        [[nodiscard]]
+        int64_t capacity() const;
+    };
+
+    /** Capacitated digraph for max-flow ****************************************************
+     * Every edge v->w becomes a pair of residual arcs, v->w with the edge's capacity and
+     * w->v with none, each knowing the index of its mate. The arcs are kept in flat arrays
+     * grouped by tail (CSR layout), so a vertex's arcs are one slice and pushing along an
+     * arc updates its mate by index. Like EdgeWeightedDigraph, the constructors group a
+     * whole edge list at once and addEdge() inserts both arcs in place, O(V+E) per edge;
+     * reads never modify the network. Capacities are integers, which keeps push-relabel
+     * exact. Edge ids are their order of insertion.
+     */
+    class FlowNetwork {
+    private:
+        int V_;
+        std::vector<FlowEdge> edges_;
+        std::vector<size_t> offsets_;
+        std::vector<int> heads_;
+        std::vector<size_t> mates_;
+        std::vector<int64_t> capacities_;
+        std::vector<size_t> arcs_;
+
+        void group();
+        size_t insertArc(int v, int head, int64_t capacity);
+    public:
+        explicit FlowNetwork(int v);
+        FlowNetwork(int v, std::vector<FlowEdge> edges);
+        [[nodiscard]]
+        int V() const noexcept;
+        [[nodiscard]]
+        int E() const noexcept;
+        // returns the new edge's id
+        int addEdge(FlowEdge e);
+        [[nodiscard]]
+        const FlowEdge& edge(int e) const;
+        [[nodiscard]]
+        std::span<const FlowEdge> edges() const noexcept;
+
+        // residual arcs: those of v are [offsets()[v], offsets()[v + 1])
+        [[nodiscard]]
+        const std::vector<size_t>& offsets() const;
+        [[nodiscard]]
+        const std::vector<int>& heads() const;
+        [[nodiscard]]
+        const std::vector<size_t>& mates() const;
+        [[nodiscard]]
+        const std::vector<int64_t>& capacities() const;
+        // the forward arc of edge e
+        [[nodiscard]]
+        size_t arc(int e) const;
+    };
+
+    /** Maximum flow by highest-label push-relabel (Goldberg, Tarjan; Cherkassky, Goldberg) ******
+     * Vertices hold excess flow and a height, a lower bound on their residual distance to
+     * the sink; flow is pushed downhill from the highest active vertex, and a vertex with
+     * nowhere to push is relabelled one above its lowest residual neighbour. Two heuristics
+     * keep heights close to the true distances:
+     *   global relabelling: after a few times O(V + E) relabelling work the heights are
+     *     recomputed exactly by a backward BFS from the sink;
+     *   gap: when no vertex is left at some height, every vertex above it is cut off from
+     *     the sink and is dropped at once.
+     * Every height keeps a list of its vertices, so the highest active one and a gap are
+     * found in O(1). The first phase ends with a maximum preflow, which already gives the
+     * flow value and the minimum cut; the second returns the excess stranded on the source
+     * side to the source, by the same method with the source as sink, so that flow() is a
+     * valid flow. O(V^2 sqrt(E)) in the worst case, close to linear in practice.
+     */
+    class MaxFlow {
+    private:
+        std::vector<int64_t> flow_;
+        std::vector<bool> cut_;
+        int64_t value_ = 0;
+
+    public:
+        MaxFlow(const FlowNetwork& g, int s, int t);
+        [[nodiscard]]
+        int64_t value() const noexcept;
+        [[nodiscard]]
+        int64_t flow(int e) const;
+        // whether v is on the source side of the minimum cut: every vertex that cannot
+        // reach t in the residual network, which makes it the largest minimum cut
+        [[nodiscard]]
+        bool inCut(int v) const;
+        // ids of the edges crossing the minimum cut, which are saturated
+        [[nodiscard]]
+        std::vector<int> cut(const FlowNetwork& g) const;
+    };
+
+    /** Maximum bipartite matching (Hopcroft, Karp) *********************************************
+     * The sides come from TwoColor; a graph that is not bipartite is rejected. A greedy
+     * pass matches what it can, then every phase finds, by a BFS from the free vertices of
+     * one side, the length of the shortest augmenting paths and augments along a maximal
+     * set of them by DFS; O(sqrt(V)) phases, O(E sqrt(V)) in all. The DFS keeps its own
+     * stack.
+     */
+    class BipartiteMatching {
+    private:
+        std::vector<int> mate_;
+        int size_ = 0;
+
+    public:
+        explicit BipartiteMatching(const Graph& g);
+        // number of matched pairs
+        [[nodiscard]]
+        int size() const noexcept;
+        // v's partner, or -1
+        [[nodiscard]]
+        int mate(int v) const;
+        [[nodiscard]]
+        bool isMatched(int v) const;
+    };
+}
+
+#endif //ALGO_FLOW_H
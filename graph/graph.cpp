@@ -1,8 +1,38 @@
 #include "graph.h"
 #include <iomanip>
+#include "reachability.h"
 #include "../union_find/union_find.h"
 
 namespace graph {
+    namespace {
+        // first pass of a bulk load: validates the endpoints and returns every list's size
+        template<typename Edges, typename Ends>
+        std::vector<size_t> countDegrees(int V, const Edges& edges, bool directed, Ends ends) {
+            std::vector<size_t> degree(V, 0);
+            for (const auto& e : edges) {
+                auto [v, w] = ends(e);
+                if (v < 0 || v >= V || w < 0 || w >= V)
+                    throw std::out_of_range("Edge endpoint is out of boundaries");
+                ++degree[v];
+                if (!directed) ++degree[w];
+            }
+            return degree;
+        }
+
+        // the "V E" header and E lines of "v w", read as they are
+        std::pair<int, std::vector<std::pair<int, int>>> readEdges(std::istream& in) {
+            int V = 0, E = 0;
+            in >> V >> E;
+            std::vector<std::pair<int, int>> edges(std::max(E, 0));
+            for (auto& [v, w] : edges)
+                in >> v >> w;
+            if (!in) throw std::invalid_argument("Truncated edge list");
+            return {V, std::move(edges)};
+        }
+
+        auto pairEnds = [](const std::pair<int, int>& e) { return e; };
+    }
+
     bool DepthFirstPaths::hasPathTo(int v) const {
         return marked_.at(v);
     }
@@ -16,16 +46,6 @@ namespace graph {
         return path;
     }
 
-    void DepthFirstPaths::dfs(const Graph &g, int v) {
-        marked_.at(v) = true;
-        for (auto w : g.adj(v)) {
-            if (!marked_.at(w)) {
-                edgeTo_.at(w) = v;
-                dfs(g, w);
-            }
-        }
-    }
-
     int degree(const Graph &g, int v) {
         return static_cast<int>(g.adj(v).size());
     }
@@ -56,24 +76,41 @@ namespace graph {
             , e_{0}
             , adj_(nVerticies)
     {}
+    Graph::Graph(int nVerticies, std::span<const std::pair<int, int>> edges)
+            : v_(nVerticies)
+            , e_(static_cast<int>(edges.size()))
+            , adj_(nVerticies)
+    {
+        const auto degree = countDegrees(v_, edges, false, pairEnds);
+        for (int v = 0; v < v_; ++v)
+            adj_[v].reserve(degree[v]);
+        for (const auto& [v, w] : edges) {
+            adj_[v].push_back(w);
+            adj_[w].push_back(v);
+        }
+    }
+
     graph::Graph::Graph(std::istream &in)
             : v_{0}
             , e_{0}
     {
-        auto size = 0;
-        in >> v_ >> size;
-        std::fill_n(std::back_inserter(adj_), v_, std::vector<int>());
-        for (int i = 0; i < size; ++i) {
-            int v, w;
-            in >> v >> w;
-            addEdge(v, w);
-        }
+        auto [V, edges] = readEdges(in);
+        *this = Graph(V, edges);
     }
 
     void Graph::addEdge(int v, int w) {
         adj_.at(v).push_back(w);
         adj_.at(w).push_back(v);
         ++e_;
+        observers_.notify(v, w);
+    }
+
+    void Graph::attach(EdgeObserver &o) {
+        observers_.attach(o);
+    }
+
+    void Graph::detach(EdgeObserver &o) {
+        observers_.detach(o);
     }
 
     int Graph::V() const {
@@ -99,13 +136,6 @@ namespace graph {
         return os;
     }
 
-    DepthFirstSearch::DepthFirstSearch(const Graph &g, int s)
-            : marked_(g.V(), false)
-            , count_{0}
-    {
-        dfs(g, s);
-    }
-
     bool DepthFirstSearch::marked(int w) const {
         return marked_.at(w);
     }
@@ -114,28 +144,16 @@ namespace graph {
         return count_;
     }
 
-    void DepthFirstSearch::dfs(const Graph &g, int v) {
-        marked_.at(v) = true;
-        ++count_;
-        for (auto w : g.adj(v))
-            if (!marked(w))
-                dfs(g, w);
-    }
-
     DepthFirstPaths::DepthFirstPaths(const Graph &g, int s)
             : marked_(g.V(), false)
             , edgeTo_(g.V())
             , s_(s)
     {
-        dfs(g, s);
-    }
-
-    BreadthFirstPaths::BreadthFirstPaths(const Graph &g, int s)
-            : marked_(g.V(), false)
-            , edgeTo_(g.V())
-            , s_(s)
-    {
-        bfs(g, s_);
+        struct : DfsVisitor {
+            std::vector<int>& edgeTo;
+            void treeEdge(int v, int w) { edgeTo[w] = v; }
+        } visitor{{}, edgeTo_};
+        DepthFirstEngine<Graph>().run(g, s, marked_, visitor);
     }
 
     bool BreadthFirstPaths::hasPathTo(int v) {
@@ -151,44 +169,6 @@ namespace graph {
         return path;
     }
 
-    void BreadthFirstPaths::bfs(const Graph &g, int s) {
-        std::queue<int> q;
-        marked_[s] = true;
-        q.push(s);
-        while(!q.empty()) {
-            int v = q.front(); q.pop();
-            for (auto w : g.adj(v)) {
-                if (!marked_[w]) {
-                    edgeTo_[w] = v;
-                    marked_[w] = true;
-                    q.push(w);
-                }
-            }
-        }
-    }
-
-    CC::CC(const Graph &g)
-            : id_(g.V())
-            , marked_(g.V(), false)
-            , count_{0}
-    {
-        for (int s = 0; s < g.V(); ++s) {
-            if (!marked_[s]) {
-                dfs(g, s);
-                ++count_;
-            }
-        }
-    }
-
-    void CC::dfs(const Graph &g, int v) {
-        marked_.at(v) = true;
-        id_.at(v) = count_;
-        for (auto w : g.adj(v)) {
-            if (!marked_.at(w))
-                dfs(g, w);
-        }
-    }
-
     bool CC::connected(int v, int w) const {
         return id_.at(v) == id_.at(w);
     }
@@ -201,10 +181,25 @@ namespace graph {
         return count_;
     }
 
-    Cycle::Cycle(const Graph &g) : marked_(g.V(), false) {
-        for (int s = 0; s < g.V(); ++s) {
-            if (!marked_[s])
-                dfs(g, s, s);
+    Cycle::Cycle(const Graph &g)
+            : marked_(g.V(), false)
+            , edgeTo_(g.V())
+    {
+        // any edge back to a marked vertex other than the tree parent closes a cycle, so a
+        // second copy of an edge does; a self-loop does too, even on a root
+        struct : DfsVisitor {
+            Cycle& self;
+            void treeEdge(int v, int w) { self.edgeTo_[w] = v; }
+            void nonTreeEdge(int v, int w) { if (v == w || w != self.edgeTo_[v]) self.hasCycle_ = true; }
+            [[nodiscard]]
+            bool stop() const { return self.hasCycle_; }
+        } visitor{{}, *this};
+        DepthFirstEngine<Graph> engine;
+        for (int s = 0; s < g.V() && !hasCycle_; ++s) {
+            if (!marked_[s]) {
+                edgeTo_[s] = s;
+                engine.run(g, s, marked_, visitor);
+            }
         }
     }
 
@@ -212,36 +207,25 @@ namespace graph {
         return hasCycle_;
     }
 
-    void Cycle::dfs(const Graph &g, int v, int u) {
-        marked_[v] = true;
-        for (int w : g.adj(v)) {
-            if (!marked_[w])
-                dfs(g, w, v);
-            else if (w != u) hasCycle_ = true;
-        }
-    }
-
     TwoColor::TwoColor(const Graph &g)
             : marked_(g.V(), false)
             , color_(g.V(), false)
     {
+        struct : DfsVisitor {
+            TwoColor& self;
+            void treeEdge(int v, int w) { self.color_[w] = !self.color_[v]; }
+            void nonTreeEdge(int v, int w) { if (self.color_[w] == self.color_[v]) self.isTwoColorable_ = false; }
+        } visitor{{}, *this};
+        DepthFirstEngine<Graph> engine;
         for (int s = 0; s < g.V(); ++s)
             if (!marked_[s])
-                dfs(g, s);
+                engine.run(g, s, marked_, visitor);
     }
 
     bool TwoColor::isBipartite() const {return isTwoColorable_;}
 
-    void TwoColor::dfs(const Graph &g, int v) {
-        marked_[v] = true;
-        for (auto w : g.adj(v)) {
-            if (!marked_[w]) {
-                color_[w] = !color_[v];
-                dfs(g, w);
-            } else if (color_[w] == color_[v]) {
-                isTwoColorable_ = false;
-            }
-        }
+    bool TwoColor::color(int v) const {
+        return color_.at(v);
     }
 
     Digraph::Digraph(int v)
@@ -251,18 +235,24 @@ namespace graph {
         std::fill_n(std::back_inserter(adj_), v_, std::vector<int>{});
     }
 
+    Digraph::Digraph(int v, std::span<const std::pair<int, int>> edges)
+            : v_(v)
+            , e_(static_cast<int>(edges.size()))
+            , adj_(v)
+    {
+        const auto degree = countDegrees(v_, edges, true, pairEnds);
+        for (int x = 0; x < v_; ++x)
+            adj_[x].reserve(degree[x]);
+        for (const auto& [from, to] : edges)
+            adj_[from].push_back(to);
+    }
+
     Digraph::Digraph(std::istream &in)
             : v_{0}
             , e_{0}
     {
-        auto size = 0;
-        in >> v_ >> size;
-        std::fill_n(std::back_inserter(adj_), v_, std::vector<int>());
-        for (int i = 0; i < size; ++i) {
-            int v, w;
-            in >> v >> w;
-            addEdge(v, w);
-        }
+        auto [V, edges] = readEdges(in);
+        *this = Digraph(V, edges);
     }
 
     int Digraph::V() const noexcept {
@@ -276,6 +266,15 @@ namespace graph {
     void Digraph::addEdge(int v, int w) {
         adj_[v].push_back(w);
         e_++;
+        observers_.notify(v, w);
+    }
+
+    void Digraph::attach(EdgeObserver &o) {
+        observers_.attach(o);
+    }
+
+    void Digraph::detach(EdgeObserver &o) {
+        observers_.detach(o);
     }
 
     const std::vector<int> &Digraph::adj(int v) const {
@@ -292,22 +291,18 @@ namespace graph {
 
     DirectedDFS::DirectedDFS(const Digraph &g, int s) : marked_(g.V(), false)
     {
-        dfs(g, s);
+        DfsVisitor visitor;
+        DepthFirstEngine<Digraph>().run(g, s, marked_, visitor);
     }
 
     DirectedDFS::DirectedDFS(const Digraph &g, std::vector<int> &&sources)
             : marked_(g.V(), false)
     {
+        DfsVisitor visitor;
+        DepthFirstEngine<Digraph> engine;
         for (int s : sources)
             if (!marked_[s])
-                dfs(g, s);
-    }
-
-    void DirectedDFS::dfs(const Digraph &g, int v) {
-        marked_[v] = true;
-        for (int w : g.adj(v))
-            if (!marked_[w])
-                dfs(g, w);
+                engine.run(g, s, marked_, visitor);
     }
 
     bool DirectedDFS::marked(int v) const noexcept {
@@ -319,26 +314,24 @@ namespace graph {
             , edgeTo_(g.V())
             , onStack_(g.V())
     {
-        for (int v = 0; v < g.V(); ++v)
-            if (!marked_[v]) dfs(g, v);
-    }
-
-    void DirectedCycle::dfs(const Digraph &g, int v) {
-        onStack_[v] = true;
-        marked_[v] = true;
-        for (auto w : g.adj(v)) {
-            if (hasCycle()) return;
-            else if (!marked_[w]) {
-                edgeTo_[w] = v;
-                dfs(g, w);
-            } else if (onStack_[w]) {
-                for (int x = v; x != w; x = edgeTo_[x])
-                    cycle_.push_back(x);
-                cycle_.push_back(w);
-                cycle_.push_back(v);
+        struct : DfsVisitor {
+            DirectedCycle& self;
+            void preorder(int v) { self.onStack_[v] = true; }
+            void postorder(int v) { self.onStack_[v] = false; }
+            void treeEdge(int v, int w) { self.edgeTo_[w] = v; }
+            void nonTreeEdge(int v, int w) {
+                if (!self.onStack_[w]) return;
+                for (int x = v; x != w; x = self.edgeTo_[x])
+                    self.cycle_.push_back(x);
+                self.cycle_.push_back(w);
+                self.cycle_.push_back(v);
             }
-        }
-        onStack_[v] = false;
+            [[nodiscard]]
+            bool stop() const { return self.hasCycle(); }
+        } visitor{{}, *this};
+        DepthFirstEngine<Digraph> engine;
+        for (int v = 0; v < g.V() && !hasCycle(); ++v)
+            if (!marked_[v]) engine.run(g, v, marked_, visitor);
     }
 
     bool DirectedCycle::hasCycle() const noexcept {
@@ -349,27 +342,6 @@ namespace graph {
         return cycle_;
     }
 
-    DepthFirstOrder::DepthFirstOrder(const Digraph &g)
-            : pre_{}
-            , post_{}
-            , reversePost_{}
-            , marked_(g.V(), false)
-    {
-        for (int v = 0; v < g.V(); ++v)
-            if (!marked_[v]) dfs(g, v);
-        reversePost_.reserve(post_.size());
-        std::copy(post_.rbegin(), post_.rend(), std::back_inserter(reversePost_));
-    }
-
-    void DepthFirstOrder::dfs(const Digraph &g, int v) {
-        pre_.push_back(v);
-        marked_[v] = true;
-        for (int w : g.adj(v))
-            if (!marked_[w])
-                dfs(g, w);
-        post_.push_back(v);
-    }
-
     std::vector<int> DepthFirstOrder::pre() const noexcept {
         return pre_;
     }
@@ -398,27 +370,6 @@ namespace graph {
         return !order_.empty();
     }
 
-    KosarajuSCC::KosarajuSCC(const Digraph &g)
-            : marked_(g.V(), false)
-            , id_(g.V(), 0)
-            , count_{0}
-    {
-        DepthFirstOrder order(g.reverse());
-        for (auto s : order.reversePost())
-            if (!marked_[s]) {
-                dfs(g, s);
-                ++count_;
-            }
-    }
-
-    void KosarajuSCC::dfs(const Digraph &g, int v) {
-        marked_[v] = true;
-        id_[v] = count_;
-        for (auto w : g.adj(v))
-            if (!marked_[w])
-                dfs(g, w);
-    }
-
     bool KosarajuSCC::stronglyConnected(int v, int w) const noexcept {
         return id_[v] == id_[w];
     }
@@ -428,17 +379,16 @@ namespace graph {
     int KosarajuSCC::count() const noexcept { return count_; }
 
     TransitiveClosure::TransitiveClosure(const Digraph &g)
-            : all_(g.V(), nullptr)
-    {
-        for (int v = 0; v < g.V(); ++v)
-            all_[v] = std::make_shared<DirectedDFS>(g, v);
-    }
+            : index_(std::make_unique<ReachabilityIndex>(g))
+    {}
 
-    bool TransitiveClosure::reachable(int v, int w) const noexcept {
-        return all_[v]->marked(w);
+    TransitiveClosure::~TransitiveClosure() = default;
+
+    bool TransitiveClosure::reachable(int v, int w) const {
+        return index_->reachable(v, w);
     }
 
-    std::vector<Edge> EdgeWeightedGraph::edges() {
+    std::vector<Edge> EdgeWeightedGraph::edges() const {
         std::vector<Edge> ve;
         for (int v = 0; v < V(); ++v)
             for (auto& e : adj_.at(v))
@@ -453,8 +403,40 @@ namespace graph {
         , adj_(v, std::vector<Edge>())
     {}
 
-    EdgeWeightedGraph::EdgeWeightedGraph(std::istream &is) {
-        //! @todo IMPLEMENT!
+    EdgeWeightedGraph::EdgeWeightedGraph(int v, std::span<const Edge> edges)
+        : V_(v)
+        , E_(static_cast<int>(edges.size()))
+        , adj_(v)
+    {
+        const auto degree = countDegrees(V_, edges, false, [](const Edge& e) {
+            const int x = e.either();
+            return std::pair{x, e.other(x)};
+        });
+        for (int x = 0; x < V_; ++x)
+            adj_[x].reserve(degree[x]);
+        for (const auto& e : edges) {
+            const int x = e.either(), y = e.other(x);
+            adj_[x].push_back(e);
+            adj_[y].push_back(e);
+        }
+    }
+
+    EdgeWeightedGraph::EdgeWeightedGraph(std::istream &is)
+        : V_{0}
+        , E_{0}
+    {
+        int V = 0, E = 0;
+        is >> V >> E;
+        std::vector<Edge> edges;
+        edges.reserve(std::max(E, 0));
+        for (int i = 0; i < E; ++i) {
+            int v, w;
+            double weight;
+            is >> v >> w >> weight;
+            edges.emplace_back(v, w, weight);
+        }
+        if (!is) throw std::invalid_argument("Truncated edge list");
+        *this = EdgeWeightedGraph(V, edges);
     }
 
     int EdgeWeightedGraph::V() const noexcept {
@@ -526,9 +508,10 @@ namespace graph {
     }
 
     LazyPrimMST::LazyPrimMST(EdgeWeightedGraph &g)
-        : pq_(g.V())
-        , marked_(g.V())
+        : marked_(g.V())
         , mst_{}
+        , weight_{0}
+        , pq_(g.E())
     {
         visit(g, 0);
         while (!pq_.empty()) {
@@ -536,13 +519,14 @@ namespace graph {
             int v = e.either(), w = e.other(v);
             if (marked_.at(v) && marked_.at(w)) continue;
             mst_.push(e);
+            weight_ += e.weight();
             if (!marked_.at(v)) visit(g, v);
             if (!marked_.at(w)) visit(g, w);
         }
     }
 
     double LazyPrimMST::weight() const noexcept {
-        return 0; //! @todo IMPLEMENT
+        return weight_;
     }
 
     const std::queue<Edge> &LazyPrimMST::edges() const {
@@ -556,19 +540,51 @@ namespace graph {
                 pq_.insert(el);
     }
 
-//    PrimMST::PrimMST(EdgeWeightedGraph& g)
-//        : edgeTo_(g.V())
-//        , distTo_(g.V())
-//        , marked_(g.V(), false)
-//        , pq_(g.V())
-//    {
-//        for (int v = 0; v < g.V(); ++v)
-//            distTo_[v] = std::numeric_limits<double>::infinity();
-//        distTo_[0] = 0.0;
-//        pq_.insert({0, 0.0});
-//    }
+    PrimMST::PrimMST(const EdgeWeightedGraph& g)
+        : edgeTo_(g.V())
+        , distTo_(g.V(), std::numeric_limits<double>::infinity())
+        , marked_(g.V(), false)
+        , weight_{0}
+    {
+        data_structures::IndexMinPriorityQueue<double> pq(g.V());
+        for (int s = 0; s < g.V(); ++s) {
+            if (marked_[s]) continue;
+            distTo_[s] = 0.0;
+            pq.insert(s, 0.0);
+            while (!pq.empty()) {
+                const int v = pq.pop();
+                if (v != s) {
+                    mst_.push_back(edgeTo_[v]);
+                    weight_ += edgeTo_[v].weight();
+                }
+                visit(g, v, pq);
+            }
+        }
+    }
+
+    const std::vector<Edge>& PrimMST::edges() const noexcept {
+        return mst_;
+    }
+
+    double PrimMST::weight() const noexcept {
+        return weight_;
+    }
+
+    void PrimMST::visit(const EdgeWeightedGraph& g, int v, data_structures::IndexMinPriorityQueue<double>& pq) {
+        marked_[v] = true;
+        for (const auto& e : g.adj(v)) {
+            const int w = e.other(v);
+            if (marked_[w] || !(e.weight() < distTo_[w])) continue;
+            edgeTo_[w] = e;
+            distTo_[w] = e.weight();
+            if (pq.contains(w)) pq.decreaseKey(w, distTo_[w]);
+            else pq.insert(w, distTo_[w]);
+        }
+    }
+
     KruskalMST::KruskalMST(EdgeWeightedGraph &g)
         : mst_{}
+        , weight_{0}
     {
         data_structures::MinPriorityQueue<Edge> pq(g.E());
         for (const auto& e : g.edges()) pq.insert(e);
@@ -579,6 +595,7 @@ namespace graph {
             if (uf.connected(v, w)) continue;
             uf.Union(v, w);
             mst_.push(e);
+            weight_ += e.weight();
         }
     }
 
@@ -586,6 +603,267 @@ namespace graph {
         return mst_;
     }
     double KruskalMST::weight() const noexcept {
-        return 1.0;
+        return weight_;
+    }
+
+    Topological::Topological(const EdgeWeightedDigraph &g)
+        : Topological(g.digraph())
+    {}
+
+    DirectedEdge::DirectedEdge()
+        : v_(0), w_(0), weight_(0)
+    {}
+
+    DirectedEdge::DirectedEdge(int v, int w, double weight)
+        : v_(v)
+        , w_(w)
+        , weight_(weight)
+    {}
+
+    double DirectedEdge::weight() const {
+        return weight_;
+    }
+
+    int DirectedEdge::from() const {
+        return v_;
+    }
+
+    int DirectedEdge::to() const {
+        return w_;
+    }
+
+    std::ostream &operator<<(std::ostream &os, const DirectedEdge &de) {
+        return os << de.v_ << "->" << de.w_
+                  << ' ' << std::setprecision(2) << de.weight_;
+    }
+
+    EdgeWeightedDigraph::EdgeWeightedDigraph(int v)
+        : V_(v)
+        , E_(0)
+        , offsets_(v + 1, 0)
+    {}
+
+    EdgeWeightedDigraph::EdgeWeightedDigraph(std::istream &in)
+        : V_(0)
+        , E_(0)
+    {
+        int size = 0;
+        in >> V_ >> size;
+        edges_.reserve(size);
+        for (int i = 0; i < size; ++i) {
+            int v, w;
+            double weight;
+            in >> v >> w >> weight;
+            edges_.emplace_back(v, w, weight);
+        }
+        group();
+    }
+
+    EdgeWeightedDigraph::EdgeWeightedDigraph(int v, std::vector<DirectedEdge> edges)
+        : V_(v)
+        , E_(0)
+        , edges_(std::move(edges))
+    {
+        group();
+    }
+
+    // counting sort by source vertex: one pass to size the slices, one to fill them
+    void EdgeWeightedDigraph::group() {
+        for (const auto& e : edges_)
+            if (e.from() < 0 || e.from() >= V_ || e.to() < 0 || e.to() >= V_)
+                throw std::out_of_range("Edge endpoint is out of boundaries");
+        E_ = static_cast<int>(edges_.size());
+        offsets_.assign(V_ + 1, 0);
+        for (const auto& e : edges_)
+            ++offsets_[e.from() + 1];
+        for (int v = 0; v < V_; ++v)
+            offsets_[v + 1] += offsets_[v];
+        std::vector<DirectedEdge> sorted(edges_.size());
+        std::vector<size_t> next(offsets_.begin(), offsets_.end() - 1);
+        for (const auto& e : edges_)
+            sorted[next[e.from()]++] = e;
+        edges_ = std::move(sorted);
+    }
+
+    int EdgeWeightedDigraph::V() const noexcept {
+        return V_;
+    }
+
+    int EdgeWeightedDigraph::E() const noexcept {
+        return E_;
+    }
+
+    void EdgeWeightedDigraph::addEdge(DirectedEdge e) {
+        if (e.from() < 0 || e.from() >= V_ || e.to() < 0 || e.to() >= V_)
+            throw std::out_of_range("Edge endpoint is out of boundaries");
+        edges_.insert(edges_.begin() + static_cast<std::ptrdiff_t>(offsets_[e.from() + 1]), e);
+        for (int v = e.from() + 1; v <= V_; ++v)
+            ++offsets_[v];
+        ++E_;
+    }
+
+    std::span<const DirectedEdge> EdgeWeightedDigraph::adj(int v) const {
+        return {edges_.data() + offsets_.at(v), edges_.data() + offsets_.at(v + 1)};
+    }
+
+    int EdgeWeightedDigraph::outdegree(int v) const {
+        return static_cast<int>(adj(v).size());
+    }
+
+    std::span<const DirectedEdge> EdgeWeightedDigraph::edges() const {
+        return edges_;
+    }
+
+    Digraph EdgeWeightedDigraph::digraph() const {
+        Digraph d(V_);
+        for (const auto& e : edges())
+            d.addEdge(e.from(), e.to());
+        return d;
+    }
+
+    EdgeWeightedDigraph EdgeWeightedDigraph::reverse() const {
+        std::vector<DirectedEdge> reversed;
+        reversed.reserve(E_);
+        for (const auto& e : edges())
+            reversed.emplace_back(e.to(), e.from(), e.weight());
+        return {V_, std::move(reversed)};
+    }
+
+    std::ostream &operator<<(std::ostream &os, const EdgeWeightedDigraph &g) {
+        os << g.V() << " verticies, " << g.E() << " edges\n";
+        for (int v = 0; v < g.V(); ++v) {
+            os << v << ": ";
+            for (const auto& e : g.adj(v))
+                os << e << "  ";
+            os << '\n';
+        }
+        return os;
+    }
+
+    AcyclicSP::AcyclicSP(const EdgeWeightedDigraph &g, int s)
+        : distTo_(g.V(), std::numeric_limits<double>::infinity())
+        , edgeTo_(g.V())
+        , s_(s)
+    {
+        Topological top(g);
+        if (!top.isDAG())
+            throw std::invalid_argument("Graph is not acyclic");
+        distTo_.at(s) = 0.0;
+        for (int v : top.order()) {
+            if (distTo_[v] == std::numeric_limits<double>::infinity()) continue;
+            for (const auto& e : g.adj(v)) {
+                const int w = e.to();
+                if (distTo_[w] > distTo_[v] + e.weight()) {
+                    distTo_[w] = distTo_[v] + e.weight();
+                    edgeTo_[w] = e;
+                }
+            }
+        }
+    }
+
+    double AcyclicSP::distTo(int v) const {
+        return distTo_.at(v);
+    }
+
+    bool AcyclicSP::hasPathTo(int v) const {
+        return distTo_.at(v) < std::numeric_limits<double>::infinity();
+    }
+
+    std::vector<DirectedEdge> AcyclicSP::pathTo(int v) const {
+        if (!hasPathTo(v)) return {};
+        std::vector<DirectedEdge> path;
+        for (int x = v; x != s_; x = edgeTo_[x].from())
+            path.push_back(edgeTo_[x]);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    BellmanFordSP::BellmanFordSP(const EdgeWeightedDigraph &g, int s)
+        : distTo_(g.V(), std::numeric_limits<double>::infinity())
+        , edgeTo_(g.V())
+        , onQ_(g.V(), false)
+        , s_(s)
+    {
+        distTo_.at(s) = 0.0;
+        queue_.push(s);
+        onQ_[s] = true;
+        while (!queue_.empty() && !hasNegativeCycle()) {
+            int v = queue_.front(); queue_.pop();
+            onQ_[v] = false;
+            relax(g, v);
+        }
+    }
+
+    void BellmanFordSP::relax(const EdgeWeightedDigraph &g, int v) {
+        for (const auto& e : g.adj(v)) {
+            const int w = e.to();
+            if (distTo_[w] > distTo_[v] + e.weight()) {
+                distTo_[w] = distTo_[v] + e.weight();
+                edgeTo_[w] = e;
+                if (!onQ_[w]) {
+                    queue_.push(w);
+                    onQ_[w] = true;
+                }
+            }
+            if (++cost_ % g.V() == 0) {
+                findNegativeCycle();
+                if (hasNegativeCycle()) return;
+            }
+        }
+    }
+
+    // Every reached vertex has at most one parent edge (s gets one only when a negative
+    // cycle runs through it), so walking parents from any vertex either stops or runs
+    // into a cycle. Each vertex is walked over once, stamped with the walk it belongs to.
+    void BellmanFordSP::findNegativeCycle() {
+        const int V = static_cast<int>(distTo_.size());
+        auto hasParent = [this](int x) {
+            return x == s_ ? distTo_[x] < 0 : distTo_[x] < std::numeric_limits<double>::infinity();
+        };
+        std::vector<int> walk(V, -1);
+        for (int start = 0; start < V; ++start) {
+            int x = start;
+            while (walk[x] == -1 && hasParent(x)) {
+                walk[x] = start;
+                x = edgeTo_[x].from();
+            }
+            if (walk[x] != start) continue;
+            for (int y = x;;) {
+                cycle_.push_back(edgeTo_[y]);
+                y = edgeTo_[y].from();
+                if (y == x) break;
+            }
+            std::reverse(cycle_.begin(), cycle_.end());
+            return;
+        }
+    }
+
+    double BellmanFordSP::distTo(int v) const {
+        if (hasNegativeCycle())
+            throw std::logic_error("Negative cost cycle exists");
+        return distTo_.at(v);
+    }
+
+    bool BellmanFordSP::hasPathTo(int v) const {
+        return distTo_.at(v) < std::numeric_limits<double>::infinity();
+    }
+
+    std::vector<DirectedEdge> BellmanFordSP::pathTo(int v) const {
+        if (hasNegativeCycle())
+            throw std::logic_error("Negative cost cycle exists");
+        if (!hasPathTo(v)) return {};
+        std::vector<DirectedEdge> path;
+        for (int x = v; x != s_; x = edgeTo_[x].from())
+            path.push_back(edgeTo_[x]);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    bool BellmanFordSP::hasNegativeCycle() const noexcept {
+        return !cycle_.empty();
+    }
+
+    std::vector<DirectedEdge> BellmanFordSP::negativeCycle() const {
+        return cycle_;
     }
 }
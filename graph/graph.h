@@ -8,7 +8,11 @@
 #include <limits>
 #include <sstream>
 #include <memory>
+#include <span>
+#include <utility>
 #include "../data_structures/priority_queue.h"
+#include "concepts.h"
+#include "dfs.h"
 
 namespace graph {
     struct Edge {
@@ -48,13 +52,42 @@ struct data_structures::CompPolicy<graph::Edge, true>{
 };
 
 namespace graph {
+    /** Edge insertion hooks ********************************************************
+     * The incremental analyses (incremental.h) attach() to a Graph or Digraph and are
+     * told about every addEdge once the edge is in. A graph does not own its observers
+     * and does not hand them on when it is copied or assigned to.
+     */
+    class EdgeObserver {
+    public:
+        virtual ~EdgeObserver() = default;
+        virtual void edgeAdded(int v, int w) = 0;
+    };
+
+    class EdgeObservers {
+    private:
+        std::vector<EdgeObserver*> list_;
+    public:
+        EdgeObservers() = default;
+        EdgeObservers(const EdgeObservers&) noexcept {}
+        EdgeObservers& operator=(const EdgeObservers&) noexcept { return *this; }
+        void attach(EdgeObserver& o) { list_.push_back(&o); }
+        void detach(EdgeObserver& o) { std::erase(list_, &o); }
+        void notify(int v, int w) const {
+            for (auto* o : list_) o->edgeAdded(v, w);
+        }
+    };
+
     /** Undirected graphs ********************************************************
      */
     class Graph {
     public:
         explicit Graph(int nVerticies);
+        // bulk load: every adjacency list is sized exactly before it is filled
+        Graph(int nVerticies, std::span<const std::pair<int, int>> edges);
         explicit Graph(std::istream& in);
         void addEdge(int v, int w);
+        void attach(EdgeObserver& o);
+        void detach(EdgeObserver& o);
         [[nodiscard]]
         int V() const;
         [[nodiscard]]
@@ -67,6 +100,7 @@ namespace graph {
         int v_{};
         int e_;
         std::vector<std::vector<int>> adj_;
+        EdgeObservers observers_;
     };
 
     /** *****************some free funcs************************
@@ -83,15 +117,26 @@ namespace graph {
         std::vector<bool> marked_;
         int count_;
     public:
-        DepthFirstSearch(const Graph& g, int s);
+        template<AdjacencyGraph G>
+        DepthFirstSearch(const G& g, int s);
         [[nodiscard]]
         bool marked(int w) const;
         [[nodiscard]]
         int count() const;
-    private:
-        void dfs(const Graph& g, int v);
     };
 
+    template<AdjacencyGraph G>
+    DepthFirstSearch::DepthFirstSearch(const G& g, int s)
+            : marked_(g.V(), false)
+            , count_{0}
+    {
+        struct : DfsVisitor {
+            int& count;
+            void preorder(int) { ++count; }
+        } visitor{{}, count_};
+        DepthFirstEngine<G>().run(g, s, marked_, visitor);
+    }
+
     /** ********************************************************
      */
     class DepthFirstPaths {
@@ -104,8 +149,6 @@ namespace graph {
         [[nodiscard]]
         bool hasPathTo(int v) const;
         std::vector<int> pathTo(int v);
-    private:
-        void dfs(const Graph& g, int v);
     };
 
     /** ********************************************************
@@ -116,14 +159,42 @@ namespace graph {
         std::vector<int> edgeTo_;
         const int s_;
     public:
-        BreadthFirstPaths(const Graph& g, int s);
+        template<AdjacencyGraph G>
+        BreadthFirstPaths(const G& g, int s);
         bool hasPathTo(int v);
         std::vector<int> pathTo(int v);
 
     private:
-        void bfs(const Graph& g, int s);
+        template<AdjacencyGraph G>
+        void bfs(const G& g, int s);
     };
 
+    template<AdjacencyGraph G>
+    BreadthFirstPaths::BreadthFirstPaths(const G& g, int s)
+            : marked_(g.V(), false)
+            , edgeTo_(g.V())
+            , s_(s)
+    {
+        bfs(g, s_);
+    }
+
+    template<AdjacencyGraph G>
+    void BreadthFirstPaths::bfs(const G& g, int s) {
+        std::queue<int> q;
+        marked_[s] = true;
+        q.push(s);
+        while(!q.empty()) {
+            int v = q.front(); q.pop();
+            for (int w : g.adj(v)) {
+                if (!marked_[w]) {
+                    edgeTo_[w] = v;
+                    marked_[w] = true;
+                    q.push(w);
+                }
+            }
+        }
+    }
+
     /** ********************************************************
      */
     class CC {
@@ -132,10 +203,8 @@ namespace graph {
         std::vector<int> id_;
         int count_;
     public:
-        explicit CC(const Graph& g);
-    private:
-        void dfs(const Graph& g, int v);
-    public:
+        template<AdjacencyGraph G>
+        explicit CC(const G& g);
         [[nodiscard]]
         bool connected(int v, int w) const;
         [[nodiscard]]
@@ -144,18 +213,37 @@ namespace graph {
         int count() const;
     };
 
+    template<AdjacencyGraph G>
+    CC::CC(const G& g)
+            : marked_(g.V(), false)
+            , id_(g.V())
+            , count_{0}
+    {
+        struct : DfsVisitor {
+            std::vector<int>& id;
+            const int& count;
+            void preorder(int v) { id[v] = count; }
+        } visitor{{}, id_, count_};
+        DepthFirstEngine<G> engine;
+        for (int s = 0; s < g.V(); ++s) {
+            if (!marked_[s]) {
+                engine.run(g, s, marked_, visitor);
+                ++count_;
+            }
+        }
+    }
+
     /** ********************************************************
      */
     class Cycle {
     private:
         std::vector<bool> marked_;
+        std::vector<int> edgeTo_;
         bool hasCycle_ = false;
     public:
         explicit Cycle(const Graph& g);
         [[nodiscard]]
         bool hasCycle() const;
-    private:
-        void dfs(const Graph& g, int v, int u);
     };
 
     /** ********************************************************
@@ -169,8 +257,9 @@ namespace graph {
         explicit TwoColor(const Graph& g);
         [[nodiscard]]
         bool isBipartite() const;
-    private:
-        void dfs(const Graph& g, int v);
+        // v's side; meaningful when the graph is bipartite
+        [[nodiscard]]
+        bool color(int v) const;
     };
 
     /** Directed graphs ********************************************************
@@ -179,8 +268,10 @@ namespace graph {
         int v_;
         int e_;
         std::vector<std::vector<int>> adj_;
+        EdgeObservers observers_;
     public:
         explicit Digraph(int v);
+        Digraph(int v, std::span<const std::pair<int, int>> edges);
         explicit Digraph(std::istream& in);
 
         [[nodiscard]]
@@ -188,6 +279,8 @@ namespace graph {
         [[nodiscard]]
         int E() const noexcept;
         void addEdge(int v, int w);
+        void attach(EdgeObserver& o);
+        void detach(EdgeObserver& o);
         [[nodiscard]]
         const std::vector<int>& adj(int v) const;;
         [[nodiscard]]
@@ -200,9 +293,6 @@ namespace graph {
     public:
         DirectedDFS(const Digraph& g, int s);
         DirectedDFS(const Digraph& g, std::vector<int>&& sources);
-    private:
-        void dfs(const Digraph& g, int v);
-    public:
         [[nodiscard]]
         bool marked(int v) const noexcept;
 
@@ -217,9 +307,6 @@ namespace graph {
         std::vector<bool> onStack_;
     public:
         explicit DirectedCycle(const Digraph& g);
-    private:
-        void dfs(const Digraph& g, int v);
-    public:
         [[nodiscard]]
         bool hasCycle() const noexcept;
         [[nodiscard]]
@@ -233,10 +320,8 @@ namespace graph {
         std::vector<int> post_;
         std::vector<int> reversePost_;
     public:
-        explicit DepthFirstOrder(const Digraph& g);
-    private:
-        void dfs(const Digraph& g, int v);
-    public:
+        template<AdjacencyGraph G>
+        explicit DepthFirstOrder(const G& g);
         [[nodiscard]]
         std::vector<int> pre() const noexcept;
         [[nodiscard]]
@@ -244,13 +329,38 @@ namespace graph {
         [[nodiscard]]
         std::vector<int> reversePost() const noexcept;
     };
+
+    template<AdjacencyGraph G>
+    DepthFirstOrder::DepthFirstOrder(const G& g)
+            : marked_(g.V(), false)
+            , pre_{}
+            , post_{}
+            , reversePost_{}
+    {
+        struct : DfsVisitor {
+            std::vector<int>& pre;
+            std::vector<int>& post;
+            void preorder(int v) { pre.push_back(v); }
+            void postorder(int v) { post.push_back(v); }
+        } visitor{{}, pre_, post_};
+        pre_.reserve(g.V());
+        post_.reserve(g.V());
+        DepthFirstEngine<G> engine;
+        for (int v = 0; v < g.V(); ++v)
+            if (!marked_[v]) engine.run(g, v, marked_, visitor);
+        reversePost_.reserve(post_.size());
+        std::copy(post_.rbegin(), post_.rend(), std::back_inserter(reversePost_));
+    }
     /** ********************************************************
     */
+    class EdgeWeightedDigraph;
+
     class Topological {
     private:
         std::vector<int> order_;
     public:
         explicit Topological(const Digraph& g);
+        explicit Topological(const EdgeWeightedDigraph& g);
         [[nodiscard]]
         std::vector<int> order() const noexcept;
         [[nodiscard]]
@@ -264,25 +374,48 @@ namespace graph {
         std::vector<int> id_;
         int count_;
     public:
-        explicit KosarajuSCC(const Digraph& g);
+        template<DirectedAdjacencyGraph G>
+        explicit KosarajuSCC(const G& g);
         [[nodiscard]]
         bool stronglyConnected(int v, int w) const noexcept;
         [[nodiscard]]
         int id(int v) const noexcept;
         [[nodiscard]]
         int count() const noexcept;
-    private:
-        void dfs(const Digraph& g, int v);
     };
+
+    template<DirectedAdjacencyGraph G>
+    KosarajuSCC::KosarajuSCC(const G& g)
+            : marked_(g.V(), false)
+            , id_(g.V(), 0)
+            , count_{0}
+    {
+        struct : DfsVisitor {
+            std::vector<int>& id;
+            const int& count;
+            void preorder(int v) { id[v] = count; }
+        } visitor{{}, id_, count_};
+        DepthFirstOrder order(g.reverse());
+        DepthFirstEngine<G> engine;
+        for (auto s : order.reversePost())
+            if (!marked_[s]) {
+                engine.run(g, s, marked_, visitor);
+                ++count_;
+            }
+    }
     /** ********************************************************
     */
+    class ReachabilityIndex;
+
+    // backed by a ReachabilityIndex (reachability.h) over the SCC condensation
     class TransitiveClosure {
     private:
-        std::vector<std::shared_ptr<DirectedDFS>> all_;
+        std::unique_ptr<ReachabilityIndex> index_;
     public:
         explicit TransitiveClosure(const Digraph& g);
+        ~TransitiveClosure();
         [[nodiscard]]
-        bool reachable(int v, int w) const noexcept;
+        bool reachable(int v, int w) const;
     };
     /** Minimum spanning trees ********************************************************
     */
@@ -295,6 +428,7 @@ namespace graph {
 
     public:
         explicit EdgeWeightedGraph(int v);
+        EdgeWeightedGraph(int v, std::span<const Edge> edges);
         explicit EdgeWeightedGraph(std::istream& is);
         [[nodiscard]]
         int V() const noexcept;
@@ -304,7 +438,7 @@ namespace graph {
         [[nodiscard]]
         const std::vector<Edge>& adj(int v) const;
         [[nodiscard]]
-        std::vector<Edge> edges();
+        std::vector<Edge> edges() const;
         friend std::ostream& operator<<(std::ostream& os, const EdgeWeightedGraph& ewg);
     };
 
@@ -312,6 +446,7 @@ namespace graph {
     private:
         std::vector<bool> marked_;
         std::queue<Edge> mst_;
+        double weight_;
         data_structures::MinPriorityQueue<Edge> pq_;
     public:
         explicit LazyPrimMST(EdgeWeightedGraph& g);
@@ -322,22 +457,32 @@ namespace graph {
         void visit(EdgeWeightedGraph& g, int v);
     };
 
-    //! @todo don't forget to implement the IndexMinPriorityQueue
-//    class PrimMST {
-//        std::vector<Edge> edgeTo_;
-//        std::vector<double> distTo_;
-//        std::vector<bool> marked_;
-//        data_structures::MinPriorityQueue<Double> pq_;
-//    public:
-//        explicit PrimMST(EdgeWeightedGraph& g);
-//        std::vector<Edge>& edges() const;
-//        double weight() const noexcept;
-//    private:
-//        void visit(EdgeWeightedGraph g, int v);
-//    };
+    /** Eager Prim: the queue holds vertices, not edges, keyed by the lightest edge that
+     * joins each one to the tree, and decreaseKey replaces an entry when a lighter edge
+     * shows up. The queue never holds more than V entries, against E for LazyPrimMST.
+     * Grows a tree from every vertex not yet reached, so it gives a spanning forest.
+     */
+    class PrimMST {
+    private:
+        std::vector<Edge> edgeTo_;
+        std::vector<double> distTo_;
+        std::vector<bool> marked_;
+        std::vector<Edge> mst_;
+        double weight_;
+    public:
+        explicit PrimMST(const EdgeWeightedGraph& g);
+        [[nodiscard]]
+        const std::vector<Edge>& edges() const noexcept;
+        [[nodiscard]]
+        double weight() const noexcept;
+    private:
+        void visit(const EdgeWeightedGraph& g, int v, data_structures::IndexMinPriorityQueue<double>& pq);
+    };
+
     class KruskalMST {
     private:
         std::queue<Edge> mst_;
+        double weight_;
     public:
         explicit KruskalMST(EdgeWeightedGraph& g);
         const std::queue<Edge>& edges() const;
@@ -353,11 +498,172 @@ namespace graph {
     public:
         DirectedEdge();
         DirectedEdge(int v, int w, double weight);
+        [[nodiscard]]
         double weight() const;
+        [[nodiscard]]
         int from() const;
+        [[nodiscard]]
         int to() const;
         friend std::ostream& operator<<(std::ostream& os, const DirectedEdge& de);
     };
+
+    /** Edges are kept in one array grouped by source vertex (CSR layout), so adj(v) is a
+     * contiguous slice instead of a separate heap block per vertex. The constructors group
+     * a whole edge list in O(V+E); addEdge() inserts into v's slice in place, which costs
+     * O(V+E) per edge, so bulk loads belong in the constructors. Reads never modify the
+     * graph, so any number of threads may share a const one.
+     */
+    class EdgeWeightedDigraph {
+    private:
+        int V_, E_;
+        std::vector<DirectedEdge> edges_;
+        std::vector<size_t> offsets_;
+
+        void group();
+    public:
+        explicit EdgeWeightedDigraph(int v);
+        explicit EdgeWeightedDigraph(std::istream& in);
+        EdgeWeightedDigraph(int v, std::vector<DirectedEdge> edges);
+        [[nodiscard]]
+        int V() const noexcept;
+        [[nodiscard]]
+        int E() const noexcept;
+        void addEdge(DirectedEdge e);
+        [[nodiscard]]
+        std::span<const DirectedEdge> adj(int v) const;
+        [[nodiscard]]
+        int outdegree(int v) const;
+        [[nodiscard]]
+        std::span<const DirectedEdge> edges() const;
+        [[nodiscard]]
+        Digraph digraph() const;
+        // every edge v->w becomes w->v with the same weight
+        [[nodiscard]]
+        EdgeWeightedDigraph reverse() const;
+        friend std::ostream& operator<<(std::ostream& os, const EdgeWeightedDigraph& g);
+    };
+
+    /** Single-source shortest paths for non-negative weights. The frontier is any
+     * IndexedMinQueue: the default binary heap works for any weights, while
+     * BucketQueue<unsigned>/RadixHeap<unsigned> give near-linear time on small
+     * integer weights (which are then truncated to the queue's key type).
+     */
+    template<data_structures::IndexedMinQueue PQ = data_structures::IndexMinPriorityQueue<double>>
+    class DijkstraSP {
+    public:
+        using dist_type = typename PQ::key_type;
+    private:
+        std::vector<dist_type> distTo_;
+        std::vector<DirectedEdge> edgeTo_;
+        const int s_;
+    public:
+        DijkstraSP(const EdgeWeightedDigraph& g, int s);
+        [[nodiscard]]
+        dist_type distTo(int v) const;
+        [[nodiscard]]
+        bool hasPathTo(int v) const;
+        [[nodiscard]]
+        std::vector<DirectedEdge> pathTo(int v) const;
+
+        static constexpr dist_type infinity() noexcept {
+            if constexpr (std::numeric_limits<dist_type>::has_infinity)
+                return std::numeric_limits<dist_type>::infinity();
+            else
+                return std::numeric_limits<dist_type>::max();
+        }
+    };
+
+    /** Shortest paths in an edge-weighted DAG: relax vertices in topological order.
+     * Linear time and negative weights are fine.
+     */
+    class AcyclicSP {
+    private:
+        std::vector<double> distTo_;
+        std::vector<DirectedEdge> edgeTo_;
+        const int s_;
+    public:
+        AcyclicSP(const EdgeWeightedDigraph& g, int s);
+        [[nodiscard]]
+        double distTo(int v) const;
+        [[nodiscard]]
+        bool hasPathTo(int v) const;
+        [[nodiscard]]
+        std::vector<DirectedEdge> pathTo(int v) const;
+    };
+
+    /** Queue-based Bellman-Ford. Every V relaxations the shortest-paths tree is checked
+     * for a cycle, which can only be a negative one; the search stops once it is found.
+     */
+    class BellmanFordSP {
+    private:
+        std::vector<double> distTo_;
+        std::vector<DirectedEdge> edgeTo_;
+        std::vector<bool> onQ_;
+        std::queue<int> queue_;
+        std::vector<DirectedEdge> cycle_;
+        const int s_;
+        long long cost_ = 0;
+    public:
+        BellmanFordSP(const EdgeWeightedDigraph& g, int s);
+        [[nodiscard]]
+        double distTo(int v) const;
+        [[nodiscard]]
+        bool hasPathTo(int v) const;
+        [[nodiscard]]
+        std::vector<DirectedEdge> pathTo(int v) const;
+        [[nodiscard]]
+        bool hasNegativeCycle() const noexcept;
+        [[nodiscard]]
+        std::vector<DirectedEdge> negativeCycle() const;
+    private:
+        void relax(const EdgeWeightedDigraph& g, int v);
+        void findNegativeCycle();
+    };
+
+    template<data_structures::IndexedMinQueue PQ>
+    DijkstraSP<PQ>::DijkstraSP(const EdgeWeightedDigraph& g, int s)
+            : distTo_(g.V(), infinity())
+            , edgeTo_(g.V())
+            , s_(s)
+    {
+        PQ pq(g.V());
+        distTo_.at(s) = dist_type{0};
+        pq.insert(s, distTo_[s]);
+        while (!pq.empty()) {
+            const int v = pq.pop();
+            for (const auto& e : g.adj(v)) {
+                if (e.weight() < 0)
+                    throw std::invalid_argument("Dijkstra does not accept negative weights");
+                const int w = e.to();
+                const dist_type d = distTo_[v] + static_cast<dist_type>(e.weight());
+                if (!(d < distTo_[w])) continue;
+                distTo_[w] = d;
+                edgeTo_[w] = e;
+                if (pq.contains(w)) pq.decreaseKey(w, d);
+                else pq.insert(w, d);
+            }
+        }
+    }
+
+    template<data_structures::IndexedMinQueue PQ>
+    typename DijkstraSP<PQ>::dist_type DijkstraSP<PQ>::distTo(int v) const {
+        return distTo_.at(v);
+    }
+
+    template<data_structures::IndexedMinQueue PQ>
+    bool DijkstraSP<PQ>::hasPathTo(int v) const {
+        return distTo_.at(v) < infinity();
+    }
+
+    template<data_structures::IndexedMinQueue PQ>
+    std::vector<DirectedEdge> DijkstraSP<PQ>::pathTo(int v) const {
+        if (!hasPathTo(v)) return {};
+        std::vector<DirectedEdge> path;
+        for (int x = v; x != s_; x = edgeTo_[x].from())
+            path.push_back(edgeTo_[x]);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
 }
 
 #endif //ALGO_GRAPH_H
@@ -0,0 +1,156 @@
+#include "incremental.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace graph {
+    IncrementalCC::IncrementalCC(Graph& g)
+        : g_(g)
+        , uf_(g.V())
+        , hasCycle_(Cycle(g).hasCycle())
+    {
+        for (int v = 0; v < g.V(); ++v)
+            for (int w : g.adj(v))
+                uf_.Union(v, w);
+        g_.attach(*this);
+    }
+
+    IncrementalCC::~IncrementalCC() {
+        g_.detach(*this);
+    }
+
+    bool IncrementalCC::connected(int v, int w) const {
+        return uf_.connected(v, w);
+    }
+
+    int IncrementalCC::count() const noexcept {
+        return static_cast<int>(uf_.components());
+    }
+
+    bool IncrementalCC::hasCycle() const noexcept {
+        return hasCycle_;
+    }
+
+    void IncrementalCC::edgeAdded(int v, int w) {
+        if (uf_.connected(v, w)) hasCycle_ = true;
+        else uf_.Union(v, w);
+    }
+
+    IncrementalBipartite::IncrementalBipartite(Graph& g)
+        : g_(g)
+        , uf_(g.V())
+    {
+        for (int v = 0; v < g.V(); ++v)
+            for (int w : g.adj(v))
+                if (!uf_.Union(v, w)) isBipartite_ = false;
+        g_.attach(*this);
+    }
+
+    IncrementalBipartite::~IncrementalBipartite() {
+        g_.detach(*this);
+    }
+
+    bool IncrementalBipartite::isBipartite() const noexcept {
+        return isBipartite_;
+    }
+
+    bool IncrementalBipartite::color(int v) {
+        return uf_.parity(v);
+    }
+
+    void IncrementalBipartite::edgeAdded(int v, int w) {
+        if (!uf_.Union(v, w)) isBipartite_ = false;
+    }
+
+    IncrementalTopological::IncrementalTopological(Digraph& g)
+        : g_(g)
+        , in_(g.V())
+        , rank_(g.V(), 0)
+        , seen_(g.V(), 0)
+    {
+        for (int v = 0; v < g.V(); ++v)
+            for (int w : g.adj(v))
+                in_[w].push_back(v);
+        Topological initial(g);
+        if (initial.isDAG() || g.V() == 0) {
+            order_ = initial.order();
+            for (int i = 0; i < static_cast<int>(order_.size()); ++i)
+                rank_[order_[i]] = i;
+        } else {
+            isDAG_ = false;
+        }
+        g_.attach(*this);
+    }
+
+    IncrementalTopological::~IncrementalTopological() {
+        g_.detach(*this);
+    }
+
+    bool IncrementalTopological::isDAG() const noexcept {
+        return isDAG_;
+    }
+
+    std::vector<int> IncrementalTopological::order() const {
+        if (!isDAG_) return {};
+        return order_;
+    }
+
+    int IncrementalTopological::rank(int v) const {
+        if (!isDAG_) throw std::logic_error("Graph has a cycle");
+        return rank_.at(v);
+    }
+
+    void IncrementalTopological::edgeAdded(int v, int w) {
+        in_[w].push_back(v);
+        if (!isDAG_) return;
+        const int lb = rank_[w], ub = rank_[v];
+        if (lb > ub) return;
+        if (v == w) {
+            isDAG_ = false;
+            return;
+        }
+        if (++stamp_ == 0) {
+            std::fill(seen_.begin(), seen_.end(), 0);
+            stamp_ = 1;
+        }
+        if (search(w, ub, true, v, forward_)) {
+            isDAG_ = false;
+            return;
+        }
+        search(v, lb, false, -1, backward_);
+
+        // the affected vertices keep their set of ranks: backward ones take the lowest
+        auto byRank = [this](int a, int b) { return rank_[a] < rank_[b]; };
+        std::sort(forward_.begin(), forward_.end(), byRank);
+        std::sort(backward_.begin(), backward_.end(), byRank);
+        std::vector<int>& ranks = stack_;
+        ranks.clear();
+        for (int x : backward_) ranks.push_back(rank_[x]);
+        for (int x : forward_) ranks.push_back(rank_[x]);
+        std::sort(ranks.begin(), ranks.end());
+        size_t i = 0;
+        for (const auto* set : {&backward_, &forward_})
+            for (int x : *set) {
+                rank_[x] = ranks[i];
+                order_[ranks[i++]] = x;
+            }
+    }
+
+    // DFS from s that stays strictly inside the rank window; true if it meets target
+    bool IncrementalTopological::search(int s, int bound, bool forward, int target, std::vector<int>& found) {
+        found.assign(1, s);
+        stack_.assign(1, s);
+        seen_[s] = stamp_;
+        while (!stack_.empty()) {
+            const int x = stack_.back();
+            stack_.pop_back();
+            for (int y : forward ? g_.adj(x) : in_[x]) {
+                if (y == target) return true;
+                if (seen_[y] == stamp_ || (forward ? rank_[y] >= bound : rank_[y] <= bound)) continue;
+                seen_[y] = stamp_;
+                found.push_back(y);
+                stack_.push_back(y);
+            }
+        }
+        return false;
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef ALGO_INCREMENTAL_H
+#define ALGO_INCREMENTAL_H
+#include <vector>
+#include <cstdint>
+#include "graph.h"
+#include "../union_find/union_find.h"
+
+namespace graph {
+    /** Incremental analyses ********************************************************
+     * CC, Cycle, TwoColor and Topological look at a graph once; these attach to a live
+     * Graph/Digraph as EdgeObservers and keep their answer current as addEdge() is
+     * called, at a fraction of the cost of a rerun. Each one starts from the edges
+     * already there, must not outlive its graph, and detaches when destroyed. Edges are
+     * only ever added, so a lost property (acyclic, bipartite) never comes back.
+     */
+
+    // connectivity on a path-halving weighted union-find: near-constant per edge
+    class IncrementalCC : public EdgeObserver {
+    private:
+        Graph& g_;
+        WeightedQuickUnion uf_;
+        bool hasCycle_;
+    public:
+        explicit IncrementalCC(Graph& g);
+        IncrementalCC(const IncrementalCC&) = delete;
+        IncrementalCC& operator=(const IncrementalCC&) = delete;
+        ~IncrementalCC() override;
+        [[nodiscard]]
+        bool connected(int v, int w) const;
+        [[nodiscard]]
+        int count() const noexcept;
+        // an edge inside one component closes a cycle, a second copy of an edge included
+        [[nodiscard]]
+        bool hasCycle() const noexcept;
+        void edgeAdded(int v, int w) override;
+    };
+
+    // two-colouring as a parity union-find: an edge is "the ends differ", an odd cycle a contradiction
+    class IncrementalBipartite : public EdgeObserver {
+    private:
+        Graph& g_;
+        ParityUnionFind uf_;
+        bool isBipartite_ = true;
+    public:
+        explicit IncrementalBipartite(Graph& g);
+        IncrementalBipartite(const IncrementalBipartite&) = delete;
+        IncrementalBipartite& operator=(const IncrementalBipartite&) = delete;
+        ~IncrementalBipartite() override;
+        [[nodiscard]]
+        bool isBipartite() const noexcept;
+        // a valid colouring while isBipartite(); vertices of one component split by it
+        [[nodiscard]]
+        bool color(int v);
+        void edgeAdded(int v, int w) override;
+    };
+
+    /** Pearce-Kelly dynamic topological order. An edge v->w that already agrees with the
+     * order costs O(1). Otherwise only the affected region is searched: forward from w
+     * over vertices ranked at most rank(v), backward from v over vertices ranked at
+     * least rank(w). Reaching v from w means a cycle; otherwise the two sets trade the
+     * ranks they already hold, backward set first. Keeps its own in-edges for the
+     * backward search.
+     */
+    class IncrementalTopological : public EdgeObserver {
+    private:
+        Digraph& g_;
+        std::vector<std::vector<int>> in_;
+        std::vector<int> rank_;     // vertex -> position
+        std::vector<int> order_;    // position -> vertex
+        bool isDAG_ = true;
+        std::vector<uint32_t> seen_;
+        uint32_t stamp_ = 0;
+        std::vector<int> forward_, backward_, stack_;
+
+    public:
+        explicit IncrementalTopological(Digraph& g);
+        IncrementalTopological(const IncrementalTopological&) = delete;
+        IncrementalTopological& operator=(const IncrementalTopological&) = delete;
+        ~IncrementalTopological() override;
+        [[nodiscard]]
+        bool isDAG() const noexcept;
+        // empty once a cycle has appeared, like Topological::order()
+        [[nodiscard]]
+        std::vector<int> order() const;
+        [[nodiscard]]
+        int rank(int v) const;
+        void edgeAdded(int v, int w) override;
+
+    private:
+        bool search(int s, int bound, bool forward, int target, std::vector<int>& found);
+    };
+}
+
+#endif //ALGO_INCREMENTAL_H
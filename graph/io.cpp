@@ -0,0 +1,357 @@
+#include "io.h"
+#include <atomic>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+#include <tuple>
+#include <algorithm>
+#include "parallel.h"
+
+namespace graph::io {
+    namespace {
+        constexpr char magic[8] = {'A', 'L', 'G', 'O', 'C', 'S', 'R', '\0'};
+        constexpr uint32_t version = 1;
+        constexpr uint32_t directedFlag = 1, weightedFlag = 2;
+
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t flags;
+            uint64_t V;
+            uint64_t entries;
+        };
+        static_assert(sizeof(Header) == 32);
+        static_assert(sizeof(size_t) == sizeof(uint64_t), "CSRGraph offsets are written as they are");
+        static_assert(sizeof(int) == sizeof(int32_t));
+
+        size_t padded(size_t bytes) {
+            return (bytes + 7) & ~size_t{7};
+        }
+
+        void check(const Header& h) {
+            if (std::memcmp(h.magic, magic, sizeof magic) != 0)
+                throw std::invalid_argument("Not a binary CSR graph");
+            if (h.version != version)
+                throw std::invalid_argument("Unsupported binary CSR version or byte order");
+            if (h.V > static_cast<uint64_t>(INT_MAX))
+                throw std::invalid_argument("Vertex count out of range");
+            // small enough that no byte count below, nor their sum, can wrap
+            constexpr uint64_t maxEntries = (SIZE_MAX - sizeof(Header) - (uint64_t{INT_MAX} + 1) * sizeof(uint64_t) - 8)
+                                          / (sizeof(int32_t) + sizeof(double));
+            if (h.entries > maxEntries)
+                throw std::invalid_argument("Entry count out of range");
+        }
+
+        // everything adj() relies on: offsets that start at 0, never decrease and end at
+        // the target count, and targets that are vertices
+        template<typename Offset>
+        void checkArrays(const Offset* offsets, const int32_t* targets, int V, uint64_t entries) {
+            if (offsets[0] != 0 || offsets[V] != entries || !std::is_sorted(offsets, offsets + V + 1))
+                throw std::invalid_argument("Offsets do not cover the target array");
+            if (std::any_of(targets, targets + entries, [V](int32_t w) { return w < 0 || w >= V; }))
+                throw std::invalid_argument("Target out of range");
+        }
+
+        // a chunk at a time, so a corrupt count runs into the end of the stream before it
+        // allocates much more than the stream holds
+        template<typename T>
+        void get(std::istream& is, std::vector<T>& v, size_t n) {
+            constexpr size_t chunk = (size_t{1} << 20) / sizeof(T);
+            v.clear();
+            while (v.size() < n && is) {
+                const size_t at = v.size(), k = std::min(chunk, n - at);
+                v.resize(at + k);
+                is.read(reinterpret_cast<char*>(v.data() + at), static_cast<std::streamsize>(k * sizeof(T)));
+            }
+        }
+
+        bool blank(char c) {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        const char* lineEnd(const char* p, const char* end) {
+            const auto* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            return nl ? nl : end;
+        }
+
+        const char* nextLine(const char* p, const char* end) {
+            const char* eol = lineEnd(p, end);
+            return eol == end ? end : eol + 1;
+        }
+
+        // skips whitespace, line breaks and comment lines
+        const char* skipToToken(const char* p, const char* end) {
+            while (p < end) {
+                if (blank(*p) || *p == '\n') ++p;
+                else if (*p == '#' || *p == '%') p = lineEnd(p, end);
+                else break;
+            }
+            return p;
+        }
+
+        template<typename T>
+        const char* number(const char* p, const char* end, T& out) {
+            while (p < end && blank(*p)) ++p;
+            auto [next, ec] = std::from_chars(p, end, out);
+            if (ec != std::errc{})
+                throw std::invalid_argument("Malformed edge list");
+            return next;
+        }
+
+        struct Chunk {
+            std::vector<std::pair<int, int>> edges;
+            std::vector<double> weights;
+            size_t unweighted = 0;
+            std::exception_ptr error;
+        };
+
+        void parseLines(const char* p, const char* end, int V, Chunk& out) {
+            while (p < end) {
+                const char* eol = lineEnd(p, end);
+                while (p < eol && blank(*p)) ++p;
+                if (p < eol && *p != '#' && *p != '%') {
+                    int v, w;
+                    p = number(number(p, eol, v), eol, w);
+                    if (v < 0 || v >= V || w < 0 || w >= V)
+                        throw std::out_of_range("Edge endpoint is out of boundaries");
+                    out.edges.emplace_back(v, w);
+                    while (p < eol && blank(*p)) ++p;
+                    if (p == eol) {
+                        ++out.unweighted;
+                    } else {
+                        double weight;
+                        p = number(p, eol, weight);
+                        out.weights.push_back(weight);
+                        while (p < eol && blank(*p)) ++p;
+                        if (p != eol) throw std::invalid_argument("Malformed edge list");
+                    }
+                }
+                p = eol == end ? end : eol + 1;
+            }
+        }
+    }
+
+    EdgeList parse(std::string_view text, unsigned threads) {
+        threads = parallel::threads(threads);
+        const char* p = text.data();
+        const char* const end = p + text.size();
+        long long V = 0;
+        size_t E = 0;
+        p = number(skipToToken(p, end), end, V);
+        p = number(skipToToken(p, end), end, E);
+        if (V < 0 || V > INT_MAX) throw std::invalid_argument("Vertex count out of range");
+        p = nextLine(p, end);
+
+        // cut at the first line break past every 1/n of the body
+        const size_t bytes = end - p;
+        const size_t n = std::max<size_t>(1, std::min<size_t>(4 * threads, bytes >> 16));
+        std::vector<const char*> cut(n + 1, end);
+        cut[0] = p;
+        for (size_t i = 1; i < n; ++i) {
+            const char* at = std::max(cut[i - 1], p + bytes / n * i);
+            cut[i] = nextLine(at, end);
+        }
+        std::vector<Chunk> chunks(n);
+        parallel::forRange(n, [&](size_t begin, size_t stop, unsigned) {
+            for (size_t i = begin; i < stop; ++i) {
+                try {
+                    parseLines(cut[i], cut[i + 1], static_cast<int>(V), chunks[i]);
+                } catch (...) {
+                    chunks[i].error = std::current_exception();
+                }
+            }
+        }, 1, threads);
+
+        std::vector<size_t> at(n + 1, 0);
+        size_t weighted = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (chunks[i].error) std::rethrow_exception(chunks[i].error);
+            at[i + 1] = at[i] + chunks[i].edges.size();
+            weighted += chunks[i].weights.size();
+        }
+        if (at[n] != E) throw std::invalid_argument("Edge count does not match the header");
+        if (weighted != 0 && weighted != E) throw std::invalid_argument("Only some edges have a weight");
+
+        EdgeList list;
+        list.V = static_cast<int>(V);
+        list.edges.resize(E);
+        list.weights.resize(weighted);
+        parallel::forRange(n, [&](size_t begin, size_t stop, unsigned) {
+            for (size_t i = begin; i < stop; ++i) {
+                std::copy(chunks[i].edges.begin(), chunks[i].edges.end(), list.edges.begin() + at[i]);
+                if (weighted != 0)
+                    std::copy(chunks[i].weights.begin(), chunks[i].weights.end(), list.weights.data() + at[i]);
+                chunks[i] = {};
+            }
+        }, 1, threads);
+        return list;
+    }
+
+    EdgeList readText(const std::string& path, unsigned threads) {
+        MappedFile file(path);
+        return parse(file.view(), threads);
+    }
+
+    CSRGraph build(const EdgeList& list, bool directed, unsigned threads) {
+        threads = parallel::threads(threads);
+        const int V = list.V;
+        const size_t m = list.edges.size();
+        const bool weighted = !list.weights.empty();
+        if (weighted && list.weights.size() != m)
+            throw std::invalid_argument("Weights and edges differ in length");
+
+        std::vector<std::atomic<size_t>> cursor(V + 1);
+        std::atomic<bool> outside{false};
+        parallel::forRange(m, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                const auto [v, w] = list.edges[i];
+                if (v < 0 || v >= V || w < 0 || w >= V) {
+                    outside.store(true, std::memory_order_relaxed);
+                    continue;
+                }
+                cursor[v].fetch_add(1, std::memory_order_relaxed);
+                if (!directed) cursor[w].fetch_add(1, std::memory_order_relaxed);
+            }
+        }, 1 << 16, threads);
+        if (outside) throw std::out_of_range("Edge endpoint is out of boundaries");
+
+        std::vector<size_t> offsets(V + 1, 0);
+        for (int v = 0; v < V; ++v) {
+            offsets[v + 1] = offsets[v] + cursor[v].load(std::memory_order_relaxed);
+            cursor[v].store(offsets[v], std::memory_order_relaxed);
+        }
+        std::vector<int> targets(offsets[V]);
+        std::vector<double> weights(weighted ? offsets[V] : 0);
+        parallel::forRange(m, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                const auto [v, w] = list.edges[i];
+                size_t at = cursor[v].fetch_add(1, std::memory_order_relaxed);
+                targets[at] = w;
+                if (weighted) weights[at] = list.weights[i];
+                if (directed) continue;
+                at = cursor[w].fetch_add(1, std::memory_order_relaxed);
+                targets[at] = v;
+                if (weighted) weights[at] = list.weights[i];
+            }
+        }, 1 << 16, threads);
+
+        parallel::forRange(V, [&](size_t begin, size_t end, unsigned) {
+            std::vector<std::pair<int, double>> scratch;
+            for (size_t v = begin; v < end; ++v) {
+                const size_t first = offsets[v], last = offsets[v + 1];
+                if (!weighted) {
+                    std::sort(targets.begin() + first, targets.begin() + last);
+                    continue;
+                }
+                scratch.clear();
+                for (size_t i = first; i < last; ++i) scratch.emplace_back(targets[i], weights[i]);
+                std::sort(scratch.begin(), scratch.end());
+                for (size_t i = first; i < last; ++i)
+                    std::tie(targets[i], weights[i]) = scratch[i - first];
+            }
+        }, 4096, threads);
+        return {std::move(offsets), std::move(targets), std::move(weights), directed};
+    }
+
+    void writeBinary(const CSRGraph& g, std::ostream& os) {
+        Header h{};
+        std::memcpy(h.magic, magic, sizeof magic);
+        h.version = version;
+        h.flags = (g.directed() ? directedFlag : 0) | (g.weighted() ? weightedFlag : 0);
+        h.V = static_cast<uint64_t>(g.V());
+        h.entries = g.targets().size();
+        const char zeros[8] = {};
+        const size_t targetBytes = h.entries * sizeof(int32_t);
+        os.write(reinterpret_cast<const char*>(&h), sizeof h);
+        os.write(reinterpret_cast<const char*>(g.offsets().data()), (h.V + 1) * sizeof(uint64_t));
+        os.write(reinterpret_cast<const char*>(g.targets().data()), static_cast<std::streamsize>(targetBytes));
+        os.write(zeros, static_cast<std::streamsize>(padded(targetBytes) - targetBytes));
+        if (g.weighted())
+            os.write(reinterpret_cast<const char*>(g.weights().data()), h.entries * sizeof(double));
+        if (!os) throw std::runtime_error("Cannot write the graph");
+    }
+
+    void writeBinary(const CSRGraph& g, const std::string& path) {
+        std::ofstream os(path, std::ios::binary);
+        if (!os) throw std::runtime_error("Cannot open " + path);
+        writeBinary(g, os);
+    }
+
+    CSRGraph readBinary(std::istream& is) {
+        Header h{};
+        if (!is.read(reinterpret_cast<char*>(&h), sizeof h))
+            throw std::invalid_argument("Not a binary CSR graph");
+        check(h);
+        std::vector<size_t> offsets;
+        std::vector<int> targets;
+        std::vector<double> weights;
+        const size_t targetBytes = h.entries * sizeof(int32_t);
+        char pad[8];
+        get(is, offsets, h.V + 1);
+        get(is, targets, h.entries);
+        is.read(pad, static_cast<std::streamsize>(padded(targetBytes) - targetBytes));
+        get(is, weights, h.flags & weightedFlag ? h.entries : 0);
+        if (!is) throw std::invalid_argument("Truncated binary CSR graph");
+        checkArrays(offsets.data(), targets.data(), static_cast<int>(h.V), h.entries);
+        return {std::move(offsets), std::move(targets), std::move(weights), (h.flags & directedFlag) != 0};
+    }
+
+    CSRGraph readBinary(const std::string& path) {
+        std::ifstream is(path, std::ios::binary);
+        if (!is) throw std::runtime_error("Cannot open " + path);
+        return readBinary(is);
+    }
+
+    MappedCSR::MappedCSR(const std::string& path)
+        : file_(path)
+    {
+        Header h{};
+        if (file_.size() < sizeof h) throw std::invalid_argument("Not a binary CSR graph");
+        std::memcpy(&h, file_.data(), sizeof h);
+        check(h);
+        const size_t targetBytes = h.entries * sizeof(int32_t);
+        const size_t weightBytes = h.flags & weightedFlag ? h.entries * sizeof(double) : 0;
+        const size_t offsetBytes = (h.V + 1) * sizeof(uint64_t);
+        if (file_.size() < sizeof h + offsetBytes + padded(targetBytes) + weightBytes)
+            throw std::invalid_argument("Truncated binary CSR graph");
+        const char* base = file_.data() + sizeof h;
+        V_ = static_cast<int>(h.V);
+        directed_ = (h.flags & directedFlag) != 0;
+        offsets_ = reinterpret_cast<const uint64_t*>(base);
+        targets_ = reinterpret_cast<const int32_t*>(base + offsetBytes);
+        weights_ = weightBytes ? reinterpret_cast<const double*>(base + offsetBytes + padded(targetBytes)) : nullptr;
+        checkArrays(offsets_, targets_, V_, h.entries);
+    }
+
+    int MappedCSR::V() const noexcept {
+        return V_;
+    }
+
+    size_t MappedCSR::E() const noexcept {
+        return directed_ ? offsets_[V_] : offsets_[V_] / 2;
+    }
+
+    bool MappedCSR::directed() const noexcept {
+        return directed_;
+    }
+
+    bool MappedCSR::weighted() const noexcept {
+        return weights_ != nullptr;
+    }
+
+    std::span<const int> MappedCSR::adj(int v) const {
+        return {targets_ + offsets_[v], targets_ + offsets_[v + 1]};
+    }
+
+    std::span<const double> MappedCSR::weights(int v) const {
+        if (!weights_) return {};
+        return {weights_ + offsets_[v], weights_ + offsets_[v + 1]};
+    }
+
+    int MappedCSR::degree(int v) const {
+        return static_cast<int>(offsets_[v + 1] - offsets_[v]);
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef ALGO_GRAPH_IO_H
+#define ALGO_GRAPH_IO_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <utility>
+#include <iosfwd>
+#include "csr.h"
+#include "../data_structures/mapped_file.h"
+
+/** Bulk graph I/O ********************************************************
+ * Text: the usual "V E" header followed by E lines "v w" or "v w weight". parse() cuts
+ * the text at line boundaries into one chunk per worker, every worker converts its lines
+ * with std::from_chars, and the chunks are stitched back together in order, so the
+ * result is exactly the file order whatever the thread count. Blank lines and lines
+ * starting with '#' or '%' are skipped.
+ *
+ * Binary (version 1, native byte order): a 32-byte header
+ *     char magic[8] = "ALGOCSR", uint32 version, uint32 flags (1 directed, 2 weighted),
+ *     uint64 V, uint64 entries
+ * followed by the CSR arrays: V+1 uint64 offsets, `entries` int32 targets padded to 8
+ * bytes, then `entries` doubles if weighted. Every array starts 8-byte aligned, so
+ * MappedCSR serves adj() straight out of the mapping without reading the file.
+ */
+namespace graph::io {
+    struct EdgeList {
+        int V = 0;
+        std::vector<std::pair<int, int>> edges;
+        std::vector<double> weights;    // one per edge, or empty if the text had none
+    };
+
+    [[nodiscard]]
+    EdgeList parse(std::string_view text, unsigned threads = 0);
+    [[nodiscard]]
+    EdgeList readText(const std::string& path, unsigned threads = 0);
+
+    // two passes: parallel degree count sizes every list exactly, then a parallel
+    // scatter; neighbours come out sorted so the result does not depend on the threads
+    [[nodiscard]]
+    CSRGraph build(const EdgeList& list, bool directed, unsigned threads = 0);
+
+    void writeBinary(const CSRGraph& g, std::ostream& os);
+    void writeBinary(const CSRGraph& g, const std::string& path);
+    [[nodiscard]]
+    CSRGraph readBinary(std::istream& is);
+    [[nodiscard]]
+    CSRGraph readBinary(const std::string& path);
+
+    using data_structures::MappedFile;
+
+    /** A binary CSR file used in place: nothing is copied, adj() reads the mapping.
+     * Opening checks the header and the array sizes and scans the offsets and targets
+     * once, as readBinary() does, so a corrupt file is rejected instead of read out of
+     * bounds; the weights are left to the first weights() that touches them.
+     */
+    class MappedCSR {
+    private:
+        MappedFile file_;
+        int V_;
+        bool directed_;
+        const uint64_t* offsets_;
+        const int32_t* targets_;
+        const double* weights_;
+
+    public:
+        explicit MappedCSR(const std::string& path);
+        [[nodiscard]]
+        int V() const noexcept;
+        [[nodiscard]]
+        size_t E() const noexcept;
+        [[nodiscard]]
+        bool directed() const noexcept;
+        [[nodiscard]]
+        bool weighted() const noexcept;
+        [[nodiscard]]
+        std::span<const int> adj(int v) const;
+        [[nodiscard]]
+        std::span<const double> weights(int v) const;
+        [[nodiscard]]
+        int degree(int v) const;
+    };
+}
+
+#endif //ALGO_GRAPH_IO_H
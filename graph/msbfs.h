@@ -0,0 +1,207 @@
+#ifndef ALGO_MSBFS_H
+#define ALGO_MSBFS_H
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include "concepts.h"
+#include "parallel.h"
+
+namespace graph {
+    /** Multi-source BFS (Then et al., "The More the Merrier") ********************************
+     * Up to Width searches share one pass over the graph: every vertex carries Width-bit
+     * seen/visit masks, bit i standing for source i, and a level ORs visit[v] into every
+     * neighbour's next mask, so one adjacency scan advances all searches that are at v.
+     * Searches from nearby sources overlap heavily, which is where the throughput comes
+     * from. Dense levels are a sequential sweep over all vertices, sparse ones only
+     * touch the frontier and its neighbours.
+     *
+     * Results are stored vertex-major (all sources of one vertex together): distTo() for
+     * every source and, if parents are asked for, the BFS tree of every source, with the
+     * same pathTo(v) order as BreadthFirstPaths (v..s). Memory is O(V * sources) ints.
+     * Width is a multiple of 64 up to 512; wider batches share more work but each level
+     * touches more mask words.
+     */
+    namespace detail {
+        template<size_t Width>
+        struct Lanes {
+            static constexpr size_t words = Width / 64;
+            std::array<uint64_t, words> bits{};
+
+            void set(size_t i) noexcept { bits[i / 64] |= uint64_t{1} << (i % 64); }
+            [[nodiscard]]
+            bool any() const noexcept {
+                for (uint64_t w : bits)
+                    if (w) return true;
+                return false;
+            }
+            Lanes& operator|=(const Lanes& o) noexcept {
+                for (size_t i = 0; i < words; ++i) bits[i] |= o.bits[i];
+                return *this;
+            }
+            // this & ~o
+            [[nodiscard]]
+            Lanes without(const Lanes& o) const noexcept {
+                Lanes r;
+                for (size_t i = 0; i < words; ++i) r.bits[i] = bits[i] & ~o.bits[i];
+                return r;
+            }
+            template<typename F>
+            void forEach(F&& f) const {
+                for (size_t i = 0; i < words; ++i)
+                    for (uint64_t w = bits[i]; w; w &= w - 1)
+                        f(i * 64 + std::countr_zero(w));
+            }
+        };
+    }
+
+    template<AdjacencyGraph G, size_t Width = 64>
+    class MultiSourceBFS {
+        static_assert(Width % 64 == 0 && Width >= 64 && Width <= 512, "Width is 64, 128, ... 512");
+    private:
+        std::vector<int> sources_;
+        int V_;
+        std::vector<int> distTo_;   // distTo_[v * sources + i], -1 if unreached
+        std::vector<int> edgeTo_;   // same layout, empty in distance-only mode
+
+    public:
+        static constexpr size_t width = Width;
+
+        MultiSourceBFS(const G& g, std::span<const int> sources, bool parents = false);
+        [[nodiscard]]
+        size_t sources() const noexcept;
+        [[nodiscard]]
+        int source(size_t i) const;
+        [[nodiscard]]
+        bool hasPathTo(size_t i, int v) const;
+        [[nodiscard]]
+        int distTo(size_t i, int v) const;
+        // needs parent tracking
+        [[nodiscard]]
+        std::vector<int> pathTo(size_t i, int v) const;
+
+    private:
+        [[nodiscard]]
+        size_t at(size_t i, int v) const;
+    };
+
+    template<AdjacencyGraph G, size_t Width>
+    MultiSourceBFS<G, Width>::MultiSourceBFS(const G& g, std::span<const int> sources, bool parents)
+            : sources_(sources.begin(), sources.end())
+            , V_(g.V())
+    {
+        using Lanes = detail::Lanes<Width>;
+        const size_t k = sources_.size();
+        if (k > Width) throw std::invalid_argument("More sources than the batch width");
+        distTo_.assign(static_cast<size_t>(V_) * k, -1);
+        if (parents) edgeTo_.assign(static_cast<size_t>(V_) * k, -1);
+
+        std::vector<Lanes> seen(V_), visit(V_), next(V_);
+        std::vector<int> frontier, touched;
+        for (size_t i = 0; i < k; ++i) {
+            const int s = sources_[i];
+            if (s < 0 || s >= V_) throw std::out_of_range("Source is out of boundaries");
+            if (!visit[s].any()) frontier.push_back(s);
+            seen[s].set(i);
+            visit[s].set(i);
+            distTo_[s * k + i] = 0;
+            if (parents) edgeTo_[s * k + i] = s;
+        }
+        auto expand = [&](int v, bool record) {
+            for (int w : g.adj(v)) {
+                if (parents)    // the first v to reach w this level is its parent
+                    visit[v].without(seen[w]).without(next[w]).forEach([&](size_t i) {
+                        edgeTo_[w * k + i] = v;
+                    });
+                if (record && !next[w].any()) touched.push_back(w);
+                next[w] |= visit[v];
+            }
+            visit[v] = Lanes{};
+        };
+        auto settle = [&](int w, int level) {
+            visit[w] = next[w].without(seen[w]);
+            next[w] = Lanes{};
+            if (!visit[w].any()) return;
+            frontier.push_back(w);
+            seen[w] |= visit[w];
+            visit[w].forEach([&](size_t i) { distTo_[w * k + i] = level; });
+        };
+        for (int level = 1; !frontier.empty(); ++level) {
+            // dense levels sweep all vertices in id order, sparse ones only their own
+            if (frontier.size() > static_cast<size_t>(V_) / 64) {
+                for (int v = 0; v < V_; ++v)
+                    if (visit[v].any()) expand(v, false);
+                frontier.clear();
+                for (int w = 0; w < V_; ++w) settle(w, level);
+            } else {
+                for (int v : frontier) expand(v, true);
+                frontier.clear();
+                for (int w : touched) settle(w, level);
+                touched.clear();
+            }
+        }
+    }
+
+    template<AdjacencyGraph G, size_t Width>
+    size_t MultiSourceBFS<G, Width>::at(size_t i, int v) const {
+        if (i >= sources_.size() || v < 0 || v >= V_) throw std::out_of_range("Index is out of boundaries");
+        return static_cast<size_t>(v) * sources_.size() + i;
+    }
+
+    template<AdjacencyGraph G, size_t Width>
+    size_t MultiSourceBFS<G, Width>::sources() const noexcept {
+        return sources_.size();
+    }
+
+    template<AdjacencyGraph G, size_t Width>
+    int MultiSourceBFS<G, Width>::source(size_t i) const {
+        return sources_.at(i);
+    }
+
+    template<AdjacencyGraph G, size_t Width>
+    bool MultiSourceBFS<G, Width>::hasPathTo(size_t i, int v) const {
+        return distTo_[at(i, v)] >= 0;
+    }
+
+    template<AdjacencyGraph G, size_t Width>
+    int MultiSourceBFS<G, Width>::distTo(size_t i, int v) const {
+        return distTo_[at(i, v)];
+    }
+
+    template<AdjacencyGraph G, size_t Width>
+    std::vector<int> MultiSourceBFS<G, Width>::pathTo(size_t i, int v) const {
+        if (edgeTo_.empty()) throw std::logic_error("Parents were not tracked");
+        if (!hasPathTo(i, v)) return {};
+        std::vector<int> path;
+        const int s = sources_[i];
+        for (int x = v; x != s; x = edgeTo_[at(i, x)])
+            path.push_back(x);
+        path.push_back(s);
+        return path;
+    }
+
+    /** Batch API: any number of sources, cut into batches of Width that run on `threads`
+     * threads at once. onBatch(batch, first) gets every finished batch with the index of
+     * its first source in `sources`; it is called from the worker threads, concurrently.
+     */
+    template<size_t Width = 64, AdjacencyGraph G, typename F>
+    void multiSourceBFS(const G& g, std::span<const int> sources, F&& onBatch,
+                        bool parents = false, unsigned threads = 0) {
+        for (int s : sources)
+            if (s < 0 || s >= g.V()) throw std::out_of_range("Source is out of boundaries");
+        const size_t batches = (sources.size() + Width - 1) / Width;
+        parallel::forRange(batches, [&](size_t begin, size_t end, unsigned) {
+            for (size_t b = begin; b < end; ++b) {
+                const size_t first = b * Width;
+                const MultiSourceBFS<G, Width> batch(g, sources.subspan(first, std::min(Width, sources.size() - first)),
+                                                     parents);
+                onBatch(batch, first);
+            }
+        }, 1, threads);
+    }
+}
+
+#endif //ALGO_MSBFS_H
@@ -0,0 +1,138 @@
+#include "mst.h"
+#include <atomic>
+#include <random>
+#include <algorithm>
+#include "parallel.h"
+
+namespace graph {
+    BoruvkaMST::BoruvkaMST(const EdgeWeightedGraph& g, unsigned threads)
+            : mst_{}
+            , weight_{0}
+    {
+        threads = parallel::threads(threads);
+        const int V = g.V();
+        std::vector<Edge> edges = g.edges(), aux(edges.size());
+        ConcurrentUnionFind uf(V);
+        std::vector<std::atomic<long long>> best(V);
+        std::vector<std::vector<Edge>> local(threads);
+        size_t n = edges.size();
+        auto lighter = [&edges](long long i, long long j) {
+            return j < 0 || edges[i].weight() < edges[j].weight()
+                || (edges[i].weight() == edges[j].weight() && i < j);
+        };
+        while (true) {
+            // parent() is the root here: the forest is compressed and nothing unions
+            n = parallel::partition(edges.data(), n, aux.data(), [&uf](const Edge& e) {
+                const int v = e.either();
+                return uf.parent(v) != uf.parent(e.other(v));
+            }, threads);
+            edges.swap(aux);
+            if (n == 0) break;
+
+            parallel::forRange(V, [&best](size_t begin, size_t end, unsigned) {
+                for (size_t v = begin; v < end; ++v)
+                    best[v].store(-1, std::memory_order_relaxed);
+            }, 4096, threads);
+            parallel::forRange(n, [&](size_t begin, size_t end, unsigned) {
+                for (size_t i = begin; i < end; ++i) {
+                    const int v = edges[i].either();
+                    for (int c : {uf.parent(v), uf.parent(edges[i].other(v))}) {
+                        long long current = best[c].load(std::memory_order_relaxed);
+                        while (lighter(static_cast<long long>(i), current)
+                               && !best[c].compare_exchange_weak(current, static_cast<long long>(i),
+                                                                 std::memory_order_relaxed));
+                    }
+                }
+            }, 4096, threads);
+            parallel::forRange(V, [&](size_t begin, size_t end, unsigned tid) {
+                for (size_t c = begin; c < end; ++c) {
+                    const long long i = best[c].load(std::memory_order_relaxed);
+                    if (i < 0) continue;
+                    const int v = edges[i].either();
+                    if (uf.Union(v, edges[i].other(v)))
+                        local[tid].push_back(edges[i]);
+                }
+            }, 4096, threads);
+            for (auto& l : local) {
+                for (const auto& e : l) weight_ += e.weight();
+                mst_.insert(mst_.end(), l.begin(), l.end());
+                l.clear();
+            }
+            parallel::forRange(V, [&uf](size_t begin, size_t end, unsigned) {
+                uf.compress(begin, end);
+            }, 4096, threads);
+        }
+    }
+
+    const std::vector<Edge>& BoruvkaMST::edges() const noexcept {
+        return mst_;
+    }
+
+    double BoruvkaMST::weight() const noexcept {
+        return weight_;
+    }
+
+    FilterKruskalMST::FilterKruskalMST(const EdgeWeightedGraph& g, unsigned threads)
+            : mst_{}
+            , weight_{0}
+            , target_(g.V() > 0 ? g.V() - 1 : 0)
+            , threads_(parallel::threads(threads))
+    {
+        std::vector<Edge> edges = g.edges(), aux(edges.size());
+        ConcurrentUnionFind uf(g.V());
+        mst_.reserve(target_);
+        filterKruskal(edges.data(), aux.data(), edges.size(), uf);
+    }
+
+    // e[0, n) holds the edges, aux[0, n) is scratch; the two swap roles on the way down
+    void FilterKruskalMST::filterKruskal(Edge* e, Edge* aux, size_t n, ConcurrentUnionFind& uf) {
+        if (n == 0 || mst_.size() == target_) return;
+        if (n <= baseCase) {
+            kruskal(e, n, uf);
+            return;
+        }
+        std::mt19937_64 gen(n);
+        std::uniform_int_distribution<size_t> pick(0, n - 1);
+        std::vector<double> sample(63);
+        for (auto& w : sample) w = e[pick(gen)].weight();
+        std::nth_element(sample.begin(), sample.begin() + sample.size() / 2, sample.end());
+        const double pivot = sample[sample.size() / 2];
+
+        size_t light = parallel::partition(e, n, aux, [pivot](const Edge& x) {
+            return x.weight() <= pivot;
+        }, threads_);
+        if (light == n)
+            light = parallel::partition(e, n, aux, [pivot](const Edge& x) {
+                return x.weight() < pivot;
+            }, threads_);
+        if (light == 0) {   // every weight equals the pivot
+            kruskal(e, n, uf);
+            return;
+        }
+        filterKruskal(aux, e, light, uf);
+        if (mst_.size() == target_) return;
+        const size_t heavy = parallel::partition(aux + light, n - light, e, [&uf](const Edge& x) {
+            const int v = x.either();
+            return uf.find(v) != uf.find(x.other(v));
+        }, threads_);
+        filterKruskal(e, aux, heavy, uf);
+    }
+
+    void FilterKruskalMST::kruskal(Edge* e, size_t n, ConcurrentUnionFind& uf) {
+        std::sort(e, e + n, [](const Edge& a, const Edge& b) { return a.weight() < b.weight(); });
+        for (size_t i = 0; i < n && mst_.size() < target_; ++i) {
+            const int v = e[i].either();
+            if (!uf.Union(v, e[i].other(v))) continue;
+            mst_.push_back(e[i]);
+            weight_ += e[i].weight();
+        }
+    }
+
+    const std::vector<Edge>& FilterKruskalMST::edges() const noexcept {
+        return mst_;
+    }
+
+    double FilterKruskalMST::weight() const noexcept {
+        return weight_;
+    }
+}
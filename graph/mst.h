@@ -0,0 +1,59 @@
+#ifndef ALGO_MST_H
+#define ALGO_MST_H
+#include <vector>
+#include "graph.h"
+#include "../union_find/union_find.h"
+
+namespace graph {
+    /** Parallel Borůvka MST ********************************************************
+     * Every round each component picks its lightest outgoing edge - all edges scanned in
+     * parallel, the per-component minimum kept with a CAS - and all picks are hooked at
+     * once on a ConcurrentUnionFind. Ties are broken by edge position, so the picks of a
+     * round never close a cycle and a pick shared by both ends is only added once. At
+     * least half the components disappear per round, and edges inside a component are
+     * dropped with a parallel partition after each one, so the edge list shrinks too.
+     * Gives a minimum spanning forest on disconnected graphs.
+     */
+    class BoruvkaMST {
+    private:
+        std::vector<Edge> mst_;
+        double weight_;
+    public:
+        explicit BoruvkaMST(const EdgeWeightedGraph& g, unsigned threads = 0);
+        [[nodiscard]]
+        const std::vector<Edge>& edges() const noexcept;
+        [[nodiscard]]
+        double weight() const noexcept;
+    };
+
+    /** Filter-Kruskal (Osipov, Sanders, Singler) ********************************************************
+     * Kruskal that sorts only what it needs: edges are split around a sampled median
+     * weight, the light half is solved recursively, and the heavy half is then filtered
+     * down to the edges still joining two components before it is recursed into. On
+     * graphs much denser than their MST most heavy edges die in a filter without ever
+     * being sorted. Splits and filters are parallel partitions; small pieces fall back to
+     * sort + union.
+     */
+    class FilterKruskalMST {
+    private:
+        std::vector<Edge> mst_;
+        double weight_;
+        size_t target_;
+        unsigned threads_;
+
+        static constexpr size_t baseCase = 4096;
+
+    public:
+        explicit FilterKruskalMST(const EdgeWeightedGraph& g, unsigned threads = 0);
+        [[nodiscard]]
+        const std::vector<Edge>& edges() const noexcept;
+        [[nodiscard]]
+        double weight() const noexcept;
+
+    private:
+        void filterKruskal(Edge* e, Edge* aux, size_t n, ConcurrentUnionFind& uf);
+        void kruskal(Edge* e, size_t n, ConcurrentUnionFind& uf);
+    };
+}
+
+#endif //ALGO_MST_H
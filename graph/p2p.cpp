@@ -0,0 +1,292 @@
+#include "p2p.h"
+#include <cstring>
+#include <climits>
+#include <istream>
+#include <ostream>
+#include "parallel.h"
+
+namespace graph {
+    namespace {
+        constexpr double infinity = std::numeric_limits<double>::infinity();
+
+        void checkWeights(const EdgeWeightedDigraph& g) {
+            for (const auto& e : g.edges())
+                if (e.weight() < 0)
+                    throw std::invalid_argument("Dijkstra does not accept negative weights");
+        }
+
+        void checkEnds(const EdgeWeightedDigraph& g, int s, int t) {
+            if (s < 0 || s >= g.V() || t < 0 || t >= g.V())
+                throw std::out_of_range("Vertex is out of boundaries");
+        }
+
+        // the next query's stamp; all marks are cleared when it wraps around
+        uint32_t nextStamp(uint32_t stamp, std::initializer_list<std::vector<uint32_t>*> seen) {
+            if (++stamp != 0) return stamp;
+            for (auto* s : seen) std::fill(s->begin(), s->end(), 0);
+            return 1;
+        }
+    }
+
+    BidirectionalDijkstra::BidirectionalDijkstra(const EdgeWeightedDigraph& g)
+        : g_(g)
+        , reverse_(g.reverse())
+        , pq_{data_structures::IndexMinPriorityQueue<double>(g.V()),
+              data_structures::IndexMinPriorityQueue<double>(g.V())}
+    {
+        checkWeights(g);
+        for (int side = 0; side < 2; ++side) {
+            seen_[side].assign(g.V(), 0);
+            distTo_[side].resize(g.V());
+            edgeTo_[side].resize(g.V());
+        }
+    }
+
+    double BidirectionalDijkstra::distance(int s, int t) {
+        return search(s, t);
+    }
+
+    std::vector<DirectedEdge> BidirectionalDijkstra::path(int s, int t) {
+        if (search(s, t) == infinity) return {};
+        std::vector<DirectedEdge> path;
+        for (int x = meet_; x != s; x = edgeTo_[0][x].from())
+            path.push_back(edgeTo_[0][x]);
+        std::reverse(path.begin(), path.end());
+        for (int x = meet_; x != t; x = edgeTo_[1][x].to())
+            path.push_back(edgeTo_[1][x]);
+        return path;
+    }
+
+    size_t BidirectionalDijkstra::settled() const noexcept {
+        return settled_;
+    }
+
+    double BidirectionalDijkstra::search(int s, int t) {
+        checkEnds(g_, s, t);
+        stamp_ = nextStamp(stamp_, {&seen_[0], &seen_[1]});
+        settled_ = 0;
+        const int ends[2] = {s, t};
+        for (int side = 0; side < 2; ++side) {
+            pq_[side].clear();
+            seen_[side][ends[side]] = stamp_;
+            distTo_[side][ends[side]] = 0;
+            pq_[side].insert(ends[side], 0);
+        }
+        meet_ = s;
+        if (s == t) return 0;
+
+        double mu = infinity;
+        while (!pq_[0].empty() && !pq_[1].empty()) {
+            if (pq_[0].minKey() + pq_[1].minKey() >= mu) break;
+            const int side = pq_[0].size() <= pq_[1].size() ? 0 : 1;
+            const auto& graph = side == 0 ? g_ : reverse_;
+            auto& seen = seen_[side];
+            auto& dist = distTo_[side];
+            const int v = pq_[side].pop();
+            ++settled_;
+            for (const auto& e : graph.adj(v)) {
+                const int w = e.to();
+                const double d = dist[v] + e.weight();
+                if (seen[w] != stamp_ || d < dist[w]) {
+                    dist[w] = d;
+                    edgeTo_[side][w] = side == 0 ? e : DirectedEdge(w, v, e.weight());
+                    if (seen[w] != stamp_) {
+                        seen[w] = stamp_;
+                        pq_[side].insert(w, d);
+                    } else if (pq_[side].contains(w)) {
+                        pq_[side].decreaseKey(w, d);
+                    }
+                }
+                if (seen_[1 - side][w] == stamp_ && distTo_[0][w] + distTo_[1][w] < mu) {
+                    mu = distTo_[0][w] + distTo_[1][w];
+                    meet_ = w;
+                }
+            }
+        }
+        return mu;
+    }
+
+    Landmarks::Landmarks(const EdgeWeightedDigraph& g, int count, unsigned threads)
+        : V_(g.V())
+    {
+        if (count <= 0 || count > V_) throw std::invalid_argument("Landmark count out of range");
+        checkWeights(g);
+        const size_t k = count;
+        from_.resize(static_cast<size_t>(V_) * k);
+        to_.resize(static_cast<size_t>(V_) * k);
+
+        // farthest selection; each search from a landmark fills its column of from_
+        std::vector<double> nearest(V_, infinity);
+        int next = 0;
+        {
+            const DijkstraSP<> first(g, 0);
+            for (int v = 0; v < V_; ++v)
+                if (first.distTo(v) > first.distTo(next)) next = v;
+        }
+        for (size_t i = 0; i < k; ++i) {
+            landmarks_.push_back(next);
+            const DijkstraSP<> sp(g, next);
+            for (int v = 0; v < V_; ++v) {
+                from_[v * k + i] = sp.distTo(v);
+                nearest[v] = std::min(nearest[v], sp.distTo(v));
+            }
+            nearest[next] = -1;     // never picked twice, even if it reaches nothing
+            next = static_cast<int>(std::max_element(nearest.begin(), nearest.end()) - nearest.begin());
+        }
+
+        const EdgeWeightedDigraph reverse = g.reverse();
+        parallel::forRange(k, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                const DijkstraSP<> sp(reverse, landmarks_[i]);
+                for (int v = 0; v < V_; ++v)
+                    to_[v * k + i] = sp.distTo(v);
+            }
+        }, 1, threads);
+    }
+
+    int Landmarks::V() const noexcept {
+        return V_;
+    }
+
+    int Landmarks::count() const noexcept {
+        return static_cast<int>(landmarks_.size());
+    }
+
+    int Landmarks::landmark(int i) const {
+        return landmarks_.at(i);
+    }
+
+    // a term with an infinite subtrahend says nothing (NaN or -inf) and std::max keeps
+    // the running bound; an infinite minuend means t cannot be reached from v at all
+    double Landmarks::lowerBound(int v, int t) const {
+        if (v < 0 || v >= V_ || t < 0 || t >= V_) throw std::out_of_range("Vertex is out of boundaries");
+        const size_t k = landmarks_.size();
+        const double* fromV = &from_[v * k];
+        const double* fromT = &from_[t * k];
+        const double* toV = &to_[v * k];
+        const double* toT = &to_[t * k];
+        double bound = 0;
+        for (size_t i = 0; i < k; ++i) {
+            bound = std::max(bound, fromT[i] - fromV[i]);
+            bound = std::max(bound, toV[i] - toT[i]);
+        }
+        return bound;
+    }
+
+    namespace {
+        constexpr char magic[8] = {'A', 'L', 'G', 'O', 'A', 'L', 'T', '\0'};
+        constexpr uint32_t version = 1;
+
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t count;
+            uint64_t V;
+        };
+        static_assert(sizeof(Header) == 24);
+    }
+
+    // header, landmark ids padded to 8 bytes, then both tables as they sit in memory
+    void Landmarks::save(std::ostream& out) const {
+        Header h{};
+        std::memcpy(h.magic, magic, sizeof magic);
+        h.version = version;
+        h.count = static_cast<uint32_t>(landmarks_.size());
+        h.V = static_cast<uint64_t>(V_);
+        const char zeros[8] = {};
+        out.write(reinterpret_cast<const char*>(&h), sizeof h);
+        out.write(reinterpret_cast<const char*>(landmarks_.data()),
+                  static_cast<std::streamsize>(landmarks_.size() * sizeof(int32_t)));
+        out.write(zeros, static_cast<std::streamsize>(h.count % 2 * sizeof(int32_t)));
+        out.write(reinterpret_cast<const char*>(from_.data()), static_cast<std::streamsize>(from_.size() * sizeof(double)));
+        out.write(reinterpret_cast<const char*>(to_.data()), static_cast<std::streamsize>(to_.size() * sizeof(double)));
+        if (!out) throw std::runtime_error("Cannot write the landmarks");
+    }
+
+    Landmarks Landmarks::load(std::istream& in) {
+        Header h{};
+        if (!in.read(reinterpret_cast<char*>(&h), sizeof h) || std::memcmp(h.magic, magic, sizeof magic) != 0)
+            throw std::invalid_argument("Not a landmark table");
+        if (h.version != version)
+            throw std::invalid_argument("Unsupported landmark table version or byte order");
+        if (h.V > static_cast<uint64_t>(INT_MAX) || h.count == 0 || h.count > h.V)
+            throw std::invalid_argument("Landmark table sizes out of range");
+        Landmarks l;
+        l.V_ = static_cast<int>(h.V);
+        l.landmarks_.resize(h.count);
+        l.from_.resize(h.V * h.count);
+        l.to_.resize(h.V * h.count);
+        char pad[8];
+        in.read(reinterpret_cast<char*>(l.landmarks_.data()), static_cast<std::streamsize>(h.count * sizeof(int32_t)));
+        in.read(pad, static_cast<std::streamsize>(h.count % 2 * sizeof(int32_t)));
+        in.read(reinterpret_cast<char*>(l.from_.data()), static_cast<std::streamsize>(l.from_.size() * sizeof(double)));
+        in.read(reinterpret_cast<char*>(l.to_.data()), static_cast<std::streamsize>(l.to_.size() * sizeof(double)));
+        if (!in) throw std::invalid_argument("Truncated landmark table");
+        for (int x : l.landmarks_)
+            if (x < 0 || x >= l.V_) throw std::invalid_argument("Landmark out of range");
+        return l;
+    }
+
+    AStarSearch::AStarSearch(const EdgeWeightedDigraph& g, const Landmarks& landmarks)
+        : g_(g)
+        , landmarks_(landmarks)
+        , pq_(g.V())
+        , seen_(g.V(), 0)
+        , distTo_(g.V())
+        , bound_(g.V())
+        , edgeTo_(g.V())
+    {
+        if (landmarks.V() != g.V()) throw std::invalid_argument("Landmarks do not match the graph");
+        checkWeights(g);
+    }
+
+    double AStarSearch::distance(int s, int t) {
+        return search(s, t);
+    }
+
+    std::vector<DirectedEdge> AStarSearch::path(int s, int t) {
+        if (search(s, t) == infinity) return {};
+        std::vector<DirectedEdge> path;
+        for (int x = t; x != s; x = edgeTo_[x].from())
+            path.push_back(edgeTo_[x]);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    size_t AStarSearch::settled() const noexcept {
+        return settled_;
+    }
+
+    // keys are distTo + bound; the bound of a vertex is computed once per query
+    double AStarSearch::search(int s, int t) {
+        checkEnds(g_, s, t);
+        stamp_ = nextStamp(stamp_, {&seen_});
+        settled_ = 0;
+        pq_.clear();
+        seen_[s] = stamp_;
+        distTo_[s] = 0;
+        bound_[s] = landmarks_.lowerBound(s, t);
+        if (bound_[s] == infinity) return infinity;
+        pq_.insert(s, bound_[s]);
+        while (!pq_.empty()) {
+            const int v = pq_.pop();
+            ++settled_;
+            if (v == t) return distTo_[t];
+            for (const auto& e : g_.adj(v)) {
+                const int w = e.to();
+                const double d = distTo_[v] + e.weight();
+                if (seen_[w] != stamp_) {
+                    seen_[w] = stamp_;
+                    distTo_[w] = infinity;
+                    bound_[w] = landmarks_.lowerBound(w, t);
+                }
+                if (!(d < distTo_[w]) || bound_[w] == infinity) continue;
+                distTo_[w] = d;
+                edgeTo_[w] = e;
+                if (pq_.contains(w)) pq_.decreaseKey(w, d + bound_[w]);
+                else pq_.insert(w, d + bound_[w]);
+            }
+        }
+        return infinity;
+    }
+}
@@ -0,0 +1,231 @@
+#ifndef ALGO_P2P_H
+#define ALGO_P2P_H
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <iosfwd>
+#include <algorithm>
+#include <stdexcept>
+#include "graph.h"
+#include "concepts.h"
+
+namespace graph {
+    /** Point-to-point shortest paths ********************************************************
+     * Single-source searches answer s -> t by exploring everything closer to s than t is.
+     * The searches here stop as soon as the answer is known: bidirectional ones grow a
+     * ball around s and one around t until they meet, A* bends the search towards t with
+     * a lower bound on the remaining distance. All of them are query objects: build once
+     * per graph, then ask any number of (s, t) questions; per-query scratch is reset with
+     * a stamp, so a query never pays O(V) for what it did not touch. A query object is
+     * not thread safe, use one per thread.
+     */
+
+    // Unweighted: always expands the smaller frontier by one whole level. The one-graph
+    // constructor assumes adj() is symmetric; for a digraph pass its reverse() as well.
+    template<AdjacencyGraph G>
+    class BidirectionalBFS {
+    private:
+        const G& g_;
+        const G& reverse_;
+        std::vector<uint32_t> seen_[2];     // side 0 searches from s over g, 1 from t over reverse
+        std::vector<int> distTo_[2];
+        std::vector<int> edgeTo_[2];
+        std::vector<int> frontier_[2], next_;
+        uint32_t stamp_ = 0;
+        int meet_ = -1;
+
+    public:
+        explicit BidirectionalBFS(const G& g);
+        BidirectionalBFS(const G& g, const G& reverse);
+        // number of edges on a shortest s -> t path, -1 if there is none
+        [[nodiscard]]
+        int distance(int s, int t);
+        // s, ..., t; empty if there is no path
+        [[nodiscard]]
+        std::vector<int> path(int s, int t);
+
+    private:
+        int search(int s, int t);
+        void start(int side, int v);
+    };
+
+    template<AdjacencyGraph G>
+    BidirectionalBFS<G>::BidirectionalBFS(const G& g)
+            : BidirectionalBFS(g, g)
+    {}
+
+    template<AdjacencyGraph G>
+    BidirectionalBFS<G>::BidirectionalBFS(const G& g, const G& reverse)
+            : g_(g)
+            , reverse_(reverse)
+    {
+        if (g.V() != reverse.V()) throw std::invalid_argument("Reverse graph does not match");
+        for (int side = 0; side < 2; ++side) {
+            seen_[side].assign(g.V(), 0);
+            distTo_[side].resize(g.V());
+            edgeTo_[side].resize(g.V());
+        }
+    }
+
+    template<AdjacencyGraph G>
+    int BidirectionalBFS<G>::distance(int s, int t) {
+        return search(s, t);
+    }
+
+    template<AdjacencyGraph G>
+    std::vector<int> BidirectionalBFS<G>::path(int s, int t) {
+        if (search(s, t) < 0) return {};
+        std::vector<int> path;
+        for (int x = meet_; x != s; x = edgeTo_[0][x])
+            path.push_back(x);
+        path.push_back(s);
+        std::reverse(path.begin(), path.end());
+        for (int x = meet_; x != t;) {
+            x = edgeTo_[1][x];
+            path.push_back(x);
+        }
+        return path;
+    }
+
+    template<AdjacencyGraph G>
+    void BidirectionalBFS<G>::start(int side, int v) {
+        seen_[side][v] = stamp_;
+        distTo_[side][v] = 0;
+        edgeTo_[side][v] = v;
+        frontier_[side].assign(1, v);
+    }
+
+    // Once the two balls touch, every meeting found while finishing that level has
+    // length at most (levels so far), and a shortest path must cross the level that was
+    // just added, so the best meeting of the level is the answer.
+    template<AdjacencyGraph G>
+    int BidirectionalBFS<G>::search(int s, int t) {
+        const int V = g_.V();
+        if (s < 0 || s >= V || t < 0 || t >= V) throw std::out_of_range("Vertex is out of boundaries");
+        if (++stamp_ == 0) {
+            for (auto& seen : seen_) std::fill(seen.begin(), seen.end(), 0);
+            stamp_ = 1;
+        }
+        start(0, s);
+        start(1, t);
+        meet_ = s;
+        if (s == t) return 0;
+
+        int best = std::numeric_limits<int>::max();
+        while (!frontier_[0].empty() && !frontier_[1].empty()) {
+            const int side = frontier_[0].size() <= frontier_[1].size() ? 0 : 1;
+            const G& graph = side == 0 ? g_ : reverse_;
+            auto& seen = seen_[side];
+            const auto& other = seen_[1 - side];
+            next_.clear();
+            for (int v : frontier_[side])
+                for (int w : graph.adj(v)) {
+                    if (seen[w] == stamp_) continue;
+                    seen[w] = stamp_;
+                    distTo_[side][w] = distTo_[side][v] + 1;
+                    edgeTo_[side][w] = v;
+                    next_.push_back(w);
+                    if (other[w] == stamp_ && distTo_[0][w] + distTo_[1][w] < best) {
+                        best = distTo_[0][w] + distTo_[1][w];
+                        meet_ = w;
+                    }
+                }
+            std::swap(frontier_[side], next_);
+            if (best != std::numeric_limits<int>::max()) return best;
+        }
+        return -1;
+    }
+
+    /** Weighted searches over an EdgeWeightedDigraph with non-negative weights. Distances
+     * are +infinity when t is unreachable; paths are the edges s -> t in order, like
+     * DijkstraSP::pathTo, and empty for s == t or no path.
+     */
+
+    // Dijkstra from both ends, the backward one over a reverse copy it owns. mu is the
+    // best s -> t length seen where the searches touch; stop when the two queue minima
+    // add up to at least mu, no unsettled path can be shorter.
+    class BidirectionalDijkstra {
+    private:
+        const EdgeWeightedDigraph& g_;
+        EdgeWeightedDigraph reverse_;
+        data_structures::IndexMinPriorityQueue<double> pq_[2];
+        std::vector<uint32_t> seen_[2];
+        std::vector<double> distTo_[2];
+        std::vector<DirectedEdge> edgeTo_[2];   // both in g's orientation: into v, out of v
+        uint32_t stamp_ = 0;
+        int meet_ = -1;
+        size_t settled_ = 0;
+
+    public:
+        explicit BidirectionalDijkstra(const EdgeWeightedDigraph& g);
+        [[nodiscard]]
+        double distance(int s, int t);
+        [[nodiscard]]
+        std::vector<DirectedEdge> path(int s, int t);
+        // vertices taken off the queues by the last query
+        [[nodiscard]]
+        size_t settled() const noexcept;
+
+    private:
+        double search(int s, int t);
+    };
+
+    // ALT landmarks (Goldberg, Harrelson): exact distances to and from a few vertices
+    // far apart bound d(v, t) from below through the triangle inequality,
+    //   d(v, t) >= d(L, t) - d(L, v)   and   d(v, t) >= d(v, L) - d(t, L).
+    // Landmarks are chosen greedily, each the vertex farthest from those already taken
+    // (unreached vertices first); the reverse-graph searches run in parallel. Tables
+    // take 2 * V * count doubles and can be saved and loaded again instead of rebuilt.
+    class Landmarks {
+    private:
+        int V_ = 0;
+        std::vector<int> landmarks_;
+        std::vector<double> from_;      // from_[v * count + i] = d(landmark i, v)
+        std::vector<double> to_;        // to_[v * count + i] = d(v, landmark i)
+
+        Landmarks() = default;
+    public:
+        Landmarks(const EdgeWeightedDigraph& g, int count, unsigned threads = 0);
+        [[nodiscard]]
+        int V() const noexcept;
+        [[nodiscard]]
+        int count() const noexcept;
+        [[nodiscard]]
+        int landmark(int i) const;
+        // admissible and consistent: never above d(v, t), +infinity if t is unreachable from v
+        [[nodiscard]]
+        double lowerBound(int v, int t) const;
+
+        void save(std::ostream& out) const;
+        static Landmarks load(std::istream& in);
+    };
+
+    // A* towards t with the landmark bound as potential; with a consistent bound every
+    // vertex is settled once, as in Dijkstra, but far fewer of them.
+    class AStarSearch {
+    private:
+        const EdgeWeightedDigraph& g_;
+        const Landmarks& landmarks_;
+        data_structures::IndexMinPriorityQueue<double> pq_;
+        std::vector<uint32_t> seen_;
+        std::vector<double> distTo_;
+        std::vector<double> bound_;
+        std::vector<DirectedEdge> edgeTo_;
+        uint32_t stamp_ = 0;
+        size_t settled_ = 0;
+
+    public:
+        AStarSearch(const EdgeWeightedDigraph& g, const Landmarks& landmarks);
+        [[nodiscard]]
+        double distance(int s, int t);
+        [[nodiscard]]
+        std::vector<DirectedEdge> path(int s, int t);
+        [[nodiscard]]
+        size_t settled() const noexcept;
+
+    private:
+        double search(int s, int t);
+    };
+}
+
+#endif //ALGO_P2P_H
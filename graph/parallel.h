@@ -0,0 +1,153 @@
+#ifndef ALGO_PARALLEL_H
+#define ALGO_PARALLEL_H
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+
+/** Minimal fork-join helpers for the parallel graph algorithms ********************************
+ * Plain std::thread, no pool: every call forks its workers and joins them before
+ * returning, so a call doubles as a barrier between algorithm phases.
+ */
+namespace graph::parallel {
+    inline unsigned threads(unsigned requested = 0) noexcept {
+        if (requested) return requested;
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    /** Runs f(tid) on nthreads threads, the calling thread being tid 0. */
+    template<typename F>
+    void forEachThread(unsigned nthreads, F&& f) {
+        nthreads = threads(nthreads);
+        std::vector<std::thread> pool;
+        pool.reserve(nthreads - 1);
+        for (unsigned t = 1; t < nthreads; ++t)
+            pool.emplace_back([&f, t] { f(t); });
+        f(0u);
+        for (auto& th : pool) th.join();
+    }
+
+    /** Splits [0, n) into chunks of `grain` handed out dynamically, calling
+     * f(begin, end, tid) for each. Dynamic hand-out keeps skewed-degree work balanced.
+     */
+    template<typename F>
+    void forRange(size_t n, F&& f, size_t grain = 1024, unsigned nthreads = 0) {
+        if (n == 0) return;
+        nthreads = std::min<size_t>(threads(nthreads), (n + grain - 1) / grain);
+        if (nthreads <= 1) {
+            f(size_t{0}, n, 0u);
+            return;
+        }
+        std::atomic<size_t> next{0};
+        forEachThread(nthreads, [&](unsigned tid) {
+            for (size_t begin; (begin = next.fetch_add(grain, std::memory_order_relaxed)) < n;)
+                f(begin, std::min(n, begin + grain), tid);
+        });
+    }
+
+    /** forRange over the vertices of a CSR offsets array (V + 1 entries), cut so that every
+     * chunk holds about `grain` edges, a vertex counting as one edge more: a hub gets a
+     * chunk to itself and a long run of leaves shares one. offsets[v] + v grows strictly,
+     * so each chunk finds its first vertex by binary search and nothing is precomputed.
+     */
+    template<typename F>
+    void forEdgeBalanced(const std::vector<size_t>& offsets, F&& f, size_t grain = 4096, unsigned nthreads = 0) {
+        if (offsets.size() < 2) return;
+        const size_t V = offsets.size() - 1;
+        const auto first = [&](size_t cost) {
+            size_t lo = 0, hi = V;
+            while (lo < hi) {
+                const size_t mid = lo + (hi - lo) / 2;
+                if (offsets[mid] + mid < cost) lo = mid + 1;
+                else hi = mid;
+            }
+            return lo;
+        };
+        forRange((offsets[V] + V + grain - 1) / grain, [&](size_t begin, size_t end, unsigned tid) {
+            for (size_t c = begin; c < end; ++c)
+                if (const size_t lo = first(c * grain), hi = first((c + 1) * grain); lo < hi) f(lo, hi, tid);
+        }, 1, nthreads);
+    }
+
+    /** Stable partition of in[0, n) into out: the elements satisfying pred first, then the
+     * rest, both in their original order. Every chunk counts its hits, a prefix sum hands
+     * each chunk its two output offsets and the chunks then scatter independently, so
+     * pred is evaluated twice per element and must give the same answer both times.
+     * Returns the number of hits.
+     */
+    template<typename T, typename P>
+    size_t partition(const T* in, size_t n, T* out, P&& pred, unsigned nthreads = 0) {
+        nthreads = threads(nthreads);
+        const size_t chunk = std::max<size_t>(4096, (n + 4 * nthreads - 1) / (4 * nthreads));
+        const size_t chunks = (n + chunk - 1) / chunk;
+        std::vector<size_t> hits(chunks + 1, 0);
+        forRange(chunks, [&](size_t begin, size_t end, unsigned) {
+            for (size_t c = begin; c < end; ++c)
+                hits[c + 1] = std::count_if(in + c * chunk, in + std::min(n, (c + 1) * chunk), pred);
+        }, 1, nthreads);
+        for (size_t c = 0; c < chunks; ++c) hits[c + 1] += hits[c];
+        const size_t total = hits[chunks];
+        forRange(chunks, [&](size_t begin, size_t end, unsigned) {
+            for (size_t c = begin; c < end; ++c) {
+                T* yes = out + hits[c];
+                T* no = out + total + c * chunk - hits[c];
+                for (size_t i = c * chunk; i < std::min(n, (c + 1) * chunk); ++i)
+                    *(pred(in[i]) ? yes++ : no++) = in[i];
+            }
+        }, 1, nthreads);
+        return total;
+    }
+
+    /** Fixed-size bitmap whose bits can be set concurrently. */
+    class AtomicBitmap {
+    private:
+        size_t size_;
+        std::unique_ptr<std::atomic<uint64_t>[]> words_;
+
+    public:
+        explicit AtomicBitmap(size_t size)
+                : size_(size),
+                  words_(new std::atomic<uint64_t>[(size + 63) / 64]) {
+            clear();
+        }
+
+        [[nodiscard]]
+        bool test(size_t i) const noexcept {
+            return words_[i / 64].load(std::memory_order_relaxed) >> (i % 64) & 1;
+        }
+
+        void set(size_t i) noexcept {
+            words_[i / 64].fetch_or(uint64_t{1} << (i % 64), std::memory_order_relaxed);
+        }
+
+        /** Sets bit i; true only for the one caller that flipped it from 0. */
+        bool testAndSet(size_t i) noexcept {
+            const uint64_t bit = uint64_t{1} << (i % 64);
+            return !(words_[i / 64].fetch_or(bit, std::memory_order_relaxed) & bit);
+        }
+
+        void clear() noexcept {
+            for (size_t w = 0; w < words(); ++w)
+                words_[w].store(0, std::memory_order_relaxed);
+        }
+
+        void swap(AtomicBitmap& other) noexcept {
+            std::swap(size_, other.size_);
+            std::swap(words_, other.words_);
+        }
+
+        [[nodiscard]]
+        size_t size() const noexcept {
+            return size_;
+        }
+
+        [[nodiscard]]
+        size_t words() const noexcept {
+            return (size_ + 63) / 64;
+        }
+    };
+}
+
+#endif //ALGO_PARALLEL_H
@@ -0,0 +1,188 @@
+#ifndef ALGO_PARALLEL_BFS_H
+#define ALGO_PARALLEL_BFS_H
+#include <vector>
+#include <numeric>
+#include "graph.h"
+#include "parallel.h"
+
+namespace graph {
+    /** Direction-optimizing parallel BFS (Beamer, Asanovic, Patterson) *****************************
+     * Top-down steps expand the frontier queue, claiming vertices with an atomic
+     * test-and-set on the visited bitmap and collecting the next frontier in per-thread
+     * queues. Once the frontier's out-edges outweigh the unexplored ones (by alpha), the
+     * search turns bottom-up: every unvisited vertex scans its in-edges for a parent in the
+     * frontier bitmap and stops at the first hit, which skips most edges on low-diameter
+     * graphs. It turns back top-down when the frontier shrinks below V/beta.
+     *
+     * The one-graph constructor assumes adj() is symmetric (Graph, undirected CSRGraph);
+     * for a digraph pass its reverse() as well, bottom-up steps walk in-edges.
+     * edgeTo()/distTo() hold -1 for unreached vertices; pathTo() returns the same v..s
+     * sequence as BreadthFirstPaths::pathTo.
+     */
+    template<AdjacencyGraph G>
+    class ParallelBFS {
+    private:
+        std::vector<int> edgeTo_;
+        std::vector<int> distTo_;
+        const int s_;
+        unsigned threads_;
+
+        static constexpr size_t alpha = 14, beta = 24;
+
+    public:
+        ParallelBFS(const G& g, int s, unsigned threads = 0);
+        ParallelBFS(const G& g, const G& reverse, int s, unsigned threads = 0);
+        [[nodiscard]]
+        bool hasPathTo(int v) const;
+        [[nodiscard]]
+        int distTo(int v) const;
+        [[nodiscard]]
+        std::vector<int> pathTo(int v) const;
+        [[nodiscard]]
+        const std::vector<int>& edgeTo() const noexcept;
+        [[nodiscard]]
+        const std::vector<int>& distTo() const noexcept;
+
+    private:
+        void bfs(const G& g, const G& in);
+        size_t topDown(const G& g, std::vector<int>& frontier, parallel::AtomicBitmap& visited, int depth);
+        size_t bottomUp(const G& in, const parallel::AtomicBitmap& frontier, parallel::AtomicBitmap& next,
+                        parallel::AtomicBitmap& visited, int depth);
+    };
+
+    template<AdjacencyGraph G>
+    ParallelBFS<G>::ParallelBFS(const G& g, int s, unsigned threads)
+            : ParallelBFS(g, g, s, threads)
+    {}
+
+    template<AdjacencyGraph G>
+    ParallelBFS<G>::ParallelBFS(const G& g, const G& reverse, int s, unsigned threads)
+            : edgeTo_(g.V(), -1)
+            , distTo_(g.V(), -1)
+            , s_(s)
+            , threads_(parallel::threads(threads))
+    {
+        if (s < 0 || s >= g.V()) throw std::out_of_range("Source is out of boundaries");
+        bfs(g, reverse);
+    }
+
+    template<AdjacencyGraph G>
+    void ParallelBFS<G>::bfs(const G& g, const G& in) {
+        const size_t V = g.V();
+        parallel::AtomicBitmap visited(V), front(V), next(V);
+        size_t edgesToCheck = 0;
+        for (size_t v = 0; v < V; ++v)
+            edgesToCheck += g.adj(static_cast<int>(v)).size();
+
+        std::vector<int> frontier{s_};
+        visited.set(s_);
+        edgeTo_[s_] = s_;
+        distTo_[s_] = 0;
+        size_t scout = g.adj(s_).size();
+        for (int depth = 0; !frontier.empty(); ++depth) {
+            if (scout <= edgesToCheck / alpha) {
+                edgesToCheck -= scout;
+                scout = topDown(g, frontier, visited, depth);
+                continue;
+            }
+            // switch to bottom-up: frontier queue -> bitmap
+            front.clear();
+            for (int v : frontier) front.set(v);
+            size_t awake = frontier.size(), previous;
+            do {
+                previous = awake;
+                next.clear();
+                awake = bottomUp(in, front, next, visited, depth++);
+                front.swap(next);
+            } while (awake >= previous || awake > V / beta);
+            --depth;
+            // and back: bitmap -> queue, recounting the frontier's out-edges
+            frontier.clear();
+            scout = 0;
+            for (size_t v = 0; v < V; ++v)
+                if (front.test(v)) {
+                    frontier.push_back(static_cast<int>(v));
+                    scout += g.adj(static_cast<int>(v)).size();
+                }
+        }
+    }
+
+    template<AdjacencyGraph G>
+    size_t ParallelBFS<G>::topDown(const G& g, std::vector<int>& frontier,
+                                   parallel::AtomicBitmap& visited, int depth) {
+        std::vector<std::vector<int>> local(threads_);
+        std::vector<size_t> scout(threads_, 0);
+        parallel::forRange(frontier.size(), [&](size_t begin, size_t end, unsigned tid) {
+            auto& out = local[tid];
+            for (size_t i = begin; i < end; ++i) {
+                const int v = frontier[i];
+                for (int w : g.adj(v)) {
+                    if (visited.test(w) || !visited.testAndSet(w)) continue;
+                    edgeTo_[w] = v;
+                    distTo_[w] = depth + 1;
+                    out.push_back(w);
+                    scout[tid] += g.adj(w).size();
+                }
+            }
+        }, 64, threads_);
+        frontier.clear();
+        for (auto& out : local)
+            frontier.insert(frontier.end(), out.begin(), out.end());
+        return std::accumulate(scout.begin(), scout.end(), size_t{0});
+    }
+
+    template<AdjacencyGraph G>
+    size_t ParallelBFS<G>::bottomUp(const G& in, const parallel::AtomicBitmap& frontier,
+                                    parallel::AtomicBitmap& next, parallel::AtomicBitmap& visited, int depth) {
+        std::vector<size_t> awake(threads_, 0);
+        // v is only ever looked at by the thread owning its chunk, so it can be marked
+        // visited right away without hiding it from anyone else this step
+        parallel::forRange(frontier.size(), [&](size_t begin, size_t end, unsigned tid) {
+            for (size_t v = begin; v < end; ++v) {
+                if (visited.test(v)) continue;
+                for (int u : in.adj(static_cast<int>(v))) {
+                    if (!frontier.test(u)) continue;
+                    edgeTo_[v] = u;
+                    distTo_[v] = depth + 1;
+                    visited.set(v);
+                    next.set(v);
+                    ++awake[tid];
+                    break;
+                }
+            }
+        }, 4096, threads_);
+        return std::accumulate(awake.begin(), awake.end(), size_t{0});
+    }
+
+    template<AdjacencyGraph G>
+    bool ParallelBFS<G>::hasPathTo(int v) const {
+        return distTo_.at(v) >= 0;
+    }
+
+    template<AdjacencyGraph G>
+    int ParallelBFS<G>::distTo(int v) const {
+        return distTo_.at(v);
+    }
+
+    template<AdjacencyGraph G>
+    std::vector<int> ParallelBFS<G>::pathTo(int v) const {
+        if (!hasPathTo(v)) return {};
+        std::vector<int> path;
+        for (int x = v; x != s_; x = edgeTo_[x])
+            path.push_back(x);
+        path.push_back(s_);
+        return path;
+    }
+
+    template<AdjacencyGraph G>
+    const std::vector<int>& ParallelBFS<G>::edgeTo() const noexcept {
+        return edgeTo_;
+    }
+
+    template<AdjacencyGraph G>
+    const std::vector<int>& ParallelBFS<G>::distTo() const noexcept {
+        return distTo_;
+    }
+}
+
+#endif //ALGO_PARALLEL_BFS_H
@@ -0,0 +1,164 @@
+#include "reachability.h"
+#include <random>
+#include <bit>
+#include "parallel.h"
+
+namespace graph {
+    void ReachabilityIndex::build(Mode mode, int labels, unsigned threads) {
+        mode_ = mode != Mode::Automatic ? mode
+              : count_ <= closureLimit ? Mode::Closure : Mode::Labels;
+        if (mode_ == Mode::Closure) {
+            buildClosure(threads);
+        } else {
+            k_ = std::max(1, labels);
+            buildLabels(threads);
+        }
+    }
+
+    void ReachabilityIndex::buildClosure(unsigned threads) {
+        const int C = count_;
+        words_ = (static_cast<size_t>(C) + 63) / 64;
+        closure_.assign(words_ * C, 0);
+        // level = longest path to a sink; successors always sit on lower levels, and
+        // Kosaraju's ids put them at lower ids too, so one ascending sweep fills levels
+        std::vector<int> level(C, 0);
+        int height = 0;
+        for (int c = 0; c < C; ++c) {
+            for (int d : dag_.adj(c))
+                level[c] = std::max(level[c], level[d] + 1);
+            height = std::max(height, level[c]);
+        }
+        std::vector<size_t> start(height + 2, 0);
+        for (int c = 0; c < C; ++c) ++start[level[c] + 1];
+        for (int l = 0; l <= height; ++l) start[l + 1] += start[l];
+        std::vector<int> byLevel(C);
+        std::vector<size_t> next(start.begin(), start.end() - 1);
+        for (int c = 0; c < C; ++c) byLevel[next[level[c]]++] = c;
+
+        for (int l = 0; l <= height; ++l) {
+            parallel::forRange(start[l + 1] - start[l], [&](size_t begin, size_t end, unsigned) {
+                for (size_t i = start[l] + begin; i < start[l] + end; ++i) {
+                    const int c = byLevel[i];
+                    uint64_t* row = closure_.data() + words_ * c;
+                    row[c / 64] |= uint64_t{1} << (c % 64);
+                    for (int d : dag_.adj(c)) {
+                        const uint64_t* from = closure_.data() + words_ * d;
+                        // rows of lower ids only have bits below their own id
+                        for (size_t x = 0; x <= static_cast<size_t>(d) / 64; ++x)
+                            row[x] |= from[x];
+                    }
+                }
+            }, 16, threads);
+        }
+    }
+
+    // GRAIL: k randomized post-order traversals of the DAG. In each, component c gets the
+    // interval [low, post] where low is the smallest post rank below it; reachability
+    // implies nesting of the intervals, in every traversal.
+    void ReachabilityIndex::buildLabels(unsigned threads) {
+        const int C = count_;
+        low_.assign(static_cast<size_t>(C) * k_, 0);
+        post_.assign(static_cast<size_t>(C) * k_, 0);
+        std::vector<int> roots;
+        {
+            std::vector<bool> hasParent(C, false);
+            for (int w : dag_.targets()) hasParent[w] = true;
+            for (int c = 0; c < C; ++c)
+                if (!hasParent[c]) roots.push_back(c);
+        }
+        parallel::forRange(k_, [&](size_t begin, size_t end, unsigned) {
+            struct Frame { int c; unsigned seen, rotate; };
+            std::vector<Frame> stack;
+            std::vector<bool> marked(C);
+            for (size_t t = begin; t < end; ++t) {
+                std::mt19937 gen(static_cast<unsigned>(t) * 7919u + 1);
+                std::vector<int> order(roots);
+                std::shuffle(order.begin(), order.end(), gen);
+                std::fill(marked.begin(), marked.end(), false);
+                int rank = 0;
+                for (int r : order) {
+                    marked[r] = true;
+                    stack.push_back({r, 0, static_cast<unsigned>(gen())});
+                    while (!stack.empty()) {
+                        auto& f = stack.back();
+                        auto adj = dag_.adj(f.c);
+                        if (f.seen < adj.size()) {
+                            const int d = adj[(f.seen++ + f.rotate) % adj.size()];
+                            if (!marked[d]) {
+                                marked[d] = true;
+                                stack.push_back({d, 0, static_cast<unsigned>(gen())});
+                            }
+                            continue;
+                        }
+                        const size_t at = static_cast<size_t>(f.c) * k_ + t;
+                        int low = rank;
+                        for (int d : adj)
+                            low = std::min(low, low_[static_cast<size_t>(d) * k_ + t]);
+                        low_[at] = low;
+                        post_[at] = rank++;
+                        stack.pop_back();
+                    }
+                }
+            }
+        }, 1, threads);
+    }
+
+    bool ReachabilityIndex::nested(int inner, int outer) const {
+        const size_t i = static_cast<size_t>(inner) * k_, o = static_cast<size_t>(outer) * k_;
+        for (int t = 0; t < k_; ++t)
+            if (low_[i + t] < low_[o + t] || post_[i + t] > post_[o + t])
+                return false;
+        return true;
+    }
+
+    // DFS over the DAG that never enters a component whose labels already rule `to` out.
+    // The visited stamps are per thread, so const queries can run concurrently.
+    bool ReachabilityIndex::search(int from, int to) const {
+        thread_local std::vector<uint32_t> seen;
+        thread_local uint32_t stamp = 0;
+        thread_local std::vector<int> stack;
+        if (seen.size() < static_cast<size_t>(count_)) seen.resize(count_, 0);
+        if (++stamp == 0) {
+            std::fill(seen.begin(), seen.end(), 0);
+            stamp = 1;
+        }
+        stack.assign(1, from);
+        seen[from] = stamp;
+        while (!stack.empty()) {
+            const int c = stack.back();
+            stack.pop_back();
+            for (int d : dag_.adj(c)) {
+                if (d == to) return true;
+                if (seen[d] == stamp || d < to || !nested(to, d)) continue;
+                seen[d] = stamp;
+                stack.push_back(d);
+            }
+        }
+        return false;
+    }
+
+    bool ReachabilityIndex::reachable(int v, int w) const {
+        const int cv = id_.at(v), cw = id_.at(w);
+        if (cv == cw) return true;
+        if (cv < cw) return false;
+        if (mode_ == Mode::Closure)
+            return closure_[words_ * cv + cw / 64] >> (cw % 64) & 1;
+        return nested(cw, cv) && search(cv, cw);
+    }
+
+    int ReachabilityIndex::components() const noexcept {
+        return count_;
+    }
+
+    int ReachabilityIndex::component(int v) const {
+        return id_.at(v);
+    }
+
+    ReachabilityIndex::Mode ReachabilityIndex::mode() const noexcept {
+        return mode_;
+    }
+
+    const CSRGraph &ReachabilityIndex::condensation() const noexcept {
+        return dag_;
+    }
+}
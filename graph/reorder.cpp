@@ -0,0 +1,101 @@
+#include "reorder.h"
+
+namespace graph {
+    Permutation::Permutation(std::vector<int> newId)
+        : newId_(std::move(newId))
+        , oldId_(newId_.size(), -1)
+    {
+        const int V = static_cast<int>(newId_.size());
+        for (int v = 0; v < V; ++v) {
+            const int x = newId_[v];
+            if (x < 0 || x >= V || oldId_[x] != -1)
+                throw std::invalid_argument("Not a permutation");
+            oldId_[x] = v;
+        }
+    }
+
+    Permutation Permutation::fromOrder(const std::vector<int>& order) {
+        std::vector<int> newId(order.size(), -1);
+        for (size_t i = 0; i < order.size(); ++i) {
+            if (order[i] < 0 || static_cast<size_t>(order[i]) >= order.size())
+                throw std::invalid_argument("Not a permutation");
+            newId[order[i]] = static_cast<int>(i);
+        }
+        return Permutation(std::move(newId));
+    }
+
+    int Permutation::newId(int v) const {
+        return newId_.at(v);
+    }
+
+    int Permutation::oldId(int v) const {
+        return oldId_.at(v);
+    }
+
+    int Permutation::size() const noexcept {
+        return static_cast<int>(newId_.size());
+    }
+
+    Permutation Permutation::inverse() const {
+        return Permutation(oldId_);
+    }
+
+    namespace {
+        void checkSize(int V, const Permutation& p) {
+            if (p.size() != V)
+                throw std::invalid_argument("Permutation does not match the graph");
+        }
+    }
+
+    // the bulk constructors fill each list in edge order, so sorted (new v, new w) pairs
+    // give sorted neighbour lists
+    Graph apply(const Graph& g, const Permutation& p) {
+        checkSize(g.V(), p);
+        std::vector<std::pair<int, int>> edges;
+        edges.reserve(g.E());
+        for (int v = 0; v < g.V(); ++v) {
+            bool second = false;    // a self-loop is listed twice but is one edge
+            for (int w : g.adj(v))
+                if (v < w || (v == w && (second = !second)))
+                    edges.emplace_back(std::minmax(p.newId(v), p.newId(w)));
+        }
+        std::sort(edges.begin(), edges.end());
+        return {g.V(), edges};
+    }
+
+    Digraph apply(const Digraph& g, const Permutation& p) {
+        checkSize(g.V(), p);
+        std::vector<std::pair<int, int>> edges;
+        edges.reserve(g.E());
+        for (int v = 0; v < g.V(); ++v)
+            for (int w : g.adj(v))
+                edges.emplace_back(p.newId(v), p.newId(w));
+        std::sort(edges.begin(), edges.end());
+        return {g.V(), edges};
+    }
+
+    CSRGraph apply(const CSRGraph& g, const Permutation& p) {
+        checkSize(g.V(), p);
+        const int V = g.V();
+        std::vector<size_t> offsets(V + 1, 0);
+        for (int x = 0; x < V; ++x)
+            offsets[x + 1] = offsets[x] + g.degree(p.oldId(x));
+        std::vector<int> targets(offsets[V]);
+        std::vector<double> weights(g.weighted() ? offsets[V] : 0);
+        std::vector<std::pair<int, double>> row;
+        for (int x = 0; x < V; ++x) {
+            const int v = p.oldId(x);
+            auto adj = g.adj(v);
+            auto w = g.weights(v);
+            row.clear();
+            for (size_t i = 0; i < adj.size(); ++i)
+                row.emplace_back(p.newId(adj[i]), w.empty() ? 0.0 : w[i]);
+            std::sort(row.begin(), row.end());
+            for (size_t i = 0; i < row.size(); ++i) {
+                targets[offsets[x] + i] = row[i].first;
+                if (!weights.empty()) weights[offsets[x] + i] = row[i].second;
+            }
+        }
+        return {std::move(offsets), std::move(targets), std::move(weights), g.directed()};
+    }
+}
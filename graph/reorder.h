@@ -0,0 +1,212 @@
+#ifndef ALGO_REORDER_H
+#define ALGO_REORDER_H
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include "graph.h"
+#include "csr.h"
+
+namespace graph {
+    /** Vertex relabelling ********************************************************
+     * A traversal touches adj(v) and marked_[w] in id order of whatever it meets, so
+     * when ids are effectively random every step is a cache miss. A Permutation maps
+     * every vertex to a new id so that vertices visited together sit together; apply()
+     * rebuilds a graph under the new ids with sorted neighbour lists. Both directions
+     * are kept, so a query is translated in with newId() and answers come back with
+     * oldId() or, for per-vertex arrays, restore().
+     */
+    class Permutation {
+    private:
+        std::vector<int> newId_;    // old -> new
+        std::vector<int> oldId_;    // new -> old
+    public:
+        Permutation() = default;
+        // newId[v] is the new id of vertex v; throws unless it is a permutation of [0, V)
+        explicit Permutation(std::vector<int> newId);
+        // the permutation that puts order[0] first, order[1] second, ...
+        static Permutation fromOrder(const std::vector<int>& order);
+        [[nodiscard]]
+        int newId(int v) const;
+        [[nodiscard]]
+        int oldId(int v) const;
+        [[nodiscard]]
+        int size() const noexcept;
+        [[nodiscard]]
+        Permutation inverse() const;
+        // per-vertex values indexed by new id -> the same values indexed by old id
+        template<typename T>
+        [[nodiscard]]
+        std::vector<T> restore(const std::vector<T>& byNew) const;
+    };
+
+    template<typename T>
+    std::vector<T> Permutation::restore(const std::vector<T>& byNew) const {
+        if (byNew.size() != newId_.size())
+            throw std::invalid_argument("Array does not match the permutation");
+        std::vector<T> byOld;
+        byOld.reserve(byNew.size());
+        for (int v : newId_) byOld.push_back(byNew[v]);
+        return byOld;
+    }
+
+    [[nodiscard]]
+    Graph apply(const Graph& g, const Permutation& p);
+    [[nodiscard]]
+    Digraph apply(const Digraph& g, const Permutation& p);
+    [[nodiscard]]
+    CSRGraph apply(const CSRGraph& g, const Permutation& p);
+
+    /** Orderings. Directed graphs are ordered by their out-edges only; for them the
+     * orders work best on a symmetric view (a Graph or an undirected CSRGraph).
+     */
+
+    // hubs first: descending degree, ties kept in id order; packs the hot rows together
+    template<AdjacencyGraph G>
+    [[nodiscard]]
+    Permutation degreeOrder(const G& g);
+
+    // reverse Cuthill-McKee: BFS from a pseudo-peripheral vertex of each component,
+    // neighbours taken by increasing degree, whole sequence reversed; keeps the ids of
+    // adjacent vertices close, i.e. a narrow bandwidth
+    template<AdjacencyGraph G>
+    [[nodiscard]]
+    Permutation rcmOrder(const G& g);
+
+    // community order in the spirit of Rabbit Order: a few rounds of label propagation
+    // find dense communities, each community then gets a contiguous id range, filled in
+    // BFS order within the community
+    template<AdjacencyGraph G>
+    [[nodiscard]]
+    Permutation communityOrder(const G& g, int rounds = 5);
+
+    namespace detail {
+        template<AdjacencyGraph G>
+        std::vector<int> degrees(const G& g) {
+            std::vector<int> degree(g.V());
+            for (int v = 0; v < g.V(); ++v)
+                degree[v] = static_cast<int>(std::ranges::size(g.adj(v)));
+            return degree;
+        }
+
+        // BFS from s over unplaced vertices accepted by keep, appending to order;
+        // neighbours are taken in increasing degree if degree is not empty
+        template<AdjacencyGraph G, typename Keep>
+        int levelOrder(const G& g, int s, std::vector<bool>& placed, std::vector<int>& order,
+                       const std::vector<int>& degree, Keep keep) {
+            size_t head = order.size();
+            placed[s] = true;
+            order.push_back(s);
+            int last = s;
+            std::vector<int> next;
+            while (head < order.size()) {
+                const int v = order[head++];
+                last = v;
+                next.clear();
+                for (int w : g.adj(v))
+                    if (!placed[w] && keep(w)) {
+                        placed[w] = true;
+                        next.push_back(w);
+                    }
+                if (!degree.empty())
+                    std::stable_sort(next.begin(), next.end(), [&degree](int a, int b) {
+                        return degree[a] < degree[b];
+                    });
+                order.insert(order.end(), next.begin(), next.end());
+            }
+            return last;
+        }
+    }
+
+    template<AdjacencyGraph G>
+    Permutation degreeOrder(const G& g) {
+        const auto degree = detail::degrees(g);
+        std::vector<int> order(g.V());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&degree](int a, int b) {
+            return degree[a] > degree[b];
+        });
+        return Permutation::fromOrder(order);
+    }
+
+    template<AdjacencyGraph G>
+    Permutation rcmOrder(const G& g) {
+        const int V = g.V();
+        const auto degree = detail::degrees(g);
+        std::vector<int> byDegree(V);
+        std::iota(byDegree.begin(), byDegree.end(), 0);
+        std::stable_sort(byDegree.begin(), byDegree.end(), [&degree](int a, int b) {
+            return degree[a] < degree[b];
+        });
+        std::vector<bool> placed(V, false);
+        std::vector<int> order;
+        order.reserve(V);
+        auto any = [](int) { return true; };
+        for (int s : byDegree) {
+            if (placed[s]) continue;
+            // one George-Liu step: restart from the far end of a first sweep
+            const size_t start = order.size();
+            const int far = detail::levelOrder(g, s, placed, order, degree, any);
+            for (size_t i = start; i < order.size(); ++i) placed[order[i]] = false;
+            order.resize(start);
+            detail::levelOrder(g, far, placed, order, degree, any);
+            // directed: far need not reach back to s
+            if (!placed[s]) detail::levelOrder(g, s, placed, order, degree, any);
+        }
+        std::reverse(order.begin(), order.end());
+        return Permutation::fromOrder(order);
+    }
+
+    template<AdjacencyGraph G>
+    Permutation communityOrder(const G& g, int rounds) {
+        const int V = g.V();
+        std::vector<int> label(V), count(V, 0), touched;
+        std::iota(label.begin(), label.end(), 0);
+        // asynchronous propagation: the most frequent label around v, smallest on ties
+        for (int r = 0; r < rounds; ++r) {
+            bool changed = false;
+            for (int v = 0; v < V; ++v) {
+                touched.clear();
+                for (int w : g.adj(v))
+                    if (count[label[w]]++ == 0) touched.push_back(label[w]);
+                int best = label[v], bestCount = 0;
+                for (int l : touched) {
+                    if (count[l] > bestCount || (count[l] == bestCount && l < best)) {
+                        best = l;
+                        bestCount = count[l];
+                    }
+                    count[l] = 0;
+                }
+                if (best != label[v]) {
+                    label[v] = best;
+                    changed = true;
+                }
+            }
+            if (!changed) break;
+        }
+        // bucket the members of every community, in id order
+        std::vector<size_t> start(V + 1, 0);
+        for (int v = 0; v < V; ++v) ++start[label[v] + 1];
+        for (int l = 0; l < V; ++l) start[l + 1] += start[l];
+        std::vector<int> members(V);
+        std::vector<size_t> next(start.begin(), start.end() - 1);
+        for (int v = 0; v < V; ++v) members[next[label[v]]++] = v;
+
+        std::vector<bool> placed(V, false);
+        std::vector<int> order;
+        order.reserve(V);
+        const std::vector<int> unsorted;
+        for (int s = 0; s < V; ++s) {
+            if (placed[s]) continue;
+            // all of s's community, whether or not its members reach each other inside it
+            const int l = label[s];
+            for (size_t i = start[l]; i < start[l + 1]; ++i)
+                if (!placed[members[i]])
+                    detail::levelOrder(g, members[i], placed, order, unsorted,
+                                       [&label, l](int w) { return label[w] == l; });
+        }
+        return Permutation::fromOrder(order);
+    }
+}
+
+#endif //ALGO_REORDER_H
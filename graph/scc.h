@@ -0,0 +1,299 @@
+#ifndef ALGO_SCC_H
+#define ALGO_SCC_H
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include "concepts.h"
+#include "dfs.h"
+#include "parallel.h"
+
+namespace graph {
+    /** Single-pass strong components (Pearce's space-efficient Tarjan) ********************************
+     * One iterative DFS, no reverse graph. rindex doubles as the visit index while a vertex
+     * is open and as its component number once it is closed; component numbers count down
+     * from V-1 so they always compare above any open index, which makes Tarjan's separate
+     * lowlink and on-stack arrays unnecessary. Extra memory: one int and two bits per vertex
+     * plus the two stacks. Components come out sinks first, like KosarajuSCC's.
+     */
+    template<AdjacencyGraph G>
+    class TarjanSCC {
+    private:
+        std::vector<int> id_;
+        int count_;
+    public:
+        explicit TarjanSCC(const G& g);
+        [[nodiscard]]
+        bool stronglyConnected(int v, int w) const noexcept;
+        [[nodiscard]]
+        int id(int v) const noexcept;
+        [[nodiscard]]
+        int count() const noexcept;
+    };
+
+    template<AdjacencyGraph G>
+    TarjanSCC<G>::TarjanSCC(const G& g)
+            : id_(g.V(), 0)
+            , count_{0}
+    {
+        const int V = g.V();
+        struct : DfsVisitor {
+            std::vector<int>& rindex;
+            std::vector<bool> root;
+            std::vector<int> open;
+            int index = 0, c = 0;
+            void preorder(int v) {
+                rindex[v] = index++;
+                root[v] = true;
+            }
+            void lower(int v, int w) {
+                if (rindex[w] < rindex[v]) {
+                    rindex[v] = rindex[w];
+                    root[v] = false;
+                }
+            }
+            void nonTreeEdge(int v, int w) { lower(v, w); }
+            void finishTreeEdge(int v, int w) { lower(v, w); }
+            void postorder(int v) {
+                if (!root[v]) {
+                    open.push_back(v);
+                    return;
+                }
+                --index;
+                while (!open.empty() && rindex[v] <= rindex[open.back()]) {
+                    rindex[open.back()] = c;
+                    open.pop_back();
+                    --index;
+                }
+                rindex[v] = c--;
+            }
+        } visitor{{}, id_, std::vector<bool>(V, false), {}, 0, V - 1};
+        std::vector<bool> marked(V, false);
+        DepthFirstEngine<G> engine;
+        for (int v = 0; v < V; ++v)
+            if (!marked[v]) engine.run(g, v, marked, visitor);
+        count_ = V - 1 - visitor.c;
+        for (int& x : id_) x = V - 1 - x;
+    }
+
+    template<AdjacencyGraph G>
+    bool TarjanSCC<G>::stronglyConnected(int v, int w) const noexcept {
+        return id_[v] == id_[w];
+    }
+
+    template<AdjacencyGraph G>
+    int TarjanSCC<G>::id(int v) const noexcept { return id_[v]; }
+
+    template<AdjacencyGraph G>
+    int TarjanSCC<G>::count() const noexcept { return count_; }
+
+    /** Parallel strong components (trim + forward-backward + coloring, "Multistep") *******************
+     * 1. Trim: a vertex with no live in- or out-edges is a component on its own; removing
+     *    it can expose more, so trimming runs in parallel rounds until nothing changes.
+     * 2. FW-BW: the vertex with the largest in*out degree is almost surely in the giant
+     *    component, which is the intersection of its forward and backward BFS.
+     * 3. Coloring: every remaining vertex pushes the largest id that reaches it forward;
+     *    each vertex that keeps its own id is the root of a component made of the vertices
+     *    of its color that reach it backwards. Repeated until every vertex is assigned.
+     * Steps work level- or worklist-synchronously across threads; needs in-edges, so a
+     * digraph comes with its reverse. Component ids carry no topological meaning.
+     */
+    template<AdjacencyGraph G>
+    class ParallelSCC {
+    private:
+        std::vector<int> id_;
+        int count_;
+        unsigned threads_;
+
+        static constexpr int unassigned = -1;
+
+    public:
+        explicit ParallelSCC(const G& g, unsigned threads = 0) requires DirectedAdjacencyGraph<G>;
+        ParallelSCC(const G& g, const G& reverse, unsigned threads = 0);
+        [[nodiscard]]
+        bool stronglyConnected(int v, int w) const noexcept;
+        [[nodiscard]]
+        int id(int v) const noexcept;
+        [[nodiscard]]
+        int count() const noexcept;
+
+    private:
+        void trim(const G& g, const G& in, std::vector<std::atomic<int>>& indeg,
+                  std::vector<std::atomic<int>>& outdeg, std::atomic<int>& next);
+        std::vector<int> reach(const G& g, int s, const std::vector<int>& mask, int color);
+        void forwardBackward(const G& g, const G& in, int pivot, std::atomic<int>& next);
+        void coloring(const G& g, const G& in, std::atomic<int>& next);
+    };
+
+    template<AdjacencyGraph G>
+    ParallelSCC<G>::ParallelSCC(const G& g, unsigned threads) requires DirectedAdjacencyGraph<G>
+            : ParallelSCC(g, g.reverse(), threads)
+    {}
+
+    template<AdjacencyGraph G>
+    ParallelSCC<G>::ParallelSCC(const G& g, const G& reverse, unsigned threads)
+            : id_(g.V(), unassigned)
+            , count_{0}
+            , threads_(parallel::threads(threads))
+    {
+        const int V = g.V();
+        std::vector<std::atomic<int>> indeg(V), outdeg(V);
+        parallel::forRange(V, [&](size_t begin, size_t end, unsigned) {
+            for (size_t v = begin; v < end; ++v) {
+                indeg[v].store(static_cast<int>(std::ranges::size(reverse.adj(static_cast<int>(v)))));
+                outdeg[v].store(static_cast<int>(std::ranges::size(g.adj(static_cast<int>(v)))));
+            }
+        }, 4096, threads_);
+        std::atomic<int> next{0};
+        trim(g, reverse, indeg, outdeg, next);
+
+        int pivot = -1;
+        long long best = -1;
+        for (int v = 0; v < V; ++v)
+            if (id_[v] == unassigned && 1LL * indeg[v] * outdeg[v] > best) {
+                best = 1LL * indeg[v] * outdeg[v];
+                pivot = v;
+            }
+        if (pivot >= 0) forwardBackward(g, reverse, pivot, next);
+        coloring(g, reverse, next);
+        count_ = next.load();
+    }
+
+    template<AdjacencyGraph G>
+    void ParallelSCC<G>::trim(const G& g, const G& in, std::vector<std::atomic<int>>& indeg,
+                              std::vector<std::atomic<int>>& outdeg, std::atomic<int>& next) {
+        const size_t V = id_.size();
+        parallel::AtomicBitmap trimmed(V);
+        std::vector<int> frontier;
+        for (size_t v = 0; v < V; ++v)
+            if ((indeg[v] == 0 || outdeg[v] == 0) && trimmed.testAndSet(v))
+                frontier.push_back(static_cast<int>(v));
+        std::vector<std::vector<int>> local(threads_);
+        while (!frontier.empty()) {
+            parallel::forRange(frontier.size(), [&](size_t begin, size_t end, unsigned tid) {
+                for (size_t i = begin; i < end; ++i) {
+                    const int v = frontier[i];
+                    id_[v] = next.fetch_add(1, std::memory_order_relaxed);
+                    for (int w : g.adj(v))
+                        if (indeg[w].fetch_sub(1, std::memory_order_relaxed) == 1 && trimmed.testAndSet(w))
+                            local[tid].push_back(w);
+                    for (int u : in.adj(v))
+                        if (outdeg[u].fetch_sub(1, std::memory_order_relaxed) == 1 && trimmed.testAndSet(u))
+                            local[tid].push_back(u);
+                }
+            }, 256, threads_);
+            frontier.clear();
+            for (auto& l : local) {
+                frontier.insert(frontier.end(), l.begin(), l.end());
+                l.clear();
+            }
+        }
+    }
+
+    // level-synchronous parallel BFS from s over vertices whose mask entry equals color
+    template<AdjacencyGraph G>
+    std::vector<int> ParallelSCC<G>::reach(const G& g, int s, const std::vector<int>& mask, int color) {
+        parallel::AtomicBitmap seen(mask.size());
+        std::vector<int> all{s}, frontier{s};
+        seen.set(s);
+        std::vector<std::vector<int>> local(threads_);
+        while (!frontier.empty()) {
+            parallel::forRange(frontier.size(), [&](size_t begin, size_t end, unsigned tid) {
+                for (size_t i = begin; i < end; ++i)
+                    for (int w : g.adj(frontier[i]))
+                        if (mask[w] == color && !seen.test(w) && seen.testAndSet(w))
+                            local[tid].push_back(w);
+            }, 64, threads_);
+            frontier.clear();
+            for (auto& l : local) {
+                frontier.insert(frontier.end(), l.begin(), l.end());
+                l.clear();
+            }
+            all.insert(all.end(), frontier.begin(), frontier.end());
+        }
+        return all;
+    }
+
+    template<AdjacencyGraph G>
+    void ParallelSCC<G>::forwardBackward(const G& g, const G& in, int pivot, std::atomic<int>& next) {
+        const auto forward = reach(g, pivot, id_, unassigned);
+        std::vector<int> mask(id_.size(), 0);
+        for (int v : forward) mask[v] = 1;
+        const int component = next.fetch_add(1);
+        for (int v : reach(in, pivot, mask, 1))
+            id_[v] = component;
+    }
+
+    template<AdjacencyGraph G>
+    void ParallelSCC<G>::coloring(const G& g, const G& in, std::atomic<int>& next) {
+        const size_t V = id_.size();
+        std::vector<std::atomic<int>> color(V);
+        std::vector<int> live;
+        for (size_t v = 0; v < V; ++v)
+            if (id_[v] == unassigned) live.push_back(static_cast<int>(v));
+        std::vector<std::vector<int>> local(threads_);
+        while (!live.empty()) {
+            for (int v : live) color[v].store(v, std::memory_order_relaxed);
+            // forward max-propagation over the live subgraph, worklist driven
+            std::vector<int> active(live);
+            parallel::AtomicBitmap queued(V);
+            while (!active.empty()) {
+                queued.clear();
+                parallel::forRange(active.size(), [&](size_t begin, size_t end, unsigned tid) {
+                    for (size_t i = begin; i < end; ++i) {
+                        const int v = active[i];
+                        const int c = color[v].load(std::memory_order_relaxed);
+                        for (int w : g.adj(v)) {
+                            if (id_[w] != unassigned) continue;
+                            int old = color[w].load(std::memory_order_relaxed);
+                            while (old < c && !color[w].compare_exchange_weak(old, c, std::memory_order_relaxed));
+                            if (old < c && queued.testAndSet(w))
+                                local[tid].push_back(w);
+                        }
+                    }
+                }, 256, threads_);
+                active.clear();
+                for (auto& l : local) {
+                    active.insert(active.end(), l.begin(), l.end());
+                    l.clear();
+                }
+            }
+            // every root collects its color class backwards; classes are disjoint, so the
+            // roots are processed in parallel with a plain serial search each
+            std::vector<int> roots;
+            for (int v : live)
+                if (color[v].load(std::memory_order_relaxed) == v) roots.push_back(v);
+            parallel::forRange(roots.size(), [&](size_t begin, size_t end, unsigned) {
+                std::vector<int> stack;
+                for (size_t i = begin; i < end; ++i) {
+                    const int r = roots[i];
+                    const int component = next.fetch_add(1, std::memory_order_relaxed);
+                    id_[r] = component;
+                    stack.assign(1, r);
+                    while (!stack.empty()) {
+                        const int v = stack.back();
+                        stack.pop_back();
+                        for (int u : in.adj(v))
+                            if (color[u].load(std::memory_order_relaxed) == r && id_[u] == unassigned) {
+                                id_[u] = component;
+                                stack.push_back(u);
+                            }
+                    }
+                }
+            }, 16, threads_);
+            std::erase_if(live, [this](int v) { return id_[v] != unassigned; });
+        }
+    }
+
+    template<AdjacencyGraph G>
+    bool ParallelSCC<G>::stronglyConnected(int v, int w) const noexcept {
+        return id_[v] == id_[w];
+    }
+
+    template<AdjacencyGraph G>
+    int ParallelSCC<G>::id(int v) const noexcept { return id_[v]; }
+
+    template<AdjacencyGraph G>
+    int ParallelSCC<G>::count() const noexcept { return count_; }
+}
+
+#endif //ALGO_SCC_H
@@ -0,0 +1,1133 @@
+#include <sstream>
+#include <fstream>
+#include <string_view>
+#include <cmath>
+#include <random>
+#include <filesystem>
+#include <numeric>
+#include <atomic>
+#include <set>
+#include <tuple>
+#include <limits>
+#include <cstring>
+#include <gtest/gtest.h>
+#include "graph.h"
+#include "csr.h"
+#include "parallel_bfs.h"
+#include "reachability.h"
+#include "scc.h"
+#include "components.h"
+#include "mst.h"
+#include "io.h"
+#include "incremental.h"
+#include "reorder.h"
+#include "msbfs.h"
+#include "p2p.h"
+#include "ch.h"
+#include "vertex_program.h"
+#include "cohesion.h"
+#include "flow.h"
+#include "../data_structures/bucket_queue.h"
+using namespace graph;
+
+constexpr std::string_view tinyG =
+R"(13
+13
+0 5
+4 3
+0 1
+9 12
+6 4
+5 4
+0 2
+11 12
+9 10
+0 6
+7 8
+9 11
+5 3)";
+
+constexpr std::string_view tinyDG =
+R"(13
+22
+4 2
+2 3
+3 2
+6 0
+0 1
+2 0
+11 12
+12 9
+9 10
+9 11
+7 9
+10 12
+11 4
+4 3
+3 5
+6 8
+8 6
+5 4
+0 5
+6 4
+6 9
+7 6)";
+
+constexpr std::string_view tinyEWD =
+R"(8 15
+4 5 0.35
+5 4 0.35
+4 7 0.37
+5 7 0.28
+7 5 0.28
+5 1 0.32
+0 4 0.38
+0 2 0.26
+7 3 0.39
+1 3 0.29
+2 7 0.34
+6 2 0.40
+3 6 0.52
+6 0 0.58
+6 4 0.93)";
+
+constexpr std::string_view tinyEWG =
+R"(8 16
+4 5 0.35
+4 7 0.37
+5 7 0.28
+0 7 0.16
+1 5 0.32
+0 4 0.38
+2 3 0.17
+1 7 0.19
+0 2 0.26
+1 2 0.36
+1 3 0.29
+2 7 0.34
+6 2 0.40
+3 6 0.52
+6 0 0.58
+6 4 0.93)";
+
+constexpr std::string_view tinyEWDAG =
+R"(8 13
+5 4 0.35
+4 7 0.37
+5 7 0.28
+5 1 0.32
+4 0 0.38
+0 2 0.26
+3 7 0.39
+1 3 0.29
+7 2 0.34
+6 2 0.40
+3 6 0.52
+6 0 0.58
+6 4 0.93)";
+
+template<typename G>
+static G read(std::string_view text) {
+    std::stringstream ss(text.data());
+    return G(ss);
+}
+
+static EdgeWeightedDigraph read_ewd(std::string_view text) {
+    std::stringstream ss(text.data());
+    return EdgeWeightedDigraph(ss);
+}
+
+TEST(test_graph, edge_weighted_digraph) {
+    auto g = read_ewd(tinyEWD);
+    EXPECT_EQ(g.V(), 8);
+    EXPECT_EQ(g.E(), 15);
+    EXPECT_EQ(g.outdegree(6), 3);
+    for (int v = 0; v < g.V(); ++v)
+        for (const auto& e : g.adj(v))
+            EXPECT_EQ(e.from(), v);
+    g.addEdge({0, 6, 1.0});
+    g.addEdge({7, 0, 2.0});
+    EXPECT_EQ(g.outdegree(0), 3);
+    EXPECT_EQ(g.outdegree(7), 3);
+    EXPECT_EQ(g.adj(0).back().to(), 6);
+    EXPECT_EQ(g.edges().size(), 17);
+    for (int v = 0; v < g.V(); ++v)
+        for (const auto& e : g.adj(v))
+            EXPECT_EQ(e.from(), v);
+    EXPECT_THROW(g.addEdge({0, 8, 1.0}), std::out_of_range);
+}
+
+TEST(test_graph, dijkstra_sp) {
+    auto g = read_ewd(tinyEWD);
+    DijkstraSP sp(g, 0);
+    const double expected[] = {0.0, 1.05, 0.26, 0.99, 0.38, 0.73, 1.51, 0.60};
+    for (int v = 0; v < g.V(); ++v)
+        EXPECT_NEAR(sp.distTo(v), expected[v], 1e-9);
+    auto path = sp.pathTo(6);
+    ASSERT_EQ(path.size(), 4);
+    EXPECT_EQ(path.front().from(), 0);
+    EXPECT_EQ(path.back().to(), 6);
+
+    // same graph with weights in hundredths, run on the integer queues
+    std::vector<DirectedEdge> scaled;
+    for (const auto& e : g.edges())
+        scaled.emplace_back(e.from(), e.to(), std::round(e.weight() * 100));
+    EdgeWeightedDigraph ig(g.V(), scaled);
+    DijkstraSP<data_structures::BucketQueue<unsigned>> bucket(ig, 0);
+    DijkstraSP<data_structures::RadixHeap<unsigned>> radix(ig, 0);
+    for (int v = 0; v < g.V(); ++v) {
+        EXPECT_EQ(bucket.distTo(v), std::lround(expected[v] * 100));
+        EXPECT_EQ(radix.distTo(v), std::lround(expected[v] * 100));
+    }
+}
+
+TEST(test_graph, acyclic_sp) {
+    auto g = read_ewd(tinyEWDAG);
+    AcyclicSP sp(g, 5);
+    const double expected[] = {0.73, 0.32, 0.62, 0.61, 0.35, 0.0, 1.13, 0.28};
+    for (int v = 0; v < g.V(); ++v)
+        EXPECT_NEAR(sp.distTo(v), expected[v], 1e-9);
+    EXPECT_EQ(sp.pathTo(6).size(), 3);
+    EXPECT_THROW(AcyclicSP(read_ewd(tinyEWD), 0), std::invalid_argument);
+}
+
+TEST(test_graph, bellman_ford_sp) {
+    std::string negative(tinyEWD);
+    negative.replace(negative.find("6 2 0.40"), 8, "6 2 -1.20");
+    negative.replace(negative.find("6 0 0.58"), 8, "6 0 -1.40");
+    negative.replace(negative.find("6 4 0.93"), 8, "6 4 -1.25");
+    BellmanFordSP sp(read_ewd(negative), 0);
+    EXPECT_FALSE(sp.hasNegativeCycle());
+    const double expected[] = {0.0, 0.93, 0.26, 0.99, 0.26, 0.61, 1.51, 0.60};
+    for (int v = 0; v < 8; ++v)
+        EXPECT_NEAR(sp.distTo(v), expected[v], 1e-9);
+
+    std::string cyclic(tinyEWD);
+    cyclic.replace(cyclic.find("5 4 0.35"), 8, "5 4 -0.66");
+    BellmanFordSP nc(read_ewd(cyclic), 0);
+    ASSERT_TRUE(nc.hasNegativeCycle());
+    double weight = 0;
+    auto cycle = nc.negativeCycle();
+    for (size_t i = 0; i < cycle.size(); ++i) {
+        weight += cycle[i].weight();
+        EXPECT_EQ(cycle[i].to(), cycle[(i + 1) % cycle.size()].from());
+    }
+    EXPECT_LT(weight, 0);
+    EXPECT_THROW((void)nc.distTo(1), std::logic_error);
+}
+
+TEST(test_graph, csr_graph) {
+    auto g = read<Graph>(tinyG);
+    CSRGraph csr(g);
+    EXPECT_EQ(csr.V(), g.V());
+    EXPECT_EQ(csr.E(), g.E());
+    for (int v = 0; v < g.V(); ++v)
+        EXPECT_TRUE(std::ranges::equal(csr.adj(v), g.adj(v)));
+
+    std::vector<std::pair<int, int>> list{{0, 1}, {0, 2}, {2, 1}, {3, 0}};
+    auto dg = CSRGraph::fromEdges(4, list, true);
+    EXPECT_EQ(dg.E(), 4);
+    EXPECT_EQ(dg.degree(0), 2);
+    auto rev = dg.reverse();
+    EXPECT_TRUE(std::ranges::equal(rev.adj(1), std::vector{0, 2}));
+    EXPECT_TRUE(std::ranges::equal(rev.adj(0), std::vector{3}));
+    EXPECT_THROW(CSRGraph::fromEdges(3, list, true), std::out_of_range);
+
+    CSRGraph weighted(read_ewd(tinyEWD));
+    EXPECT_TRUE(weighted.weighted());
+    EXPECT_EQ(weighted.adj(6).size(), weighted.weights(6).size());
+}
+
+TEST(test_graph, traversals_over_csr) {
+    auto g = read<Graph>(tinyG);
+    CSRGraph csr(g);
+    CC cc(g), csrcc(csr);
+    EXPECT_EQ(cc.count(), 3);
+    EXPECT_EQ(csrcc.count(), 3);
+    for (int v = 0; v < g.V(); ++v)
+        EXPECT_EQ(cc.id(v), csrcc.id(v));
+    EXPECT_EQ(DepthFirstSearch(csr, 0).count(), 7);
+    EXPECT_EQ(BreadthFirstPaths(csr, 0).pathTo(3), BreadthFirstPaths(g, 0).pathTo(3));
+
+    auto dg = read<Digraph>(tinyDG);
+    KosarajuSCC scc(dg), csrscc{CSRGraph(dg)};
+    EXPECT_EQ(scc.count(), 5);
+    EXPECT_EQ(csrscc.count(), 5);
+    for (int v = 0; v < dg.V(); ++v)
+        for (int w = 0; w < dg.V(); ++w)
+            EXPECT_EQ(scc.stronglyConnected(v, w), csrscc.stronglyConnected(v, w));
+}
+
+TEST(test_graph, parallel_bfs) {
+    // a path with a dense star in the middle makes the search switch direction twice
+    constexpr int n = 5000;
+    Graph g(n);
+    for (int v = 1; v < n; ++v)
+        g.addEdge(v - 1, v);
+    for (int v = 100; v < n - 100; v += 3)
+        g.addEdge(50, v);
+    BreadthFirstPaths serial(g, 0);
+    for (unsigned threads : {1u, 4u}) {
+        ParallelBFS pbfs(g, 0, threads);
+        for (int v = 0; v < n; ++v) {
+            ASSERT_TRUE(pbfs.hasPathTo(v));
+            EXPECT_EQ(pbfs.pathTo(v).size(), serial.pathTo(v).size());
+        }
+        EXPECT_EQ(pbfs.distTo(n - 1), serial.pathTo(n - 1).size() - 1);
+    }
+
+    auto dg = read<Digraph>(tinyDG);
+    CSRGraph csr(dg);
+    ParallelBFS directed(csr, csr.reverse(), 7, 2);
+    EXPECT_EQ(directed.distTo(1), 3);
+    EXPECT_FALSE(ParallelBFS(csr, csr.reverse(), 1).hasPathTo(0));
+}
+
+TEST(test_graph, iterative_dfs) {
+    auto g = read<Graph>(tinyG);
+    EXPECT_TRUE(Cycle(g).hasCycle());
+    EXPECT_FALSE(TwoColor(g).isBipartite());
+    EXPECT_EQ(DepthFirstPaths(g, 0).pathTo(3).back(), 0);
+    auto dg = read<Digraph>(tinyDG);
+    DirectedCycle dc(dg);
+    ASSERT_TRUE(dc.hasCycle());
+    EXPECT_EQ(dc.cycle().front(), dc.cycle().back());
+    EXPECT_EQ(DepthFirstOrder(dg).pre().size(), dg.V());
+
+    // deep enough to blow an 8MB call stack with one frame per vertex
+    constexpr int n = 1'000'000;
+    Graph path(n);
+    Digraph chain(n);
+    for (int v = 1; v < n; ++v) {
+        path.addEdge(v - 1, v);
+        chain.addEdge(v - 1, v);
+    }
+    EXPECT_EQ(DepthFirstSearch(path, 0).count(), n);
+    EXPECT_EQ(DepthFirstPaths(path, 0).pathTo(n - 1).size(), n);
+    EXPECT_EQ(CC(path).count(), 1);
+    EXPECT_FALSE(Cycle(path).hasCycle());
+    EXPECT_TRUE(TwoColor(path).isBipartite());
+    EXPECT_FALSE(DirectedCycle(chain).hasCycle());
+    EXPECT_EQ(Topological(chain).order().front(), 0);
+    EXPECT_EQ(KosarajuSCC(chain).count(), n);
+    EXPECT_TRUE(DirectedDFS(chain, 0).marked(n - 1));
+}
+
+static Digraph random_digraph(int V, int E, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> vertex(0, V - 1);
+    Digraph g(V);
+    for (int i = 0; i < E; ++i)
+        g.addEdge(vertex(gen), vertex(gen));
+    return g;
+}
+
+TEST(test_graph, reachability_index) {
+    auto tiny = read<Digraph>(tinyDG);
+    TransitiveClosure tc(tiny);
+    EXPECT_TRUE(tc.reachable(7, 1));
+    EXPECT_FALSE(tc.reachable(1, 7));
+    EXPECT_TRUE(tc.reachable(2, 5));
+
+    // sparse enough to leave a DAG of many small components
+    auto g = random_digraph(600, 700, 3);
+    ReachabilityIndex closure(g, ReachabilityIndex::Mode::Closure, 0, 4);
+    ReachabilityIndex labels(g, ReachabilityIndex::Mode::Labels, 3, 4);
+    const auto& dag = closure.condensation();
+    for (int c = 0; c < dag.V(); ++c)
+        for (int d : dag.adj(c))
+            ASSERT_LT(d, c);
+    for (int v = 0; v < g.V(); ++v) {
+        DirectedDFS dfs(g, v);
+        for (int w = 0; w < g.V(); ++w) {
+            ASSERT_EQ(closure.reachable(v, w), dfs.marked(w));
+            ASSERT_EQ(labels.reachable(v, w), dfs.marked(w));
+        }
+    }
+}
+
+template<typename A, typename B>
+static void expect_same_partition(const A& a, const B& b, int V) {
+    ASSERT_EQ(a.count(), b.count());
+    std::vector<int> map(a.count(), -1);
+    for (int v = 0; v < V; ++v) {
+        if (map[a.id(v)] == -1) map[a.id(v)] = b.id(v);
+        ASSERT_EQ(map[a.id(v)], b.id(v));
+    }
+}
+
+TEST(test_graph, tarjan_and_parallel_scc) {
+    auto tiny = read<Digraph>(tinyDG);
+    KosarajuSCC kosaraju(tiny);
+    TarjanSCC tarjan(tiny);
+    expect_same_partition(kosaraju, tarjan, tiny.V());
+    for (int v = 0; v < tiny.V(); ++v)
+        EXPECT_EQ(kosaraju.id(v), tarjan.id(v));     // both number sinks first
+    expect_same_partition(kosaraju, ParallelSCC(tiny, 3), tiny.V());
+
+    for (unsigned seed : {1u, 2u}) {
+        CSRGraph g(random_digraph(3000, 4500, seed));
+        KosarajuSCC expected(g);
+        expect_same_partition(expected, TarjanSCC(g), g.V());
+        expect_same_partition(expected, ParallelSCC(g, 1), g.V());
+        expect_same_partition(expected, ParallelSCC(g, 4), g.V());
+    }
+
+    constexpr int n = 1'000'000;
+    Digraph ring(n);
+    for (int v = 0; v < n; ++v)
+        ring.addEdge(v, (v + 1) % n);
+    EXPECT_EQ(TarjanSCC(ring).count(), 1);
+}
+
+TEST(test_graph, parallel_cc) {
+    auto tiny = read<Graph>(tinyG);
+    expect_same_partition(CC(tiny), ParallelCC(tiny, 2), tiny.V());
+
+    // one big random component plus a scattering of small ones and isolated vertices
+    std::mt19937 gen(5);
+    constexpr int n = 20000;
+    std::uniform_int_distribution<int> big(0, n / 2 - 1), small(n / 2, n - 1);
+    Graph g(n);
+    for (int i = 0; i < n; ++i) g.addEdge(big(gen), big(gen));
+    for (int i = 0; i < n / 4; ++i) g.addEdge(small(gen), small(gen));
+    CC expected(g);
+    CSRGraph csr(g);
+    for (unsigned threads : {1u, 4u}) {
+        ParallelCC cc(csr, threads);
+        expect_same_partition(expected, cc, n);
+        EXPECT_TRUE(cc.connected(0, 1) == expected.connected(0, 1));
+    }
+}
+
+TEST(test_graph, minimum_spanning_tree) {
+    auto tiny = read<EdgeWeightedGraph>(tinyEWG);
+    EXPECT_NEAR(LazyPrimMST(tiny).weight(), 1.81, 1e-9);
+    EXPECT_NEAR(KruskalMST(tiny).weight(), 1.81, 1e-9);
+    const PrimMST prim(tiny);
+    EXPECT_NEAR(prim.weight(), 1.81, 1e-9);
+    EXPECT_EQ(prim.edges().size(), 7);
+    BoruvkaMST boruvka(tiny, 2);
+    EXPECT_NEAR(boruvka.weight(), 1.81, 1e-9);
+    EXPECT_EQ(boruvka.edges().size(), 7);
+    FilterKruskalMST filter(tiny, 2);
+    EXPECT_NEAR(filter.weight(), 1.81, 1e-9);
+    EXPECT_EQ(filter.edges().size(), 7);
+
+    // big enough for filter-Kruskal to recurse; integral weights with many ties keep
+    // the sums exact whatever order the edges are added in
+    std::mt19937 gen(11);
+    constexpr int n = 5000;
+    std::uniform_int_distribution<int> vertex(0, n - 1), weight(1, 100);
+    EdgeWeightedGraph g(n);
+    for (int v = 1; v < n; ++v) g.addEdge({v, vertex(gen) % v, 1000.0});
+    for (int i = 0; i < 20 * n; ++i) g.addEdge({vertex(gen), vertex(gen), double(weight(gen))});
+    const double expected = KruskalMST(g).weight();
+    EXPECT_EQ(LazyPrimMST(g).weight(), expected);
+    EXPECT_EQ(PrimMST(g).weight(), expected);
+    for (unsigned threads : {1u, 4u}) {
+        BoruvkaMST b(g, threads);
+        EXPECT_EQ(b.weight(), expected);
+        EXPECT_EQ(b.edges().size(), n - 1);
+        FilterKruskalMST f(g, threads);
+        EXPECT_EQ(f.weight(), expected);
+        EXPECT_EQ(f.edges().size(), n - 1);
+    }
+
+    // a forest: two components, one isolated vertex
+    EdgeWeightedGraph forest(5);
+    forest.addEdge({0, 1, 1.0});
+    forest.addEdge({2, 3, 2.0});
+    EXPECT_EQ(BoruvkaMST(forest).weight(), 3.0);
+    EXPECT_EQ(FilterKruskalMST(forest).edges().size(), 2);
+    EXPECT_EQ(PrimMST(forest).weight(), 3.0);
+    EXPECT_EQ(PrimMST(forest).edges().size(), 2);
+}
+
+TEST(test_graph, graph_io) {
+    auto tiny = read<Graph>(tinyG);
+    auto list = io::parse(tinyG, 4);
+    ASSERT_EQ(list.V, tiny.V());
+    ASSERT_EQ(list.edges.size(), tiny.E());
+    EXPECT_TRUE(list.weights.empty());
+    Graph bulk(list.V, list.edges);
+    for (int v = 0; v < tiny.V(); ++v)
+        EXPECT_EQ(bulk.adj(v), tiny.adj(v));
+
+    // sorted neighbours, same lists as the serial CSR build
+    CSRGraph built = io::build(list, false, 4);
+    CSRGraph expected(tiny);
+    ASSERT_EQ(built.offsets(), expected.offsets());
+    for (int v = 0; v < tiny.V(); ++v) {
+        std::vector<int> a(built.adj(v).begin(), built.adj(v).end());
+        std::vector<int> b(expected.adj(v).begin(), expected.adj(v).end());
+        std::sort(b.begin(), b.end());
+        EXPECT_EQ(a, b);
+    }
+
+    // a body big enough to be cut into many chunks keeps its line order
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int> vertex(0, 999);
+    std::ostringstream text;
+    std::vector<std::pair<int, int>> edges(100000);
+    text << "# generated\n1000 " << edges.size() << "\n";
+    for (auto& [v, w] : edges) {
+        v = vertex(gen), w = vertex(gen);
+        text << v << (v % 2 ? "\t" : " ") << w << " " << (v + w) / 4.0 << (w % 3 ? "\n" : "\r\n");
+    }
+    auto big = io::parse(text.str(), 4);
+    EXPECT_EQ(big.edges, edges);
+    ASSERT_EQ(big.weights.size(), edges.size());
+    EXPECT_EQ(big.weights[7], (edges[7].first + edges[7].second) / 4.0);
+
+    EXPECT_THROW((void)io::parse("3 2\n0 1\n"), std::invalid_argument);
+    EXPECT_THROW((void)io::parse("3 2\n0 1\n1 3\n"), std::out_of_range);
+    EXPECT_THROW((void)io::parse("3 2\n0 1 0.5\n1 2\n"), std::invalid_argument);
+    EXPECT_THROW((void)io::parse("3 1\n0 x\n"), std::invalid_argument);
+
+    // binary round trips, through a stream and through a mapped file
+    CSRGraph weighted = io::build(big, true, 2);
+    std::stringstream bin;
+    io::writeBinary(weighted, bin);
+    CSRGraph back = io::readBinary(bin);
+    EXPECT_EQ(back.offsets(), weighted.offsets());
+    EXPECT_EQ(back.targets(), weighted.targets());
+    EXPECT_EQ(back.weights(), weighted.weights());
+    EXPECT_TRUE(back.directed());
+
+    const std::string path = (std::filesystem::temp_directory_path() / "algo_test_graph.csr").string();
+    io::writeBinary(expected, path);
+    {
+        io::MappedCSR mapped(path);
+        ASSERT_EQ(mapped.V(), expected.V());
+        EXPECT_EQ(mapped.E(), expected.E());
+        EXPECT_FALSE(mapped.weighted());
+        for (int v = 0; v < expected.V(); ++v)
+            EXPECT_TRUE(std::ranges::equal(mapped.adj(v), expected.adj(v)));
+        CC cc(mapped);
+        EXPECT_EQ(cc.count(), CC(tiny).count());
+    }
+    std::filesystem::remove(path);
+    std::stringstream junk("not a graph at all, not at all");
+    EXPECT_THROW((void)io::readBinary(junk), std::invalid_argument);
+
+    // corrupt files are rejected by both readers instead of read out of bounds: an entry
+    // count whose byte counts wrap, a middle offset past the end, a target out of range
+    std::stringstream good;
+    io::writeBinary(expected, good);
+    const size_t targetsAt = 32 + (expected.V() + 1) * sizeof(uint64_t);
+    for (auto [at, value] : {std::pair{size_t{24}, uint64_t{1} << 62}, {40, uint64_t{1} << 40},
+                             {targetsAt, uint64_t(expected.V())}}) {
+        std::string bytes = good.str();
+        std::memcpy(bytes.data() + at, &value, at == targetsAt ? sizeof(int32_t) : sizeof value);
+        std::stringstream corrupt(bytes);
+        EXPECT_THROW((void)io::readBinary(corrupt), std::invalid_argument) << at;
+        std::ofstream(path, std::ios::binary) << bytes;
+        EXPECT_THROW(io::MappedCSR{path}, std::invalid_argument) << at;
+    }
+    std::filesystem::remove(path);
+
+    auto ewg = read<EdgeWeightedGraph>(tinyEWG);
+    EXPECT_EQ(ewg.V(), 8);
+    EXPECT_EQ(ewg.E(), 16);
+    EXPECT_EQ(ewg.adj(6).size(), 4);
+}
+
+TEST(test_graph, incremental_analyses) {
+    std::mt19937 gen(9);
+    constexpr int n = 300;
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+
+    // undirected: random edges inside the even and the odd vertices alike keep the graph
+    // bipartite only while every edge joins an even vertex to an odd one
+    Graph g(n);
+    for (int i = 0; i < n / 4; ++i) g.addEdge(2 * (vertex(gen) / 2), 2 * (vertex(gen) / 2) + 1);
+    IncrementalCC cc(g);
+    IncrementalBipartite bipartite(g);
+    for (int i = 0; i < n; ++i) {
+        const int v = vertex(gen), w = vertex(gen) | 1;
+        g.addEdge(v & ~1, w);
+        if (i % 30 == 0) {
+            CC expected(g);
+            EXPECT_EQ(cc.count(), expected.count());
+            EXPECT_EQ(cc.connected(v, w), expected.connected(v, w));
+            EXPECT_EQ(cc.hasCycle(), Cycle(g).hasCycle());
+            EXPECT_TRUE(bipartite.isBipartite());
+        }
+    }
+    for (int v = 0; v < n; ++v)
+        for (int w : g.adj(v))
+            EXPECT_NE(bipartite.color(v), bipartite.color(w));
+    g.addEdge(0, 2);
+    g.addEdge(2, 4);
+    EXPECT_EQ(bipartite.isBipartite(), TwoColor(g).isBipartite());
+    {
+        // detaches when it goes, later edges do not touch it
+        IncrementalCC scoped(g);
+    }
+    g.addEdge(1, 3);
+
+    // a parallel edge is a cycle of length 2 for Cycle and IncrementalCC alike, and so is
+    // a self-loop, on a DFS root too
+    Graph path(4);
+    IncrementalCC pathCC(path);
+    path.addEdge(0, 1);
+    path.addEdge(1, 2);
+    EXPECT_FALSE(pathCC.hasCycle());
+    EXPECT_FALSE(Cycle(path).hasCycle());
+    path.addEdge(2, 1);
+    EXPECT_TRUE(pathCC.hasCycle());
+    EXPECT_TRUE(Cycle(path).hasCycle());
+    Graph loop(2);
+    IncrementalCC loopCC(loop);
+    loop.addEdge(0, 0);
+    EXPECT_TRUE(loopCC.hasCycle());
+    EXPECT_TRUE(Cycle(loop).hasCycle());
+
+    // directed: edges from lower to higher ids in random order never close a cycle
+    Digraph dg(n);
+    IncrementalTopological topo(dg);
+    for (int i = 0; i < 4 * n; ++i) {
+        int v = vertex(gen), w = vertex(gen);
+        if (v == w) continue;
+        if (v > w) std::swap(v, w);
+        dg.addEdge(v, w);
+        if (i % 100 == 0) {
+            ASSERT_TRUE(topo.isDAG());
+            for (int x = 0; x < n; ++x)
+                for (int y : dg.adj(x))
+                    ASSERT_LT(topo.rank(x), topo.rank(y));
+        }
+    }
+    auto order = topo.order();
+    ASSERT_EQ(order.size(), n);
+    for (int i = 0; i < n; ++i) EXPECT_EQ(topo.rank(order[i]), i);
+    IncrementalTopological late(dg);
+    EXPECT_TRUE(late.isDAG());
+    dg.addEdge(n - 1, 0);
+    EXPECT_EQ(topo.isDAG(), Topological(dg).isDAG());
+    EXPECT_FALSE(late.isDAG());
+    EXPECT_TRUE(topo.order().empty());
+    EXPECT_THROW((void)topo.rank(0), std::logic_error);
+}
+
+static int bandwidth(const Graph& g) {
+    int width = 0;
+    for (int v = 0; v < g.V(); ++v)
+        for (int w : g.adj(v))
+            width = std::max(width, std::abs(v - w));
+    return width;
+}
+
+TEST(test_graph, vertex_reordering) {
+    EXPECT_THROW(Permutation({0, 0, 1}), std::invalid_argument);
+    Permutation p({2, 0, 1});
+    EXPECT_EQ(p.newId(0), 2);
+    EXPECT_EQ(p.oldId(2), 0);
+    EXPECT_EQ(p.inverse().newId(2), 0);
+    EXPECT_EQ(p.restore(std::vector<char>{'a', 'b', 'c'}), (std::vector<char>{'c', 'a', 'b'}));
+
+    // a path with shuffled ids, a self-loop and a parallel edge
+    std::mt19937 gen(4);
+    constexpr int n = 2000;
+    std::vector<int> id(n);
+    std::iota(id.begin(), id.end(), 0);
+    std::shuffle(id.begin(), id.end(), gen);
+    Graph g(n);
+    for (int i = 0; i + 1 < n; ++i) g.addEdge(id[i], id[i + 1]);
+    g.addEdge(id[7], id[7]);
+    g.addEdge(id[8], id[9]);
+
+    for (const auto& order : {rcmOrder(g), degreeOrder(g), communityOrder(g)}) {
+        Graph r = apply(g, order);
+        ASSERT_EQ(r.E(), g.E());
+        for (int v = 0; v < n; ++v) {
+            std::vector<int> expected;
+            for (int w : g.adj(v)) expected.push_back(order.newId(w));
+            std::sort(expected.begin(), expected.end());
+            EXPECT_EQ(r.adj(order.newId(v)), expected);
+        }
+        BreadthFirstPaths bfs(r, order.newId(id[0]));
+        EXPECT_EQ(bfs.pathTo(order.newId(id[n - 1])).size(), n);
+    }
+    EXPECT_LE(bandwidth(apply(g, rcmOrder(g))), 2);
+    EXPECT_GT(bandwidth(g), 100);
+
+    auto dg = read<Digraph>(tinyDG);
+    const auto order = rcmOrder(dg);
+    auto rd = apply(dg, order);
+    KosarajuSCC before(dg), after(rd);
+    EXPECT_EQ(after.count(), before.count());
+    for (int v = 0; v < dg.V(); ++v)
+        for (int w : dg.adj(v))
+            EXPECT_EQ(before.stronglyConnected(v, w), after.stronglyConnected(order.newId(v), order.newId(w)));
+
+    CSRGraph weighted(read_ewd(tinyEWD));
+    const auto hubs = degreeOrder(weighted);
+    CSRGraph rw = apply(weighted, hubs);
+    EXPECT_EQ(rw.E(), weighted.E());
+    for (int v = 0; v < weighted.V(); ++v) {
+        double sum = 0, mapped = 0;
+        for (double w : weighted.weights(v)) sum += w;
+        for (double w : rw.weights(hubs.newId(v))) mapped += w;
+        EXPECT_DOUBLE_EQ(sum, mapped);
+    }
+}
+
+TEST(test_graph, multi_source_bfs) {
+    auto tiny = read<Graph>(tinyG);
+    std::vector<int> all(tiny.V());
+    std::iota(all.begin(), all.end(), 0);
+    MultiSourceBFS<Graph> small(tiny, all, true);
+    for (int s = 0; s < tiny.V(); ++s) {
+        ParallelBFS<Graph> expected(tiny, s, 1);
+        for (int v = 0; v < tiny.V(); ++v) {
+            EXPECT_EQ(small.distTo(s, v), expected.distTo(v));
+            EXPECT_EQ(small.pathTo(s, v).size(), expected.pathTo(v).size());
+        }
+    }
+    EXPECT_THROW((MultiSourceBFS<Graph>(tiny, std::vector<int>(65, 0))), std::invalid_argument);
+
+    // 300 sources, duplicates included, over batches of 128 on several threads
+    std::mt19937 gen(8);
+    constexpr int n = 3000;
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    Graph g(n);
+    for (int i = 0; i < n; ++i) g.addEdge(vertex(gen), vertex(gen));
+    CSRGraph csr(g);
+    std::vector<int> sources(300);
+    for (int& s : sources) s = vertex(gen);
+    sources[1] = sources[0];
+    std::vector<int> covered(sources.size(), 0);
+    multiSourceBFS<128>(csr, sources, [&](const MultiSourceBFS<CSRGraph, 128>& batch, size_t first) {
+        for (size_t i = 0; i < batch.sources(); i += 7) {
+            ParallelBFS<CSRGraph> expected(csr, batch.source(i), 1);
+            for (int v = 0; v < n; ++v) {
+                ASSERT_EQ(batch.distTo(i, v), expected.distTo(v));
+                if (!batch.hasPathTo(i, v)) continue;
+                auto path = batch.pathTo(i, v);
+                ASSERT_EQ(path.size(), expected.distTo(v) + 1);
+                for (size_t x = 0; x + 1 < path.size(); ++x) {
+                    auto adj = csr.adj(path[x]);
+                    ASSERT_NE(std::find(adj.begin(), adj.end(), path[x + 1]), adj.end());
+                }
+            }
+        }
+        for (size_t i = 0; i < batch.sources(); ++i) covered[first + i] = batch.source(i) == sources[first + i];
+    }, true, 3);
+    EXPECT_EQ(std::count(covered.begin(), covered.end(), 1), sources.size());
+}
+
+TEST(test_graph, point_to_point) {
+    // unweighted: against a full BFS from s, both on a symmetric graph and on a digraph
+    auto tiny = read<Graph>(tinyG);
+    BidirectionalBFS<Graph> bfs(tiny);
+    EXPECT_EQ(bfs.distance(0, 3), 2);
+    EXPECT_EQ(bfs.distance(0, 7), -1);
+    EXPECT_EQ(bfs.path(4, 4), std::vector<int>{4});
+    EXPECT_THROW((void)bfs.distance(0, 13), std::out_of_range);
+
+    const Digraph d = random_digraph(400, 1200, 9);
+    const Digraph r = d.reverse();
+    BidirectionalBFS<Digraph> dbfs(d, r);
+    for (int s = 0; s < d.V(); s += 37) {
+        ParallelBFS<Digraph> expected(d, r, s, 1);
+        for (int t = 0; t < d.V(); t += 3) {
+            ASSERT_EQ(dbfs.distance(s, t), expected.distTo(t));
+            auto path = dbfs.path(s, t);
+            ASSERT_EQ(static_cast<int>(path.size()), expected.distTo(t) + 1);
+            if (path.empty()) continue;
+            EXPECT_EQ(path.front(), s);
+            EXPECT_EQ(path.back(), t);
+            for (size_t x = 0; x + 1 < path.size(); ++x) {
+                auto adj = d.adj(path[x]);
+                ASSERT_NE(std::find(adj.begin(), adj.end(), path[x + 1]), adj.end());
+            }
+        }
+    }
+
+    // weighted: bidirectional Dijkstra and ALT against DijkstraSP
+    std::mt19937 gen(10);
+    constexpr int n = 1000;
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    std::uniform_real_distribution<double> weight(0.0, 1.0);
+    std::vector<DirectedEdge> edges;
+    for (int i = 0; i < 4 * n; ++i) edges.emplace_back(vertex(gen), vertex(gen), weight(gen));
+    const EdgeWeightedDigraph g(n, edges);
+    const Landmarks built(g, 8, 3);
+    std::stringstream stored;
+    built.save(stored);
+    const Landmarks landmarks = Landmarks::load(stored);
+    EXPECT_EQ(landmarks.count(), 8);
+    for (int v = 0; v < n; v += 50)
+        EXPECT_EQ(landmarks.lowerBound(v, 7), built.lowerBound(v, 7));
+
+    BidirectionalDijkstra bidi(g);
+    AStarSearch astar(g, landmarks);
+    auto check = [](const std::vector<DirectedEdge>& path, int s, int t, double distance) {
+        double total = 0;
+        int at = s;
+        for (const auto& e : path) {
+            EXPECT_EQ(e.from(), at);
+            at = e.to();
+            total += e.weight();
+        }
+        EXPECT_EQ(at, t);
+        EXPECT_NEAR(total, distance, 1e-9);
+    };
+    for (int s = 0; s < n; s += 97) {
+        DijkstraSP expected(g, s);
+        for (int t = 0; t < n; t += 13) {
+            const double d = expected.distTo(t);
+            ASSERT_LE(landmarks.lowerBound(s, t), d + 1e-9);
+            if (!expected.hasPathTo(t)) {
+                EXPECT_EQ(bidi.distance(s, t), d);
+                EXPECT_EQ(astar.distance(s, t), d);
+                EXPECT_TRUE(bidi.path(s, t).empty());
+                EXPECT_TRUE(astar.path(s, t).empty());
+                continue;
+            }
+            ASSERT_NEAR(bidi.distance(s, t), d, 1e-9) << s << " -> " << t;
+            ASSERT_NEAR(astar.distance(s, t), d, 1e-9) << s << " -> " << t;
+            check(bidi.path(s, t), s, t, d);
+            check(astar.path(s, t), s, t, d);
+        }
+    }
+
+    std::stringstream garbage("not a landmark table");
+    EXPECT_THROW((void)Landmarks::load(garbage), std::invalid_argument);
+    const EdgeWeightedDigraph other(n + 1);
+    EXPECT_THROW((AStarSearch(other, landmarks)), std::invalid_argument);
+}
+
+TEST(test_graph, contraction_hierarchy) {
+    auto tiny = read_ewd(tinyEWD);
+    ContractionHierarchy small(tiny);
+    CHSearch tinySearch(small);
+    for (int s = 0; s < tiny.V(); ++s) {
+        DijkstraSP expected(tiny, s);
+        for (int t = 0; t < tiny.V(); ++t)
+            EXPECT_NEAR(tinySearch.distance(s, t), expected.distTo(t), 1e-9);
+    }
+
+    // a one-way street grid with random lengths and a few long random links
+    std::mt19937 gen(11);
+    constexpr int side = 25, n = side * side;
+    std::uniform_real_distribution<double> length(1.0, 3.0);
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    std::vector<DirectedEdge> edges;
+    for (int v = 0; v < n; ++v) {
+        if (v % side + 1 < side) edges.emplace_back(v, v + 1, length(gen)), edges.emplace_back(v + 1, v, length(gen));
+        if (v + side < n && v % 3 != 0) edges.emplace_back(v, v + side, length(gen));
+        if (v + side < n && v % 3 != 1) edges.emplace_back(v + side, v, length(gen));
+    }
+    for (int i = 0; i < 20; ++i) edges.emplace_back(vertex(gen), vertex(gen), 10 * length(gen));
+    const EdgeWeightedDigraph g(n, edges);
+    const ContractionHierarchy built(g);
+    std::vector<int> ranks(n);
+    for (int v = 0; v < n; ++v) ranks[v] = built.rank(v);
+    std::sort(ranks.begin(), ranks.end());
+    for (int v = 0; v < n; ++v) ASSERT_EQ(ranks[v], v);
+    for (int v = 0; v < n; ++v) {
+        for (const auto& a : built.up(v)) ASSERT_GT(built.rank(a.to), built.rank(v));
+        for (const auto& a : built.down(v)) ASSERT_GT(built.rank(a.to), built.rank(v));
+    }
+
+    std::stringstream stored;
+    built.save(stored);
+    const ContractionHierarchy ch = ContractionHierarchy::load(stored);
+    EXPECT_EQ(ch.shortcuts(), built.shortcuts());
+    CHSearch search(ch);
+    for (int s = 0; s < n; s += 41) {
+        DijkstraSP expected(g, s);
+        for (int t = 0; t < n; t += 11) {
+            const double d = expected.distTo(t);
+            ASSERT_NEAR(search.distance(s, t), d, 1e-9) << s << " -> " << t;
+            auto path = search.path(s, t);
+            double total = 0;
+            int at = s;
+            for (const auto& e : path) {
+                ASSERT_EQ(e.from(), at);
+                auto adj = g.adj(at);
+                ASSERT_NE(std::find_if(adj.begin(), adj.end(), [&e](const DirectedEdge& f) {
+                    return f.to() == e.to() && f.weight() == e.weight();
+                }), adj.end());
+                at = e.to();
+                total += e.weight();
+            }
+            EXPECT_EQ(at, t);
+            EXPECT_NEAR(total, d, 1e-9);
+        }
+    }
+
+    std::stringstream garbage("not a hierarchy at all, but long enough for a header");
+    EXPECT_THROW((void)ContractionHierarchy::load(garbage), std::invalid_argument);
+    // a header claiming 2^58 upward arcs is caught as truncated, not allocated
+    std::string huge = stored.str();
+    const uint64_t arcs = uint64_t{1} << 58;
+    std::memcpy(huge.data() + 24, &arcs, sizeof arcs);
+    std::stringstream oversized(huge);
+    EXPECT_THROW((void)ContractionHierarchy::load(oversized), std::invalid_argument);
+    EXPECT_THROW((void)search.distance(0, n), std::out_of_range);
+}
+
+TEST(test_graph, vertex_programs) {
+    // the edge-balanced schedule covers every vertex once, hubs included
+    std::vector<std::pair<int, int>> star;
+    for (int v = 1; v < 20000; ++v) star.emplace_back(0, v), star.emplace_back(v % 7, v);
+    const CSRGraph hub = CSRGraph::fromEdges(20000, star, true);
+    std::vector<std::atomic<int>> visits(hub.V());
+    parallel::forEdgeBalanced(hub.offsets(), [&](size_t begin, size_t end, unsigned) {
+        for (size_t v = begin; v < end; ++v) ++visits[v];
+    }, 256, 4);
+    EXPECT_TRUE(std::all_of(visits.begin(), visits.end(), [](const auto& n) { return n.load() == 1; }));
+
+    // against a plain power iteration, on a digraph with dangling vertices
+    std::mt19937 gen(11);
+    constexpr int n = 3000;
+    std::uniform_int_distribution<int> any(0, n - 1);
+    std::vector<std::pair<int, int>> edges;
+    for (int i = 0; i < 6 * n; ++i) {
+        const int v = any(gen);
+        if (v % 10 != 0) edges.emplace_back(v, any(gen) / (1 + i % 3));
+    }
+    const CSRGraph g = CSRGraph::fromEdges(n, edges, true);
+    std::vector<double> expected(n, 1.0 / n);
+    for (int it = 0; it < 200; ++it) {
+        std::vector<double> next(n, 0.0);
+        double dangling = 0;
+        for (int v = 0; v < n; ++v) {
+            if (g.degree(v) == 0) dangling += expected[v];
+            for (int w : g.adj(v)) next[w] += 0.85 * expected[v] / g.degree(v);
+        }
+        for (int v = 0; v < n; ++v) next[v] += (0.15 + 0.85 * dangling) / n;
+        expected.swap(next);
+    }
+    for (unsigned threads : {1u, 4u}) {
+        const VertexProgramEngine engine(g, threads);
+        for (auto mode : {PageRank::Mode::Pull, PageRank::Mode::Push}) {
+            const PageRank pr(engine, 0.85, 1e-12, 200, mode);
+            EXPECT_TRUE(pr.converged());
+            EXPECT_NEAR(std::accumulate(pr.ranks().begin(), pr.ranks().end(), 0.0), 1.0, 1e-9);
+            for (int v = 0; v < n; ++v) ASSERT_NEAR(pr.rank(v), expected[v], 1e-10);
+        }
+    }
+    const PageRank capped(VertexProgramEngine(g), 0.85, 0, 3);
+    EXPECT_EQ(capped.iterations(), 3);
+    EXPECT_FALSE(capped.converged());
+
+    // a cycle is uniform; personalized rank never leaves what the seeds reach
+    Digraph cycle(3);
+    cycle.addEdge(0, 1), cycle.addEdge(1, 2), cycle.addEdge(2, 0);
+    const CSRGraph ring(cycle);
+    const PageRank uniform((VertexProgramEngine(ring)));
+    for (double r : uniform.ranks()) EXPECT_NEAR(r, 1.0 / 3, 1e-9);
+    Digraph split(5);
+    split.addEdge(0, 1), split.addEdge(1, 2), split.addEdge(3, 4), split.addEdge(4, 0);
+    const CSRGraph halves(split);
+    const std::vector<int> seeds{0};
+    const PageRank personal(VertexProgramEngine(halves), seeds);
+    EXPECT_GT(personal.rank(0), personal.rank(1));
+    EXPECT_GT(personal.rank(1), 0);
+    EXPECT_EQ(personal.rank(3), 0);
+    EXPECT_EQ(personal.rank(4), 0);
+    EXPECT_THROW(PageRank(VertexProgramEngine(halves), std::vector<int>{7}), std::out_of_range);
+    EXPECT_THROW(PageRank(VertexProgramEngine(halves), 1.0), std::invalid_argument);
+
+    // two cliques joined by one edge, and a loner
+    Graph cliques(21);
+    for (int v = 0; v < 10; ++v)
+        for (int w = v + 1; w < 10; ++w) cliques.addEdge(v, w), cliques.addEdge(v + 10, w + 10);
+    cliques.addEdge(9, 10);
+    const CSRGraph groups(cliques);
+    const LabelPropagation lp(VertexProgramEngine(groups, 1));
+    EXPECT_EQ(lp.count(), 3);
+    EXPECT_TRUE(lp.connected(0, 9));
+    EXPECT_TRUE(lp.connected(10, 19));
+    EXPECT_FALSE(lp.connected(0, 19));
+    const LabelPropagation big(VertexProgramEngine(g, 1)), parallel(VertexProgramEngine(g, 4));
+    EXPECT_EQ(big.count(), parallel.count());
+    for (int v = 0; v < n; ++v) ASSERT_EQ(big.id(v), parallel.id(v));
+}
+
+TEST(test_graph, triangles_and_cores) {
+    // K4 with a pendant: four triangles, every K4 vertex in three; the pendant is a 1-core
+    Graph k4(5);
+    for (int v = 0; v < 4; ++v)
+        for (int w = v + 1; w < 4; ++w) k4.addEdge(v, w);
+    k4.addEdge(3, 4);
+    const TriangleCount small(k4);
+    EXPECT_EQ(small.total(), 4u);
+    EXPECT_EQ(small.count(0), 3u);
+    EXPECT_EQ(small.count(4), 0u);
+    EXPECT_DOUBLE_EQ(small.clustering(0), 1.0);
+    EXPECT_DOUBLE_EQ(small.clustering(3), 0.5);
+    EXPECT_DOUBLE_EQ(small.transitivity(), 12.0 / 15);
+    const CoreDecomposition shells(k4);
+    EXPECT_EQ(shells.maxCore(), 3);
+    EXPECT_EQ(shells.core(4), 1);
+    EXPECT_EQ(shells.kCore(3), (std::vector<int>{0, 1, 2, 3}));
+
+    // against brute force on a random graph with parallel edges and self-loops, skewed so
+    // that a few hubs collect most edges
+    std::mt19937 gen(5);
+    constexpr int n = 600;
+    std::uniform_int_distribution<int> any(0, n - 1);
+    std::vector<std::pair<int, int>> edges;
+    for (int i = 0; i < 8 * n; ++i) edges.emplace_back(any(gen) / (1 + i % 4), any(gen));
+    const Graph g(n, edges);
+    std::vector<std::set<int>> neighbours(n);
+    for (auto [v, w] : edges)
+        if (v != w) neighbours[v].insert(w), neighbours[w].insert(v);
+    uint64_t expected = 0;
+    std::vector<uint64_t> at(n, 0);
+    for (int v = 0; v < n; ++v)
+        for (int u : neighbours[v])
+            for (int w : neighbours[u])
+                if (v < u && u < w && neighbours[v].count(w)) ++expected, ++at[v], ++at[u], ++at[w];
+    const CSRGraph csr(g);
+    EXPECT_EQ(countTriangles(g), expected);
+    for (unsigned threads : {1u, 4u}) {
+        EXPECT_EQ(countTriangles(csr, threads), expected);
+        const TriangleCount t(csr, threads);
+        EXPECT_EQ(t.total(), expected);
+        EXPECT_EQ(t.counts(), at);
+    }
+
+    // cores by repeatedly deleting every vertex of degree below k, parallel edges counted
+    std::vector<int> degree(n, 0), core(n, 0);
+    for (auto [v, w] : edges)
+        if (v != w) ++degree[v], ++degree[w];
+    std::vector<bool> removed(n, false);
+    for (int k = 1, left = n; left; ++k) {
+        for (bool again = true; again;) {
+            again = false;
+            for (int v = 0; v < n; ++v) {
+                if (removed[v] || degree[v] >= k) continue;
+                removed[v] = true, again = true, --left;
+                core[v] = k - 1;
+                for (int w : g.adj(v))
+                    if (w != v) --degree[w];
+            }
+        }
+    }
+    for (unsigned threads : {1u, 4u}) EXPECT_EQ(CoreDecomposition(csr, threads).cores(), core);
+    EXPECT_EQ(countTriangles(CSRGraph(Graph(0))), 0u);
+    EXPECT_EQ(CoreDecomposition(Graph(3), 4).maxCore(), 0);
+    EXPECT_THROW(CoreDecomposition(CSRGraph(Digraph(2))), std::invalid_argument);
+    EXPECT_THROW(TriangleCount(CSRGraph(Digraph(2))), std::invalid_argument);
+}
+
+TEST(test_graph, max_flow_and_matching) {
+    // tinyFN from Algorithms, 4th ed.: value 4; the largest minimum cut is {0, 1, 2, 3}
+    FlowNetwork tiny(6);
+    for (auto [v, w, c] : {std::tuple{0, 1, 2}, {0, 2, 3}, {1, 3, 3}, {1, 4, 1}, {2, 3, 1}, {2, 4, 1}, {3, 5, 2},
+                           {4, 5, 3}})
+        tiny.addEdge({v, w, c});
+    const MaxFlow small(tiny, 0, 5);
+    EXPECT_EQ(small.value(), 4);
+    EXPECT_TRUE(small.inCut(0));
+    EXPECT_TRUE(small.inCut(3));
+    EXPECT_FALSE(small.inCut(4));
+    EXPECT_FALSE(small.inCut(5));
+    EXPECT_EQ(small.cut(tiny), (std::vector<int>{3, 5, 6}));
+
+    // against Edmonds-Karp on a capacity matrix, with parallel and antiparallel edges
+    std::mt19937 gen(3);
+    for (int round = 0; round < 20; ++round) {
+        const int n = 40 + round;
+        std::uniform_int_distribution<int> any(0, n - 1), capacity(0, 20);
+        std::vector<FlowEdge> edges;
+        std::vector<std::vector<int64_t>> residual(n, std::vector<int64_t>(n, 0));
+        for (int i = 0; i < 5 * n; ++i) {
+            const int v = any(gen), w = any(gen), c = capacity(gen);
+            edges.emplace_back(v, w, c);
+            if (v != w) residual[v][w] += c;
+        }
+        const FlowNetwork g(n, edges);
+        if (round == 0) {
+            // edges added one at a time land exactly where the bulk constructor puts them
+            FlowNetwork added(n);
+            for (const auto& e : edges) added.addEdge(e);
+            EXPECT_EQ(added.offsets(), g.offsets());
+            EXPECT_EQ(added.heads(), g.heads());
+            EXPECT_EQ(added.mates(), g.mates());
+            EXPECT_EQ(added.capacities(), g.capacities());
+            for (int e = 0; e < g.E(); ++e) ASSERT_EQ(added.arc(e), g.arc(e));
+        }
+        const int s = 0, t = n - 1;
+        int64_t expected = 0;
+        for (;;) {
+            std::vector<int> parent(n, -1);
+            parent[s] = s;
+            std::vector<int> queue{s};
+            for (size_t i = 0; i < queue.size() && parent[t] < 0; ++i)
+                for (int w = 0; w < n; ++w)
+                    if (parent[w] < 0 && residual[queue[i]][w] > 0) parent[w] = queue[i], queue.push_back(w);
+            if (parent[t] < 0) break;
+            int64_t bottleneck = std::numeric_limits<int64_t>::max();
+            for (int w = t; w != s; w = parent[w]) bottleneck = std::min(bottleneck, residual[parent[w]][w]);
+            for (int w = t; w != s; w = parent[w]) residual[parent[w]][w] -= bottleneck, residual[w][parent[w]] += bottleneck;
+            expected += bottleneck;
+        }
+        const MaxFlow flow(g, s, t);
+        ASSERT_EQ(flow.value(), expected);
+        std::vector<int64_t> balance(n, 0);
+        for (int e = 0; e < g.E(); ++e) {
+            ASSERT_GE(flow.flow(e), 0);
+            ASSERT_LE(flow.flow(e), g.edge(e).capacity());
+            balance[g.edge(e).from()] -= flow.flow(e);
+            balance[g.edge(e).to()] += flow.flow(e);
+        }
+        EXPECT_EQ(balance[t], expected);
+        EXPECT_EQ(balance[s], -expected);
+        for (int v = 1; v < n - 1; ++v) ASSERT_EQ(balance[v], 0);
+        int64_t across = 0;
+        for (int e : flow.cut(g)) {
+            EXPECT_EQ(flow.flow(e), g.edge(e).capacity());
+            across += g.edge(e).capacity();
+        }
+        EXPECT_EQ(across, expected);
+        EXPECT_TRUE(flow.inCut(s));
+        EXPECT_FALSE(flow.inCut(t));
+    }
+    EXPECT_THROW(MaxFlow(tiny, 0, 0), std::invalid_argument);
+    EXPECT_THROW(MaxFlow(tiny, 0, 6), std::out_of_range);
+    EXPECT_THROW(tiny.addEdge({0, 1, -1}), std::invalid_argument);
+    EXPECT_THROW(tiny.addEdge({0, 6, 1}), std::out_of_range);
+
+    // matchings against the unit-capacity flow reduction, sides given by TwoColor
+    for (int round = 0; round < 10; ++round) {
+        const int n = 30 + 7 * round;
+        std::uniform_int_distribution<int> any(0, n - 1);
+        Graph g(2 * n);
+        for (int i = 0; i < 2 * n; ++i) g.addEdge(any(gen), n + any(gen) / (1 + round % 3));
+        const BipartiteMatching matching(g);
+        const TwoColor sides(g);
+        FlowNetwork reduction(2 * n + 2);
+        const int s = 2 * n, t = 2 * n + 1;
+        for (int v = 0; v < 2 * n; ++v) {
+            if (sides.color(v)) reduction.addEdge({v, t, 1});
+            else {
+                reduction.addEdge({s, v, 1});
+                for (int w : g.adj(v)) reduction.addEdge({v, w, 1});
+            }
+        }
+        ASSERT_EQ(matching.size(), MaxFlow(reduction, s, t).value());
+        int matched = 0;
+        for (int v = 0; v < 2 * n; ++v) {
+            if (!matching.isMatched(v)) continue;
+            ++matched;
+            const int w = matching.mate(v);
+            ASSERT_EQ(matching.mate(w), v);
+            ASSERT_NE(sides.color(v), sides.color(w));
+            const auto& adj = g.adj(v);
+            ASSERT_NE(std::find(adj.begin(), adj.end(), w), adj.end());
+        }
+        EXPECT_EQ(matched, 2 * matching.size());
+    }
+    Graph triangle(3);
+    triangle.addEdge(0, 1), triangle.addEdge(1, 2), triangle.addEdge(2, 0);
+    EXPECT_THROW(BipartiteMatching{triangle}, std::invalid_argument);
+    EXPECT_EQ(BipartiteMatching(Graph(4)).size(), 0);
+}
@@ -0,0 +1,182 @@
+#include "vertex_program.h"
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+
+namespace graph {
+    namespace {
+        // one per thread, a cache line each, so that threads do not share what they add to
+        struct alignas(64) Sum {
+            double value = 0;
+            size_t count = 0;
+        };
+
+        double total(const std::vector<Sum>& sums) {
+            double s = 0;
+            for (const auto& x : sums) s += x.value;
+            return s;
+        }
+    }
+
+    VertexProgramEngine::VertexProgramEngine(const CSRGraph& g, unsigned threads)
+            : g_(g)
+            , threads_(parallel::threads(threads))
+    {
+        if (g.directed()) reversed_.emplace(g.reverse());
+    }
+
+    PageRank::PageRank(const VertexProgramEngine& engine, double damping, double tolerance, int maxIterations,
+                       Mode mode) {
+        run(engine, {}, damping, tolerance, maxIterations, mode);
+    }
+
+    PageRank::PageRank(const VertexProgramEngine& engine, std::span<const int> seeds, double damping,
+                       double tolerance, int maxIterations, Mode mode) {
+        if (seeds.empty()) throw std::invalid_argument("Personalized PageRank needs a seed vertex");
+        std::vector<double> teleport(engine.V(), 0.0);
+        for (int s : seeds) {
+            if (s < 0 || s >= engine.V()) throw std::out_of_range("Vertex is out of boundaries");
+            teleport[s] += 1.0 / static_cast<double>(seeds.size());
+        }
+        run(engine, teleport, damping, tolerance, maxIterations, mode);
+    }
+
+    // an empty teleport vector stands for the uniform one
+    void PageRank::run(const VertexProgramEngine& engine, const std::vector<double>& teleport, double damping,
+                       double tolerance, int maxIterations, Mode mode) {
+        if (!(damping >= 0 && damping < 1)) throw std::invalid_argument("Damping must be in [0, 1)");
+        const int V = engine.V();
+        if (V == 0) return;
+        const double uniform = 1.0 / V;
+        const auto& offsets = engine.out().offsets();
+        rank_ = teleport.empty() ? std::vector<double>(V, uniform) : teleport;
+        std::vector<double> share(V), next(V);
+        std::vector<Sum> sums(engine.threads());
+
+        while (iterations_ < maxIterations) {
+            for (auto& s : sums) s = {};
+            engine.forVertices([&](size_t begin, size_t end, unsigned tid) {
+                for (size_t v = begin; v < end; ++v) {
+                    const size_t degree = offsets[v + 1] - offsets[v];
+                    share[v] = degree ? damping * rank_[v] / static_cast<double>(degree) : 0.0;
+                    if (!degree) sums[tid].value += rank_[v];
+                }
+            });
+            const double base = 1 - damping + damping * total(sums);
+            for (auto& s : sums) s = {};
+            if (mode == Mode::Pull) {
+                engine.pull([&](int v, std::span<const int> in, unsigned tid) {
+                    double sum = 0;
+                    for (int u : in) sum += share[u];
+                    next[v] = base * (teleport.empty() ? uniform : teleport[v]) + sum;
+                    sums[tid].value += std::abs(next[v] - rank_[v]);
+                });
+            } else {
+                engine.forVertices([&](size_t begin, size_t end, unsigned) {
+                    std::fill(next.begin() + static_cast<ptrdiff_t>(begin), next.begin() + static_cast<ptrdiff_t>(end), 0.0);
+                });
+                engine.push([&](int u, std::span<const int> out, unsigned) {
+                    if (share[u] == 0) return;
+                    for (int w : out) VertexProgramEngine::atomicAdd(next[w], share[u]);
+                });
+                engine.forVertices([&](size_t begin, size_t end, unsigned tid) {
+                    for (size_t v = begin; v < end; ++v) {
+                        next[v] += base * (teleport.empty() ? uniform : teleport[v]);
+                        sums[tid].value += std::abs(next[v] - rank_[v]);
+                    }
+                });
+            }
+            rank_.swap(next);
+            ++iterations_;
+            delta_ = total(sums);
+            if (delta_ < tolerance) {
+                converged_ = true;
+                break;
+            }
+        }
+    }
+
+    double PageRank::rank(int v) const {
+        return rank_.at(v);
+    }
+
+    const std::vector<double>& PageRank::ranks() const noexcept {
+        return rank_;
+    }
+
+    int PageRank::iterations() const noexcept {
+        return iterations_;
+    }
+
+    bool PageRank::converged() const noexcept {
+        return converged_;
+    }
+
+    double PageRank::delta() const noexcept {
+        return delta_;
+    }
+
+    LabelPropagation::LabelPropagation(const VertexProgramEngine& engine, int maxIterations)
+            : id_(engine.V())
+    {
+        const int V = engine.V();
+        const bool directed = engine.out().directed();
+        std::vector<int> label(V), next(V);
+        for (int v = 0; v < V; ++v) label[v] = v;
+        std::vector<std::vector<int>> scratch(engine.threads());
+        std::vector<Sum> changed(engine.threads());
+
+        while (iterations_ < maxIterations) {
+            for (auto& c : changed) c = {};
+            engine.pull([&](int v, std::span<const int> in, unsigned tid) {
+                auto& seen = scratch[tid];
+                seen.assign(1, label[v]);
+                for (int u : in) seen.push_back(label[u]);
+                if (directed)
+                    for (int w : engine.out().adj(v)) seen.push_back(label[w]);
+                std::sort(seen.begin(), seen.end());
+                // runs in ascending order: the first longest one is the smallest label
+                int best = seen[0];
+                size_t bestRun = 0;
+                for (size_t i = 0; i < seen.size();) {
+                    size_t j = i;
+                    while (j < seen.size() && seen[j] == seen[i]) ++j;
+                    if (j - i > bestRun) {
+                        bestRun = j - i;
+                        best = seen[i];
+                    }
+                    i = j;
+                }
+                next[v] = best;
+                if (best != label[v]) ++changed[tid].count;
+            });
+            label.swap(next);
+            ++iterations_;
+            size_t moved = 0;
+            for (const auto& c : changed) moved += c.count;
+            if (moved == 0) break;
+        }
+
+        std::vector<int> number(V, -1);
+        for (int v = 0; v < V; ++v) {
+            if (number[label[v]] < 0) number[label[v]] = count_++;
+            id_[v] = number[label[v]];
+        }
+    }
+
+    int LabelPropagation::id(int v) const {
+        return id_.at(v);
+    }
+
+    int LabelPropagation::count() const noexcept {
+        return count_;
+    }
+
+    bool LabelPropagation::connected(int v, int w) const {
+        return id_.at(v) == id_.at(w);
+    }
+
+    int LabelPropagation::iterations() const noexcept {
+        return iterations_;
+    }
+}
@@ -0,0 +1,144 @@
+#ifndef ALGO_VERTEX_PROGRAM_H
+#define ALGO_VERTEX_PROGRAM_H
+#include <span>
+#include <atomic>
+#include <vector>
+#include <optional>
+#include "csr.h"
+#include "parallel.h"
+
+namespace graph {
+    /** Vertex-program engine ********************************************************
+     * Runs one step of a vertex program over a frozen graph, in either direction:
+     *   pull(f)  calls f(v, in-neighbours of v, tid) for every v; f reads its neighbours'
+     *            state and writes only v's, so it needs no synchronisation. In-edges come
+     *            from reverse(), built once per engine for a directed graph.
+     *   push(f)  calls f(u, out-neighbours of u, tid) for every u; f writes to neighbours,
+     *            which other threads write too, so it goes through atomicAdd() or the like.
+     * Pull reads scattered state and writes sequentially, push the other way round; pull
+     * suits steps where every vertex is busy, push the ones where few vertices have
+     * anything to send. Both split the vertices into chunks of about `grain` edges
+     * (parallel::forEdgeBalanced), so a power-law hub does not hold up a whole thread's
+     * share. Every call is a barrier.
+     */
+    class VertexProgramEngine {
+    private:
+        const CSRGraph& g_;
+        std::optional<CSRGraph> reversed_;
+        unsigned threads_;
+
+    public:
+        static constexpr size_t grain = 4096;
+
+        explicit VertexProgramEngine(const CSRGraph& g, unsigned threads = 0);
+
+        [[nodiscard]]
+        int V() const noexcept { return g_.V(); }
+        [[nodiscard]]
+        const CSRGraph& out() const noexcept { return g_; }
+        [[nodiscard]]
+        const CSRGraph& in() const noexcept { return reversed_ ? *reversed_ : g_; }
+        [[nodiscard]]
+        unsigned threads() const noexcept { return threads_; }
+
+        template<typename F>
+        void pull(F&& f) const {
+            run(in(), f);
+        }
+        template<typename F>
+        void push(F&& f) const {
+            run(out(), f);
+        }
+        // f(begin, end, tid) over all vertices in plain chunks, for the per-vertex steps
+        // between pulls and pushes
+        template<typename F>
+        void forVertices(F&& f) const {
+            parallel::forRange(static_cast<size_t>(V()), f, grain, threads_);
+        }
+
+        template<typename T>
+        static void atomicAdd(T& target, T x) noexcept {
+            std::atomic_ref<T>(target).fetch_add(x, std::memory_order_relaxed);
+        }
+
+    private:
+        template<typename F>
+        void run(const CSRGraph& g, F& f) const {
+            parallel::forEdgeBalanced(g.offsets(), [&](size_t begin, size_t end, unsigned tid) {
+                for (size_t v = begin; v < end; ++v) f(static_cast<int>(v), g.adj(static_cast<int>(v)), tid);
+            }, grain, threads_);
+        }
+    };
+
+    /** PageRank by power iteration on the vertex-program engine ***********************
+     * Each iteration every vertex u sends damping * rank(u) / outdegree(u) along its
+     * out-edges, and every vertex gets back (1 - damping) of the teleport distribution;
+     * so does the rank of the dangling vertices, which have no edge to send it along.
+     * Ranks sum to 1. Iterations stop when the ranks move less than `tolerance` in L1
+     * norm or after maxIterations.
+     * Personalized PageRank teleports to the seed vertices only, evenly, instead of to
+     * every vertex: rank then measures closeness to the seeds.
+     * Mode::Pull sums over in-edges, Mode::Push adds into neighbours atomically; the two
+     * agree up to rounding.
+     */
+    class PageRank {
+    public:
+        enum class Mode { Pull, Push };
+
+    private:
+        std::vector<double> rank_;
+        int iterations_ = 0;
+        double delta_ = 0;
+        bool converged_ = false;
+
+    public:
+        explicit PageRank(const VertexProgramEngine& engine, double damping = 0.85, double tolerance = 1e-6,
+                          int maxIterations = 100, Mode mode = Mode::Pull);
+        PageRank(const VertexProgramEngine& engine, std::span<const int> seeds, double damping = 0.85,
+                 double tolerance = 1e-6, int maxIterations = 100, Mode mode = Mode::Pull);
+        [[nodiscard]]
+        double rank(int v) const;
+        [[nodiscard]]
+        const std::vector<double>& ranks() const noexcept;
+        [[nodiscard]]
+        int iterations() const noexcept;
+        [[nodiscard]]
+        bool converged() const noexcept;
+        // the L1 change of the last iteration
+        [[nodiscard]]
+        double delta() const noexcept;
+
+    private:
+        void run(const VertexProgramEngine& engine, const std::vector<double>& teleport, double damping,
+                 double tolerance, int maxIterations, Mode mode);
+    };
+
+    /** Community detection by label propagation (Raghavan, Albert, Kumara) ***************
+     * Every vertex starts in a community of its own; each round every vertex takes the
+     * label most common among itself and its neighbours, edges counted in both
+     * directions, ties going to the smallest label. Rounds are synchronous, every vertex
+     * reading the labels of the round before, so the result does not depend on the thread
+     * count. Stops when a round changes nothing or after maxIterations; dense groups
+     * settle within a few rounds. Ids are dense in [0, count()), numbered in order of their
+     * smallest vertex.
+     */
+    class LabelPropagation {
+    private:
+        std::vector<int> id_;
+        int count_ = 0;
+        int iterations_ = 0;
+
+    public:
+        explicit LabelPropagation(const VertexProgramEngine& engine, int maxIterations = 20);
+        [[nodiscard]]
+        int id(int v) const;
+        [[nodiscard]]
+        int count() const noexcept;
+        [[nodiscard]]
+        bool connected(int v, int w) const;
+        [[nodiscard]]
+        int iterations() const noexcept;
+    };
+}
+
+#endif //ALGO_VERTEX_PROGRAM_H
@@ -0,0 +1,372 @@
+// Symbol table benchmarks: plain chrono timings, ns per operation on random 64-bit keys.
+//   bench_symbol_tables [max [threads]]    largest table, default 1e7 (1e8 needs ~10 GB for
+//                                          std::unordered_map); threads default to all cores
+// Hash maps: insert, hit and miss. Ordered tables: insert, hit, and a scan of the 100
+// entries from a random key on; the B+-tree is also bulk loaded from sorted keys.
+// The red-black tree keeps its nodes in one arena with 32-bit links.
+// String keys: bytes per key and ns per hit on synthetic URLs, min(max, 1e6) of them, for
+// the tries against std::map<std::string, int> counted through its allocator.
+// Static table: build and lookups on min(max, 1e7) keys, the size of its perfect hash,
+// and the time to open its file again against building a FlatHashMap of the same keys.
+// Filters: on the same keys, build time, bits per key, false positive rate, and ns per
+// query one at a time and in batches, all on absent keys.
+// Concurrent maps: million operations per second over all threads for read/write mixes
+// on a table of min(max, 1e6) keys, against std::unordered_map behind a shared_mutex.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+#include <optional>
+#include <random>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <thread>
+#include <filesystem>
+#include <shared_mutex>
+#include <unordered_map>
+#include "symbol_tables.h"
+
+using namespace symbol_tables;
+
+static uint64_t splitmix(uint64_t& state) {
+    uint64_t z = state += 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+template<typename F>
+static double nsPerOp(size_t ops, F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const std::chrono::duration<double> took = std::chrono::steady_clock::now() - start;
+    return took.count() * 1e9 / static_cast<double>(ops);
+}
+
+// insert all keys into an empty map, then look every key up in another order (hits) and
+// as many absent keys (misses), repeated up to a million lookups for the small tables;
+// the other order keeps node-based maps from walking their nodes in allocation order
+template<typename Map>
+static void row(const char* name, const std::vector<uint64_t>& keys, const std::vector<uint64_t>& shuffled,
+                const std::vector<uint64_t>& absent) {
+    const size_t n = keys.size();
+    const size_t rounds = std::max<size_t>(1, 1000000 / n);
+    uint64_t sink = 0;
+    Map map;
+    const double insert = nsPerOp(n, [&] {
+        for (uint64_t k : keys) map[k] = k;
+    });
+    const double hit = nsPerOp(n * rounds, [&] {
+        for (size_t r = 0; r < rounds; ++r)
+            for (uint64_t k : shuffled) sink += map.find(k)->second;
+    });
+    const double miss = nsPerOp(n * rounds, [&] {
+        for (size_t r = 0; r < rounds; ++r)
+            for (uint64_t k : absent) sink += map.find(k) == map.end();
+    });
+    std::printf("%10zu %-16s %10.1f %10.1f %10.1f%s\n", n, name, insert, hit, miss, sink == 1 ? "!" : "");
+}
+
+template<typename Map>
+static void orderedRow(const char* name, const std::vector<uint64_t>& keys, const std::vector<uint64_t>& shuffled,
+                       Map& map, double insert) {
+    const size_t n = keys.size();
+    const size_t rounds = std::max<size_t>(1, 1000000 / n);
+    uint64_t sink = 0;
+    const double hit = nsPerOp(n * rounds, [&] {
+        for (size_t r = 0; r < rounds; ++r)
+            for (uint64_t k : shuffled) sink += (*map.find(k)).second;
+    });
+    const size_t scans = std::min<size_t>(n, 100000);
+    const double scan = nsPerOp(scans, [&] {
+        for (size_t i = 0; i < scans; ++i) {
+            auto it = map.lower_bound(shuffled[i]);
+            for (int j = 0; j < 100 && it != map.end(); ++j, ++it) sink += (*it).second;
+        }
+    });
+    std::printf("%10zu %-16s %10.1f %10.1f %10.1f%s\n", n, name, insert, hit, scan, sink == 1 ? "!" : "");
+}
+
+template<typename Map>
+static void orderedRow(const char* name, const std::vector<uint64_t>& keys, const std::vector<uint64_t>& shuffled) {
+    Map map;
+    const double insert = nsPerOp(keys.size(), [&] {
+        for (uint64_t k : keys) map[k] = k;
+    });
+    orderedRow(name, keys, shuffled, map, insert);
+}
+
+// the red-black tree has no iterators: a scan asks for the keys between a key and the
+// one 99 ranks above it
+static void redBlackRow(const std::vector<uint64_t>& keys, const std::vector<uint64_t>& shuffled) {
+    const size_t n = keys.size();
+    const size_t rounds = std::max<size_t>(1, 1000000 / n);
+    uint64_t sink = 0;
+    RedBlackBST<uint64_t, uint64_t> tree;
+    const double insert = nsPerOp(n, [&] {
+        for (uint64_t k : keys) tree.put(k, k);
+    });
+    const double hit = nsPerOp(n * rounds, [&] {
+        for (size_t r = 0; r < rounds; ++r)
+            for (uint64_t k : shuffled) sink += *tree.get(k);
+    });
+    const size_t scans = std::min<size_t>(n, 100000);
+    const double scan = nsPerOp(scans, [&] {
+        for (size_t i = 0; i < scans; ++i) {
+            const uint64_t hi = tree.select(std::min(tree.rank(shuffled[i]) + 99, n - 1));
+            for (uint64_t k : tree.keys(shuffled[i], hi)) sink += k;
+        }
+    });
+    std::printf("%10zu %-16s %10.1f %10.1f %10.1f%s\n", n, "RedBlackBST", insert, hit, scan, sink == 1 ? "!" : "");
+}
+
+// Hosts, directories and file names drawn from small pools, as crawled URLs share them:
+// about 50 bytes a key
+static std::vector<std::string> urls(size_t n) {
+    static const char* words[] = {"news", "shop", "blog", "data", "open", "cloud", "city", "green",
+                                  "media", "tech", "home", "travel", "food", "music", "sport", "art"};
+    uint64_t state = 11;
+    auto word = [&] { return std::string(words[splitmix(state) % 16]); };
+    std::vector<std::string> out(n);
+    for (auto& url : out) {
+        const uint64_t host = splitmix(state) % (n / 50 + 1);
+        url = "https://www." + std::string(words[host % 16]) + std::string(words[host / 16 % 16])
+              + std::to_string(host / 256) + ".com/" + word() + "/" + word() + "/" + std::to_string(splitmix(state) % 100000)
+              + ".html";
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    std::shuffle(out.begin(), out.end(), std::mt19937_64(n));
+    return out;
+}
+
+static size_t allocated = 0;
+
+template<typename T>
+struct Counting {
+    using value_type = T;
+    Counting() = default;
+    template<typename U>
+    Counting(const Counting<U>&) {}
+    T* allocate(size_t n) {
+        allocated += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, size_t n) {
+        allocated -= n * sizeof(T);
+        std::allocator<T>().deallocate(p, n);
+    }
+    bool operator==(const Counting&) const = default;
+};
+
+template<typename Trie>
+static void stringRow(const char* name, const std::vector<std::string>& keys) {
+    uint64_t sink = 0;
+    Trie trie;
+    const double insert = nsPerOp(keys.size(), [&] {
+        for (size_t i = 0; i < keys.size(); ++i) trie.put(keys[i], static_cast<int>(i));
+    });
+    const double hit = nsPerOp(keys.size(), [&] {
+        for (size_t i = keys.size(); i-- > 0;) sink += *trie.get(keys[i]);
+    });
+    std::printf("%10zu %-16s %10.1f %10.1f %10.1f%s\n", keys.size(), name, insert, hit,
+                static_cast<double>(trie.memory()) / static_cast<double>(keys.size()), sink == 1 ? "!" : "");
+}
+
+static void stringMapRow(const std::vector<std::string>& keys) {
+    using String = std::basic_string<char, std::char_traits<char>, Counting<char>>;
+    std::vector<String> counted(keys.begin(), keys.end());
+    uint64_t sink = 0;
+    allocated = 0;
+    {
+        std::map<String, int, std::less<>, Counting<std::pair<const String, int>>> map;
+        const double insert = nsPerOp(keys.size(), [&] {
+            for (size_t i = 0; i < keys.size(); ++i) map.emplace(counted[i], static_cast<int>(i));
+        });
+        const double hit = nsPerOp(keys.size(), [&] {
+            for (size_t i = keys.size(); i-- > 0;) sink += map.find(counted[i])->second;
+        });
+        std::printf("%10zu %-16s %10.1f %10.1f %10.1f%s\n", keys.size(), "map<string>", insert, hit,
+                    static_cast<double>(allocated) / static_cast<double>(keys.size()), sink == 1 ? "!" : "");
+    }
+}
+
+// a read looks up a random key of the key space, half of which is in the table; a write
+// inserts or erases one, at random, so the size stays put
+struct LockedMap {
+    mutable std::shared_mutex lock;
+    std::unordered_map<uint64_t, uint64_t> map;
+
+    bool contains(uint64_t k) const {
+        std::shared_lock guard(lock);
+        return map.count(k) != 0;
+    }
+    void insert_or_assign(uint64_t k, uint64_t v) {
+        std::unique_lock guard(lock);
+        map.insert_or_assign(k, v);
+    }
+    void erase(uint64_t k) {
+        std::unique_lock guard(lock);
+        map.erase(k);
+    }
+};
+
+template<typename Map>
+static double mopsPerSecond(Map& map, const std::vector<uint64_t>& space, int readPercent, unsigned threads) {
+    constexpr size_t ops = 1000000;
+    std::vector<std::thread> workers;
+    std::atomic<uint64_t> sink{0};
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; ++t)
+        workers.emplace_back([&, t] {
+            uint64_t state = t + 1, hits = 0;
+            for (size_t i = 0; i < ops; ++i) {
+                const uint64_t k = space[splitmix(state) % space.size()];
+                const uint64_t op = splitmix(state) % 200;
+                if (op < 2 * static_cast<uint64_t>(readPercent)) hits += map.contains(k);
+                else if (op % 2) map.insert_or_assign(k, k);
+                else map.erase(k);
+            }
+            sink += hits;
+        });
+    for (auto& w : workers) w.join();
+    const std::chrono::duration<double> took = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(ops * threads) / took.count() / 1e6 + (sink == 1 ? 1e-9 : 0);
+}
+
+int main(int argc, char** argv) {
+    const size_t max = argc > 1 ? static_cast<size_t>(std::atof(argv[1])) : 10000000;
+    const unsigned threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2]))
+                                      : std::max(1u, std::thread::hardware_concurrency());
+    std::printf("%10s %-16s %10s %10s %10s\n", "keys", "map", "insert ns", "hit ns", "miss ns");
+    for (size_t n = 1000; n <= max; n *= 10) {
+        uint64_t state = n;
+        std::vector<uint64_t> keys(n), absent(n);
+        for (auto& k : keys) k = splitmix(state);
+        for (auto& k : absent) k = splitmix(state);
+        std::vector<uint64_t> shuffled(keys);
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937_64(n));
+        row<FlatHashMap<uint64_t, uint64_t>>("FlatHashMap", keys, shuffled, absent);
+        row<std::unordered_map<uint64_t, uint64_t>>("unordered_map", keys, shuffled, absent);
+    }
+
+    std::printf("\n%10s %-16s %10s %10s %10s\n", "keys", "ordered", "insert ns", "hit ns", "scan100 ns");
+    for (size_t n = 1000; n <= max; n *= 10) {
+        uint64_t state = n;
+        std::vector<uint64_t> keys(n);
+        for (auto& k : keys) k = splitmix(state);
+        std::vector<uint64_t> shuffled(keys);
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937_64(n));
+        {
+            BPlusTree<uint64_t, uint64_t> tree;
+            const double insert = nsPerOp(n, [&] {
+                for (uint64_t k : keys) tree.put(k, k);
+            });
+            orderedRow("BPlusTree", keys, shuffled, tree, insert);
+        }
+        redBlackRow(keys, shuffled);
+        orderedRow<std::map<uint64_t, uint64_t>>("map", keys, shuffled);
+        {
+            std::vector<std::pair<uint64_t, uint64_t>> sorted(n);
+            std::sort(keys.begin(), keys.end());
+            for (size_t i = 0; i < n; ++i) sorted[i] = {keys[i], keys[i]};
+            BPlusTree<uint64_t, uint64_t> tree;
+            const double load = nsPerOp(n, [&] {
+                tree = BPlusTree<uint64_t, uint64_t>::bulkLoad(std::move(sorted));
+            });
+            orderedRow("BPlusTree bulk", keys, shuffled, tree, load);
+        }
+    }
+
+    const size_t n = std::min<size_t>(max, 1000000);
+    {
+        const std::vector<std::string> keys = urls(n);
+        size_t bytes = 0;
+        for (const auto& k : keys) bytes += k.size();
+        std::printf("\n%10s %-16s %10s %10s %10s   (%.1f key bytes)\n", "keys", "strings", "insert ns", "hit ns",
+                    "bytes/key", static_cast<double>(bytes) / static_cast<double>(keys.size()));
+        stringRow<TST<int>>("TST", keys);
+        stringRow<RadixTree<int>>("RadixTree", keys);
+        stringMapRow(keys);
+    }
+
+    {
+        const size_t m = std::min<size_t>(max, 10000000);
+        uint64_t state = 13;
+        std::vector<std::pair<uint64_t, uint64_t>> entries(m);
+        std::vector<uint64_t> absent(m);
+        for (auto& [k, v] : entries) v = k = splitmix(state);
+        for (auto& k : absent) k = splitmix(state);
+        uint64_t sink = 0;
+        std::optional<StaticTable<uint64_t, uint64_t>> table;
+        const double build = nsPerOp(m, [&] { table.emplace(StaticTable<uint64_t, uint64_t>::build(entries, threads)); });
+        const double hit = nsPerOp(m, [&] {
+            for (size_t i = m; i-- > 0;) sink += *table->find(entries[i].first);
+        });
+        const double miss = nsPerOp(m, [&] {
+            for (uint64_t k : absent) sink += table->contains(k);
+        });
+        const std::string path = (std::filesystem::temp_directory_path() / "bench_symbol_tables.mph").string();
+        table->write(path);
+        const double load = nsPerOp(1, [&] { sink += StaticTable<uint64_t, uint64_t>::load(path).size(); }) / 1e6;
+        std::filesystem::remove(path);
+        FlatHashMap<uint64_t, uint64_t> map;
+        const double rebuild = nsPerOp(1, [&] {
+            map.reserve(m);
+            for (const auto& [k, v] : entries) map.try_emplace(k, v);
+        }) / 1e6;
+        std::printf("\n%10s %-16s %10s %10s %10s %10s %10s %12s\n", "keys", "static", "build ns", "hit ns", "miss ns",
+                    "hash bits", "load ms", "FlatHash ms");
+        std::printf("%10zu %-16s %10.1f %10.1f %10.1f %10.2f %10.3f %12.1f%s\n", m, "StaticTable", build, hit, miss,
+                    static_cast<double>(table->hashBits()) / static_cast<double>(m), load, rebuild, sink == 1 ? "!" : "");
+    }
+
+    {
+        const size_t m = std::min<size_t>(max, 10000000);
+        uint64_t state = 13;
+        std::vector<uint64_t> keys(m), absent(m);
+        for (auto& k : keys) k = splitmix(state);
+        for (auto& k : absent) k = splitmix(state);
+        std::printf("\n%10s %-16s %10s %10s %10s %10s %10s\n", "keys", "filter", "build ns", "bits/key", "fp %",
+                    "query ns", "batch ns");
+        auto filterRow = [&](const char* name, const auto& filter, double build) {
+            size_t positives = 0;
+            const double query = nsPerOp(m, [&] {
+                for (uint64_t k : absent) positives += filter.contains(k);
+            });
+            std::vector<uint8_t> out(m);
+            const double batch = nsPerOp(m, [&] { positives -= filter.containsMany(absent, out); });
+            std::printf("%10zu %-16s %10.1f %10.2f %10.3f %10.1f %10.1f%s\n", m, name, build,
+                        8.0 * static_cast<double>(filter.bytes()) / static_cast<double>(m),
+                        100.0 * static_cast<double>(std::count(out.begin(), out.end(), 1)) / static_cast<double>(m),
+                        query, batch, positives != 0 ? "!" : "");
+        };
+        std::optional<BlockedBloomFilter> bloom;
+        const double bloomBuild = nsPerOp(m, [&] {
+            bloom.emplace(m, 12);
+            for (uint64_t k : keys) bloom->insert(k);
+        });
+        filterRow("BlockedBloom 12", *bloom, bloomBuild);
+        std::optional<BinaryFuseFilter> fuse;
+        const double fuseBuild = nsPerOp(m, [&] { fuse.emplace(BinaryFuseFilter::build(keys)); });
+        filterRow("BinaryFuse8", *fuse, fuseBuild);
+    }
+
+    std::vector<uint64_t> space(2 * n);
+    uint64_t state = 7;
+    for (auto& k : space) k = splitmix(state);
+    std::printf("\n%10s %-16s %8s %10s\n", "keys", "concurrent", "reads %", "Mops/s");
+    for (int reads : {100, 95, 90, 75, 50}) {
+        ConcurrentHashMap<uint64_t, uint64_t> map;
+        LockedMap locked;
+        for (size_t i = 0; i < n; ++i) {
+            map.insert_or_assign(space[i], space[i]);
+            locked.map.emplace(space[i], space[i]);
+        }
+        std::printf("%10zu %-16s %8d %10.1f\n", n, "ConcurrentHash", reads, mopsPerSecond(map, space, reads, threads));
+        std::printf("%10zu %-16s %8d %10.1f\n", n, "shared_mutex", reads, mopsPerSecond(locked, space, reads, threads));
+    }
+    std::printf("(%u threads)\n", threads);
+}
@@ -0,0 +1,761 @@
+#ifndef ALGO_BPLUS_TREE_H
+#define ALGO_BPLUS_TREE_H
+#include <bit>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <optional>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "../sort/sort.h"
+#if !defined(ALGO_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define ALGO_BPLUS_AVX2 1
+#elif !defined(ALGO_NO_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define ALGO_BPLUS_SSE2 1
+#endif
+
+namespace symbol_tables {
+    namespace detail {
+        template<typename K>
+        inline constexpr bool simdKey = std::is_integral_v<K> && !std::is_same_v<K, bool>
+                                        && (sizeof(K) == 4 || sizeof(K) == 8);
+
+        // Position of x in the sorted keys[0..n): the number of keys below x, or not above
+        // it with orEqual, i.e. lower_bound or upper_bound. A node holds a few dozen keys,
+        // so integer keys are compared a register at a time and the lanes counted with
+        // popcount, no branch depends on the data; unsigned keys get their sign bit
+        // flipped to suit the signed compare. SSE2 has no 64-bit compare, so 64-bit keys
+        // need AVX2 (-mavx2 or -march=native) and take the scalar loop otherwise. Other
+        // key types binary search.
+        template<bool orEqual, typename K>
+        size_t position(const K* keys, size_t n, const K& x) noexcept {
+            if constexpr (simdKey<K>) {
+                size_t i = 0, count = 0;
+#if defined(ALGO_BPLUS_AVX2) || defined(ALGO_BPLUS_SSE2)
+                using S = std::make_signed_t<K>;
+                constexpr S flip = std::is_signed_v<K> ? 0 : std::numeric_limits<S>::min();
+                const S y = static_cast<S>(static_cast<S>(x) ^ flip);
+#endif
+#if defined(ALGO_BPLUS_AVX2)
+                constexpr size_t width = 32 / sizeof(K);
+                if constexpr (sizeof(K) == 8) {
+                    const __m256i f = _mm256_set1_epi64x(flip), v = _mm256_set1_epi64x(y);
+                    for (; i + width <= n; i += width) {
+                        const __m256i k = _mm256_xor_si256(
+                                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), f);
+                        const __m256i m = orEqual ? _mm256_cmpgt_epi64(k, v) : _mm256_cmpgt_epi64(v, k);
+                        count += std::popcount(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(m))));
+                    }
+                } else {
+                    const __m256i f = _mm256_set1_epi32(flip), v = _mm256_set1_epi32(y);
+                    for (; i + width <= n; i += width) {
+                        const __m256i k = _mm256_xor_si256(
+                                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), f);
+                        const __m256i m = orEqual ? _mm256_cmpgt_epi32(k, v) : _mm256_cmpgt_epi32(v, k);
+                        count += std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m))));
+                    }
+                }
+#elif defined(ALGO_BPLUS_SSE2)
+                if constexpr (sizeof(K) == 4) {
+                    constexpr size_t width = 4;
+                    const __m128i f = _mm_set1_epi32(flip), v = _mm_set1_epi32(y);
+                    for (; i + width <= n; i += width) {
+                        const __m128i k = _mm_xor_si128(
+                                _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), f);
+                        const __m128i m = orEqual ? _mm_cmpgt_epi32(k, v) : _mm_cmpgt_epi32(v, k);
+                        count += std::popcount(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(m))));
+                    }
+                }
+#endif
+                // the vector part counted the keys above x for orEqual
+                if constexpr (orEqual) count = i - count;
+                for (; i < n; ++i)
+                    count += orEqual ? !(x < keys[i]) : keys[i] < x;
+                return count;
+            } else if constexpr (orEqual) {
+                return static_cast<size_t>(std::upper_bound(keys, keys + n, x) - keys);
+            } else {
+                return static_cast<size_t>(std::lower_bound(keys, keys + n, x) - keys);
+            }
+        }
+    }
+
+    /** B+-tree ordered symbol table ***************************************************************
+     * Entries live in the leaves, sorted and linked left to right, so a range scan walks
+     * contiguous arrays; inner nodes hold only separator keys, child pointers and the
+     * number of entries under each child, which gives rank() and select() in O(log n).
+     * A node is NodeBytes long, a few cache lines by default, with keys and values in
+     * separate arrays so that the search in a node reads keys only (detail::position).
+     * Nodes are split when they overflow and rebalanced with a sibling, by borrowing or
+     * merging, when a removal leaves them less than half full.
+     *
+     * Keys are ordered by operator<, like sort.h; Key and Value must be default
+     * constructible. Iterators are forward, in key order, and are invalidated by put()
+     * and remove().
+     */
+    template<typename Key, typename Value, size_t NodeBytes = 512>
+    class BPlusTree {
+    private:
+        struct Node {
+            uint32_t count = 0;     // entries in a leaf, separator keys in an inner node
+            bool leaf;
+
+            explicit Node(bool leaf) noexcept : leaf(leaf) {}
+        };
+
+    public:
+        // one slot of each node is spare: a node overflows by one and splits after
+        static constexpr size_t leafCapacity =
+                (NodeBytes - sizeof(Node) - 2 * sizeof(void*)) / (sizeof(Key) + sizeof(Value)) - 1;
+        static constexpr size_t innerCapacity =
+                (NodeBytes - sizeof(Node) - sizeof(void*) - sizeof(size_t))
+                / (sizeof(Key) + sizeof(void*) + sizeof(size_t)) - 1;
+        static_assert(leafCapacity >= 3 && leafCapacity < NodeBytes
+                      && innerCapacity >= 3 && innerCapacity < NodeBytes,
+                      "NodeBytes is too small for the key and value types");
+
+    private:
+        struct alignas(64) Leaf : Node {
+            Leaf* prev = nullptr;
+            Leaf* next = nullptr;
+            Key keys[leafCapacity + 1];
+            Value values[leafCapacity + 1];
+
+            Leaf() : Node(true) {}
+        };
+
+        // children[i] holds the keys in [keys[i - 1], keys[i])
+        struct alignas(64) Inner : Node {
+            Key keys[innerCapacity + 1];
+            Node* children[innerCapacity + 2];
+            size_t sizes[innerCapacity + 2];
+
+            Inner() : Node(false) {}
+        };
+
+        static constexpr size_t leafMinimum = leafCapacity / 2;
+        static constexpr size_t innerMinimum = innerCapacity / 2;
+
+        // what an overflowing node hands to its parent
+        struct Split {
+            Node* right = nullptr;
+            Key key{};
+            size_t size = 0;
+        };
+
+        Node* root_ = nullptr;
+        size_t size_ = 0;
+
+    public:
+        template<bool Const>
+        class Iterator {
+        private:
+            friend class BPlusTree;
+            template<bool> friend class Iterator;
+            using LeafPtr = std::conditional_t<Const, const Leaf*, Leaf*>;
+            using ValueRef = std::conditional_t<Const, const Value&, Value&>;
+
+            LeafPtr leaf_ = nullptr;
+            uint32_t i_ = 0;
+
+            Iterator(LeafPtr leaf, uint32_t i) noexcept
+                : leaf_(leaf)
+                , i_(i)
+            {}
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::pair<const Key, Value>;
+            using reference = std::pair<const Key&, ValueRef>;
+
+            Iterator() = default;
+            operator Iterator<true>() const noexcept requires (!Const) {
+                return {leaf_, i_};
+            }
+            [[nodiscard]]
+            const Key& key() const noexcept {
+                return leaf_->keys[i_];
+            }
+            [[nodiscard]]
+            ValueRef value() const noexcept {
+                return leaf_->values[i_];
+            }
+            reference operator*() const noexcept {
+                return {leaf_->keys[i_], leaf_->values[i_]};
+            }
+            Iterator& operator++() noexcept {
+                if (++i_ == leaf_->count) {
+                    leaf_ = leaf_->next;
+                    i_ = 0;
+                }
+                return *this;
+            }
+            Iterator operator++(int) noexcept {
+                Iterator it = *this;
+                ++*this;
+                return it;
+            }
+            friend bool operator==(const Iterator&, const Iterator&) = default;
+        };
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        template<bool Const>
+        struct Range {
+            Iterator<Const> first, last;
+
+            [[nodiscard]]
+            Iterator<Const> begin() const noexcept { return first; }
+            [[nodiscard]]
+            Iterator<Const> end() const noexcept { return last; }
+            [[nodiscard]]
+            bool empty() const noexcept { return first == last; }
+        };
+
+        BPlusTree() = default;
+        BPlusTree(const BPlusTree&) = delete;
+        BPlusTree& operator=(const BPlusTree&) = delete;
+        BPlusTree(BPlusTree&& other) noexcept
+            : root_(std::exchange(other.root_, nullptr))
+            , size_(std::exchange(other.size_, 0))
+        {}
+        BPlusTree& operator=(BPlusTree&& other) noexcept {
+            std::swap(root_, other.root_);
+            std::swap(size_, other.size_);
+            return *this;
+        }
+        ~BPlusTree() {
+            destroy(root_);
+        }
+
+        // Builds the tree bottom up with full leaves, O(n) for sorted input; anything
+        // else is sorted first with sort::merge, which is stable, so of equal keys the
+        // one given last wins, as with repeated put().
+        static BPlusTree bulkLoad(std::vector<std::pair<Key, Value>> entries);
+
+        [[nodiscard]]
+        size_t size() const noexcept { return size_; }
+        [[nodiscard]]
+        bool empty() const noexcept { return size_ == 0; }
+        [[nodiscard]]
+        int height() const noexcept;
+        void clear() noexcept {
+            destroy(root_);
+            root_ = nullptr;
+            size_ = 0;
+        }
+
+        // inserts or replaces
+        void put(const Key& key, Value value);
+        [[nodiscard]]
+        std::optional<Value> get(const Key& key) const;
+        [[nodiscard]]
+        bool contains(const Key& key) const { return find(key) != end(); }
+        [[nodiscard]]
+        iterator find(const Key& key) { return unconst(std::as_const(*this).find(key)); }
+        [[nodiscard]]
+        const_iterator find(const Key& key) const;
+        // false if the key was not there
+        bool remove(const Key& key);
+
+        // the smallest and largest keys; throw std::out_of_range on an empty table
+        [[nodiscard]]
+        const Key& min() const;
+        [[nodiscard]]
+        const Key& max() const;
+        // the largest key <= key and the smallest key >= key, if any
+        [[nodiscard]]
+        std::optional<Key> floor(const Key& key) const;
+        [[nodiscard]]
+        std::optional<Key> ceiling(const Key& key) const;
+        // number of keys < key
+        [[nodiscard]]
+        size_t rank(const Key& key) const;
+        // the key of rank k; throws std::out_of_range unless k < size()
+        [[nodiscard]]
+        const Key& select(size_t k) const;
+        // number of keys in [lo, hi]
+        [[nodiscard]]
+        size_t size(const Key& lo, const Key& hi) const;
+
+        [[nodiscard]]
+        iterator begin() noexcept { return unconst(std::as_const(*this).begin()); }
+        [[nodiscard]]
+        const_iterator begin() const noexcept;
+        [[nodiscard]]
+        iterator end() noexcept { return {}; }
+        [[nodiscard]]
+        const_iterator end() const noexcept { return {}; }
+        // first entry with a key >= key, > key
+        [[nodiscard]]
+        iterator lower_bound(const Key& key) { return unconst(std::as_const(*this).lower_bound(key)); }
+        [[nodiscard]]
+        const_iterator lower_bound(const Key& key) const { return bound<false>(key); }
+        [[nodiscard]]
+        iterator upper_bound(const Key& key) { return unconst(std::as_const(*this).upper_bound(key)); }
+        [[nodiscard]]
+        const_iterator upper_bound(const Key& key) const { return bound<true>(key); }
+        // the entries with keys in [lo, hi], in order
+        [[nodiscard]]
+        Range<false> range(const Key& lo, const Key& hi) {
+            if (hi < lo) return {};
+            return {lower_bound(lo), upper_bound(hi)};
+        }
+        [[nodiscard]]
+        Range<true> range(const Key& lo, const Key& hi) const {
+            if (hi < lo) return {};
+            return {lower_bound(lo), upper_bound(hi)};
+        }
+
+    private:
+        static iterator unconst(const_iterator it) noexcept {
+            return {const_cast<Leaf*>(it.leaf_), it.i_};
+        }
+        static void destroy(Node* node) noexcept;
+        const Leaf* leafFor(const Key& key) const noexcept;
+        template<bool orEqual>
+        const_iterator bound(const Key& key) const;
+        bool insert(Node* node, const Key& key, Value& value, Split& split);
+        static void splitLeaf(Leaf* leaf, Split& split);
+        static void splitInner(Inner* inner, Split& split);
+        bool erase(Node* node, const Key& key);
+        static void rebalance(Inner* parent, size_t i);
+        static void removeSlot(Inner* parent, size_t i);
+    };
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    void BPlusTree<Key, Value, NodeBytes>::destroy(Node* node) noexcept {
+        if (!node) return;
+        if (node->leaf) {
+            delete static_cast<Leaf*>(node);
+            return;
+        }
+        auto* inner = static_cast<Inner*>(node);
+        for (size_t i = 0; i <= inner->count; ++i) destroy(inner->children[i]);
+        delete inner;
+    }
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    BPlusTree<Key, Value, NodeBytes> BPlusTree<Key, Value, NodeBytes>::bulkLoad(std::vector<std::pair<Key, Value>> entries) {
+        auto byKey = [](const std::pair<Key, Value>& a, const std::pair<Key, Value>& b) { return a.first < b.first; };
+        if (!std::is_sorted(entries.begin(), entries.end(), byKey))
+            sort::merge(entries.data(), entries.size(), byKey);
+        size_t n = 0;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (n > 0 && !(entries[n - 1].first < entries[i].first)) entries[n - 1].second = std::move(entries[i].second);
+            else if (n++ != i) entries[n - 1] = std::move(entries[i]);
+        }
+
+        BPlusTree tree;
+        if (n == 0) return tree;
+        // one level at a time, each node as full as an even spread allows; with two or
+        // more nodes on a level that is at least half full
+        std::vector<Node*> level, up;
+        std::vector<Key> lows, upLows;          // the smallest key under each node
+        std::vector<size_t> sizes, upSizes;
+        const size_t leaves = (n + leafCapacity - 1) / leafCapacity;
+        Leaf* prev = nullptr;
+        for (size_t j = 0, at = 0; j < leaves; ++j) {
+            const size_t take = n / leaves + (j < n % leaves);
+            auto* leaf = new Leaf;
+            for (size_t k = 0; k < take; ++k) {
+                leaf->keys[k] = std::move(entries[at + k].first);
+                leaf->values[k] = std::move(entries[at + k].second);
+            }
+            leaf->count = static_cast<uint32_t>(take);
+            leaf->prev = prev;
+            if (prev) prev->next = leaf;
+            prev = leaf;
+            level.push_back(leaf);
+            lows.push_back(leaf->keys[0]);
+            sizes.push_back(take);
+            at += take;
+        }
+        while (level.size() > 1) {
+            const size_t parents = (level.size() + innerCapacity) / (innerCapacity + 1);
+            up.clear();
+            upLows.clear();
+            upSizes.clear();
+            for (size_t j = 0, at = 0; j < parents; ++j) {
+                const size_t take = level.size() / parents + (j < level.size() % parents);
+                auto* inner = new Inner;
+                size_t total = 0;
+                for (size_t k = 0; k < take; ++k) {
+                    inner->children[k] = level[at + k];
+                    inner->sizes[k] = sizes[at + k];
+                    total += sizes[at + k];
+                    if (k > 0) inner->keys[k - 1] = lows[at + k];
+                }
+                inner->count = static_cast<uint32_t>(take - 1);
+                up.push_back(inner);
+                upLows.push_back(std::move(lows[at]));
+                upSizes.push_back(total);
+                at += take;
+            }
+            std::swap(level, up);
+            std::swap(lows, upLows);
+            std::swap(sizes, upSizes);
+        }
+        tree.root_ = level[0];
+        tree.size_ = n;
+        return tree;
+    }
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    int BPlusTree<Key, Value, NodeBytes>::height() const noexcept {
+        int h = 0;
+        for (const Node* node = root_; node; node = node->leaf ? nullptr : static_cast<const Inner*>(node)->children[0])
+            ++h;
+        return h;
+    }
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    auto BPlusTree<Key, Value, NodeBytes>::leafFor(const Key& key) const noexcept -> const Leaf* {
+        const Node* node = root_;
+        while (!node->leaf) {
+            const auto* inner = static_cast<const Inner*>(node);
+            node = inner->children[detail::position<true>(inner->keys, inner->count, key)];
+        }
+        return static_cast<const Leaf*>(node);
+    }
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    template<bool orEqual>
+    auto BPlusTree<Key, Value, NodeBytes>::bound(const Key& key) const -> const_iterator {
+        if (!root_) return {};
+        const Leaf* leaf = leafFor(key);
+        const size_t i = detail::position<orEqual>(leaf->keys, leaf->count, key);
+        if (i == leaf->count) return {leaf->next, 0};
+        return {leaf, static_cast<uint32_t>(i)};
+    }
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    auto BPlusTree<Key, Value, NodeBytes>::find(const Key& key) const -> const_iterator {
+        const const_iterator it = lower_bound(key);
+        return it != end() && !(key < it.key()) ? it : end();
+    }
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    std::optional<Value> BPlusTree<Key, Value, NodeBytes>::get(const Key& key) const {
+        const const_iterator it = find(key);
+        if (it == end()) return std::nullopt;
+        return it.value();
+    }
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    auto BPlusTree<Key, Value, NodeBytes>::begin() const noexcept -> const_iterator {
+        if (!root_) return {};
+        const Node* node = root_;
+        while (!node->leaf) node = static_cast<const Inner*>(node)->children[0];
+        return {static_cast<const Leaf*>(node), 0};
+    }
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    const Key& BPlusTree<Key, Value, NodeBytes>::min() const {
+        if (!root_) throw std::out_of_range("Symbol table is empty");
+        return begin().key();
+    }
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    const Key& BPlusTree<Key, Value, NodeBytes>::max() const {
+        if (!root_) throw std::out_of_range("Symbol table is empty");
+        const Node* node = root_;
+        while (!node->leaf) {
+            const auto* inner = static_cast<const Inner*>(node);
+            node = inner->children[inner->count];
+        }
+        const auto* leaf = static_cast<const Leaf*>(node);
+        return leaf->keys[leaf->count - 1];
+    }
+
+    // Separators may be keys that have since been removed, so the leaf that key leads to
+    // can lack both answers; only a leaf's neighbour can hold them, as no leaf but the
+    // root is ever empty.
+    template<typename Key, typename Value, size_t NodeBytes>
+    std::optional<Key> BPlusTree<Key, Value, NodeBytes>::floor(const Key& key) const {
+        if (!root_) return std::nullopt;
+        const Leaf* leaf = leafFor(key);
+        const size_t i = detail::position<true>(leaf->keys, leaf->count, key);
+        if (i > 0) return leaf->keys[i - 1];
+        if (leaf->prev) return leaf->prev->keys[leaf->prev->count - 1];
+        return std::nullopt;
+    }
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    std::optional<Key> BPlusTree<Key, Value, NodeBytes>::ceiling(const Key& key) const {
+        const const_iterator it = lower_bound(key);
+        if (it == end()) return std::nullopt;
+        return it.key();
+    }
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    size_t BPlusTree<Key, Value, NodeBytes>::rank(const Key& key) const {
+        if (!root_) return 0;
+        size_t r = 0;
+        const Node* node = root_;
+        while (!node->leaf) {
+            const auto* inner = static_cast<const Inner*>(node);
+            const size_t i = detail::position<true>(inner->keys, inner->count, key);
+            for (size_t j = 0; j < i; ++j) r += inner->sizes[j];
+            node = inner->children[i];
+        }
+        const auto* leaf = static_cast<const Leaf*>(node);
+        return r + detail::position<false>(leaf->keys, leaf->count, key);
+    }
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    const Key& BPlusTree<Key, Value, NodeBytes>::select(size_t k) const {
+        if (k >= size_) throw std::out_of_range("Rank is out of boundaries");
+        const Node* node = root_;
+        while (!node->leaf) {
+            const auto* inner = static_cast<const Inner*>(node);
+            size_t i = 0;
+            for (; k >= inner->sizes[i]; ++i) k -= inner->sizes[i];
+            node = inner->children[i];
+        }
+        return static_cast<const Leaf*>(node)->keys[k];
+    }
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    size_t BPlusTree<Key, Value, NodeBytes>::size(const Key& lo, const Key& hi) const {
+        if (hi < lo) return 0;
+        return rank(hi) - rank(lo) + contains(hi);
+    }
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    void BPlusTree<Key, Value, NodeBytes>::put(const Key& key, Value value) {
+        if (!root_) {
+            auto* leaf = new Leaf;
+            leaf->keys[0] = key;
+            leaf->values[0] = std::move(value);
+            leaf->count = 1;
+            root_ = leaf;
+            size_ = 1;
+            return;
+        }
+        Split split;
+        if (insert(root_, key, value, split)) ++size_;
+        if (split.right) {
+            auto* root = new Inner;
+            root->count = 1;
+            root->keys[0] = std::move(split.key);
+            root->children[0] = root_;
+            root->children[1] = split.right;
+            root->sizes[0] = size_ - split.size;
+            root->sizes[1] = split.size;
+            root_ = root;
+        }
+    }
+
+    // true if the key is new; a node that overflows splits and fills in split
+    template<typename Key, typename Value, size_t NodeBytes>
+    bool BPlusTree<Key, Value, NodeBytes>::insert(Node* node, const Key& key, Value& value, Split& split) {
+        if (node->leaf) {
+            auto* leaf = static_cast<Leaf*>(node);
+            const size_t i = detail::position<false>(leaf->keys, leaf->count, key);
+            if (i < leaf->count && !(key < leaf->keys[i])) {
+                leaf->values[i] = std::move(value);
+                return false;
+            }
+            std::move_backward(leaf->keys + i, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+            std::move_backward(leaf->values + i, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+            leaf->keys[i] = key;
+            leaf->values[i] = std::move(value);
+            if (++leaf->count > leafCapacity) splitLeaf(leaf, split);
+            return true;
+        }
+        auto* inner = static_cast<Inner*>(node);
+        const size_t i = detail::position<true>(inner->keys, inner->count, key);
+        Split below;
+        if (!insert(inner->children[i], key, value, below)) return false;
+        ++inner->sizes[i];
+        if (below.right) {
+            const size_t n = inner->count;
+            std::move_backward(inner->keys + i, inner->keys + n, inner->keys + n + 1);
+            std::copy_backward(inner->children + i + 1, inner->children + n + 1, inner->children + n + 2);
+            std::copy_backward(inner->sizes + i + 1, inner->sizes + n + 1, inner->sizes + n + 2);
+            inner->keys[i] = std::move(below.key);
+            inner->children[i + 1] = below.right;
+            inner->sizes[i] -= below.size;
+            inner->sizes[i + 1] = below.size;
+            if (++inner->count > innerCapacity) splitInner(inner, split);
+        }
+        return true;
+    }
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    void BPlusTree<Key, Value, NodeBytes>::splitLeaf(Leaf* leaf, Split& split) {
+        auto* right = new Leaf;
+        const uint32_t keep = leaf->count / 2;
+        right->count = leaf->count - keep;
+        std::move(leaf->keys + keep, leaf->keys + leaf->count, right->keys);
+        std::move(leaf->values + keep, leaf->values + leaf->count, right->values);
+        leaf->count = keep;
+        right->next = leaf->next;
+        if (right->next) right->next->prev = right;
+        right->prev = leaf;
+        leaf->next = right;
+        split.right = right;
+        split.key = right->keys[0];
+        split.size = right->count;
+    }
+
+    // the middle key moves up, the upper half of the children to the new node
+    template<typename Key, typename Value, size_t NodeBytes>
+    void BPlusTree<Key, Value, NodeBytes>::splitInner(Inner* inner, Split& split) {
+        auto* right = new Inner;
+        const uint32_t m = inner->count / 2;
+        right->count = inner->count - m - 1;
+        std::move(inner->keys + m + 1, inner->keys + inner->count, right->keys);
+        std::copy(inner->children + m + 1, inner->children + inner->count + 1, right->children);
+        std::copy(inner->sizes + m + 1, inner->sizes + inner->count + 1, right->sizes);
+        split.right = right;
+        split.key = std::move(inner->keys[m]);
+        split.size = 0;
+        for (size_t i = 0; i <= right->count; ++i) split.size += right->sizes[i];
+        inner->count = m;
+    }
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    bool BPlusTree<Key, Value, NodeBytes>::remove(const Key& key) {
+        if (!root_ || !erase(root_, key)) return false;
+        --size_;
+        if (root_->leaf) {
+            if (root_->count == 0) {
+                delete static_cast<Leaf*>(root_);
+                root_ = nullptr;
+            }
+        } else if (root_->count == 0) {
+            auto* old = static_cast<Inner*>(root_);
+            root_ = old->children[0];
+            delete old;
+        }
+        return true;
+    }
+
+    template<typename Key, typename Value, size_t NodeBytes>
+    bool BPlusTree<Key, Value, NodeBytes>::erase(Node* node, const Key& key) {
+        if (node->leaf) {
+            auto* leaf = static_cast<Leaf*>(node);
+            const size_t i = detail::position<false>(leaf->keys, leaf->count, key);
+            if (i == leaf->count || key < leaf->keys[i]) return false;
+            std::move(leaf->keys + i + 1, leaf->keys + leaf->count, leaf->keys + i);
+            std::move(leaf->values + i + 1, leaf->values + leaf->count, leaf->values + i);
+            --leaf->count;
+            return true;
+        }
+        auto* inner = static_cast<Inner*>(node);
+        const size_t i = detail::position<true>(inner->keys, inner->count, key);
+        Node* child = inner->children[i];
+        if (!erase(child, key)) return false;
+        --inner->sizes[i];
+        if (child->count < (child->leaf ? leafMinimum : innerMinimum)) rebalance(inner, i);
+        return true;
+    }
+
+    // drops separator i and child i + 1, whose entries have gone to child i
+    template<typename Key, typename Value, size_t NodeBytes>
+    void BPlusTree<Key, Value, NodeBytes>::removeSlot(Inner* parent, size_t i) {
+        const size_t n = parent->count;
+        std::move(parent->keys + i + 1, parent->keys + n, parent->keys + i);
+        std::copy(parent->children + i + 2, parent->children + n + 1, parent->children + i + 1);
+        std::copy(parent->sizes + i + 2, parent->sizes + n + 1, parent->sizes + i + 1);
+        --parent->count;
+    }
+
+    // Child i is under half full: take one entry from a sibling that can spare it, or
+    // merge with a sibling that cannot, which then fits in one node.
+    template<typename Key, typename Value, size_t NodeBytes>
+    void BPlusTree<Key, Value, NodeBytes>::rebalance(Inner* parent, size_t i) {
+        const bool hasLeft = i > 0, hasRight = i < parent->count;
+        if (parent->children[i]->leaf) {
+            auto* c = static_cast<Leaf*>(parent->children[i]);
+            auto* l = hasLeft ? static_cast<Leaf*>(parent->children[i - 1]) : nullptr;
+            auto* r = hasRight ? static_cast<Leaf*>(parent->children[i + 1]) : nullptr;
+            if (l && l->count > leafMinimum) {
+                std::move_backward(c->keys, c->keys + c->count, c->keys + c->count + 1);
+                std::move_backward(c->values, c->values + c->count, c->values + c->count + 1);
+                c->keys[0] = std::move(l->keys[l->count - 1]);
+                c->values[0] = std::move(l->values[l->count - 1]);
+                --l->count;
+                ++c->count;
+                parent->keys[i - 1] = c->keys[0];
+                --parent->sizes[i - 1];
+                ++parent->sizes[i];
+            } else if (r && r->count > leafMinimum) {
+                c->keys[c->count] = std::move(r->keys[0]);
+                c->values[c->count] = std::move(r->values[0]);
+                ++c->count;
+                std::move(r->keys + 1, r->keys + r->count, r->keys);
+                std::move(r->values + 1, r->values + r->count, r->values);
+                --r->count;
+                parent->keys[i] = r->keys[0];
+                ++parent->sizes[i];
+                --parent->sizes[i + 1];
+            } else {
+                const size_t j = l ? i - 1 : i;
+                auto* left = static_cast<Leaf*>(parent->children[j]);
+                auto* right = static_cast<Leaf*>(parent->children[j + 1]);
+                std::move(right->keys, right->keys + right->count, left->keys + left->count);
+                std::move(right->values, right->values + right->count, left->values + left->count);
+                left->count += right->count;
+                left->next = right->next;
+                if (left->next) left->next->prev = left;
+                parent->sizes[j] += parent->sizes[j + 1];
+                removeSlot(parent, j);
+                delete right;
+            }
+            return;
+        }
+        auto* c = static_cast<Inner*>(parent->children[i]);
+        auto* l = hasLeft ? static_cast<Inner*>(parent->children[i - 1]) : nullptr;
+        auto* r = hasRight ? static_cast<Inner*>(parent->children[i + 1]) : nullptr;
+        if (l && l->count > innerMinimum) {
+            const size_t n = c->count;
+            std::move_backward(c->keys, c->keys + n, c->keys + n + 1);
+            std::copy_backward(c->children, c->children + n + 1, c->children + n + 2);
+            std::copy_backward(c->sizes, c->sizes + n + 1, c->sizes + n + 2);
+            c->keys[0] = std::move(parent->keys[i - 1]);
+            c->children[0] = l->children[l->count];
+            c->sizes[0] = l->sizes[l->count];
+            parent->keys[i - 1] = std::move(l->keys[l->count - 1]);
+            --l->count;
+            ++c->count;
+            parent->sizes[i - 1] -= c->sizes[0];
+            parent->sizes[i] += c->sizes[0];
+        } else if (r && r->count > innerMinimum) {
+            const size_t moved = r->sizes[0];
+            c->keys[c->count] = std::move(parent->keys[i]);
+            c->children[c->count + 1] = r->children[0];
+            c->sizes[c->count + 1] = moved;
+            ++c->count;
+            parent->keys[i] = std::move(r->keys[0]);
+            std::move(r->keys + 1, r->keys + r->count, r->keys);
+            std::copy(r->children + 1, r->children + r->count + 1, r->children);
+            std::copy(r->sizes + 1, r->sizes + r->count + 1, r->sizes);
+            --r->count;
+            parent->sizes[i] += moved;
+            parent->sizes[i + 1] -= moved;
+        } else {
+            const size_t j = l ? i - 1 : i;
+            auto* left = static_cast<Inner*>(parent->children[j]);
+            auto* right = static_cast<Inner*>(parent->children[j + 1]);
+            const size_t n = left->count;
+            left->keys[n] = std::move(parent->keys[j]);
+            std::move(right->keys, right->keys + right->count, left->keys + n + 1);
+            std::copy(right->children, right->children + right->count + 1, left->children + n + 1);
+            std::copy(right->sizes, right->sizes + right->count + 1, left->sizes + n + 1);
+            left->count += right->count + 1;
+            parent->sizes[j] += parent->sizes[j + 1];
+            removeSlot(parent, j);
+            delete right;
+        }
+    }
+}
+
+#endif //ALGO_BPLUS_TREE_H
@@ -0,0 +1,290 @@
+#ifndef ALGO_CONCURRENT_HASH_MAP_H
+#define ALGO_CONCURRENT_HASH_MAP_H
+#include <bit>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <algorithm>
+#include <functional>
+#include "flat_hash_map.h"
+#include "epoch.h"
+
+namespace symbol_tables {
+    /** Concurrent hash map ******************************************************************
+     * Separate chaining over an array of atomic bucket heads. Readers take no lock and
+     * write nothing shared but their epoch announcement: they walk a chain with acquire
+     * loads inside an EpochGuard. Nodes are immutable once published; assigning to a key
+     * swaps in a new node and erasing unlinks one, and the old node is retired to the
+     * epoch domain, so a reader still standing on it finishes its walk safely.
+     *
+     * Writers lock one of a fixed set of stripes, chosen by the low hash bits. The
+     * bucket count is a power of two no smaller than the stripe count, so a bucket
+     * belongs to exactly one stripe and writers to different stripes never meet. When a
+     * stripe's share of the entries passes its share of the buckets, the writer takes
+     * every stripe, copies the chains into a table twice as large, publishes it and
+     * retires the old one. Readers carry on through the old table while that happens;
+     * other writers wait for it.
+     *
+     * get() copies the value out; visit() lends it to a callback inside the guard, for
+     * values too big to copy. for_each() is weakly consistent: it sees every entry that
+     * stays in the map for the whole walk and may or may not see the others.
+     */
+    template<typename Key, typename Value, typename H = Hash, typename Eq = std::equal_to<>>
+    class ConcurrentHashMap {
+    private:
+        struct Node {
+            const size_t hash;
+            const Key key;
+            const Value value;
+            std::atomic<Node*> next;
+
+            Node(size_t hash, const Key& key, Value value, Node* next)
+                : hash(hash)
+                , key(key)
+                , value(std::move(value))
+                , next(next)
+            {}
+        };
+
+        struct Table {
+            const size_t mask;
+            const std::unique_ptr<std::atomic<Node*>[]> buckets;
+
+            explicit Table(size_t n)
+                : mask(n - 1)
+                , buckets(std::make_unique<std::atomic<Node*>[]>(n))
+            {}
+            ~Table() {
+                for (size_t i = 0; i <= mask; ++i)
+                    for (Node* n = buckets[i].load(std::memory_order_relaxed); n;) {
+                        Node* next = n->next.load(std::memory_order_relaxed);
+                        delete n;
+                        n = next;
+                    }
+            }
+        };
+
+        struct alignas(64) Stripe {
+            std::mutex lock;
+            std::atomic<size_t> count{0};
+        };
+
+        std::atomic<Table*> table_;
+        const size_t stripeMask_;
+        const std::unique_ptr<Stripe[]> stripes_;
+        [[no_unique_address]] H hash_;
+        [[no_unique_address]] Eq eq_;
+
+    public:
+        // stripes = 0 picks four per hardware thread; both counts round up to powers of two
+        explicit ConcurrentHashMap(size_t capacity = 0, size_t stripes = 0);
+        ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+        ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+        ~ConcurrentHashMap() {
+            delete table_.load(std::memory_order_relaxed);
+        }
+
+        // exact when no writer is running
+        [[nodiscard]]
+        size_t size() const noexcept;
+        [[nodiscard]]
+        bool empty() const noexcept { return size() == 0; }
+        [[nodiscard]]
+        size_t bucket_count() const noexcept {
+            return table_.load(std::memory_order_acquire)->mask + 1;
+        }
+
+        template<typename K>
+        [[nodiscard]]
+        std::optional<Value> get(const K& key) const {
+            EpochGuard guard;
+            const Node* n = lookup(key);
+            if (!n) return std::nullopt;
+            return n->value;
+        }
+        template<typename K>
+        [[nodiscard]]
+        bool contains(const K& key) const {
+            EpochGuard guard;
+            return lookup(key) != nullptr;
+        }
+        // f(const Value&) if the key is there; true if it was
+        template<typename K, typename F>
+        bool visit(const K& key, F&& f) const {
+            EpochGuard guard;
+            const Node* n = lookup(key);
+            if (!n) return false;
+            std::forward<F>(f)(n->value);
+            return true;
+        }
+        // f(const Key&, const Value&) for every entry
+        template<typename F>
+        void for_each(F&& f) const;
+
+        // false, and no change, if the key is already there
+        bool insert(const Key& key, Value value) {
+            return put<false>(key, value);
+        }
+        // true if the key is new, false if its value was replaced
+        bool insert_or_assign(const Key& key, Value value) {
+            return put<true>(key, value);
+        }
+        template<typename K>
+        bool erase(const K& key);
+        void clear();
+
+    private:
+        template<typename K>
+        const Node* lookup(const K& key) const;
+        template<bool assign>
+        bool put(const Key& key, Value& value);
+        void grow(const Table* seen);
+        std::vector<std::unique_lock<std::mutex>> lockAll();
+    };
+
+    template<typename Key, typename Value, typename H, typename Eq>
+    ConcurrentHashMap<Key, Value, H, Eq>::ConcurrentHashMap(size_t capacity, size_t stripes)
+        : stripeMask_(std::bit_ceil(stripes ? stripes : std::max<size_t>(16, 4 * std::thread::hardware_concurrency())) - 1)
+        , stripes_(std::make_unique<Stripe[]>(stripeMask_ + 1))
+    {
+        table_.store(new Table(std::bit_ceil(std::max({capacity, stripeMask_ + 1, size_t{16}}))), std::memory_order_release);
+    }
+
+    template<typename Key, typename Value, typename H, typename Eq>
+    size_t ConcurrentHashMap<Key, Value, H, Eq>::size() const noexcept {
+        size_t n = 0;
+        for (size_t i = 0; i <= stripeMask_; ++i) n += stripes_[i].count.load(std::memory_order_relaxed);
+        return n;
+    }
+
+    // the caller holds an EpochGuard
+    template<typename Key, typename Value, typename H, typename Eq>
+    template<typename K>
+    auto ConcurrentHashMap<Key, Value, H, Eq>::lookup(const K& key) const -> const Node* {
+        const size_t h = detail::mix(hash_(key));
+        const Table* t = table_.load(std::memory_order_acquire);
+        for (const Node* n = t->buckets[h & t->mask].load(std::memory_order_acquire); n;
+             n = n->next.load(std::memory_order_acquire))
+            if (n->hash == h && eq_(n->key, key)) return n;
+        return nullptr;
+    }
+
+    template<typename Key, typename Value, typename H, typename Eq>
+    template<typename F>
+    void ConcurrentHashMap<Key, Value, H, Eq>::for_each(F&& f) const {
+        EpochGuard guard;
+        const Table* t = table_.load(std::memory_order_acquire);
+        for (size_t i = 0; i <= t->mask; ++i)
+            for (const Node* n = t->buckets[i].load(std::memory_order_acquire); n;
+                 n = n->next.load(std::memory_order_acquire))
+                f(n->key, n->value);
+    }
+
+    // Under the stripe lock the table cannot change, so writers need no guard: only
+    // holders of this stripe, or a resize holding all of them, unlink these nodes.
+    template<typename Key, typename Value, typename H, typename Eq>
+    template<bool assign>
+    bool ConcurrentHashMap<Key, Value, H, Eq>::put(const Key& key, Value& value) {
+        const size_t h = detail::mix(hash_(key));
+        Stripe& stripe = stripes_[h & stripeMask_];
+        Node* old = nullptr;
+        const Table* grown = nullptr;
+        {
+            std::lock_guard lock(stripe.lock);
+            const Table* t = table_.load(std::memory_order_acquire);
+            std::atomic<Node*>& head = t->buckets[h & t->mask];
+            for (std::atomic<Node*>* link = &head; Node* n = link->load(std::memory_order_relaxed); link = &n->next) {
+                if (n->hash != h || !eq_(n->key, key)) continue;
+                if (!assign) return false;
+                link->store(new Node(h, n->key, std::move(value), n->next.load(std::memory_order_relaxed)),
+                            std::memory_order_release);
+                old = n;
+                break;
+            }
+            if (!old) {
+                head.store(new Node(h, key, std::move(value), head.load(std::memory_order_relaxed)),
+                           std::memory_order_release);
+                const size_t count = stripe.count.load(std::memory_order_relaxed) + 1;
+                stripe.count.store(count, std::memory_order_relaxed);
+                if (count > (t->mask + 1) / (stripeMask_ + 1)) grown = t;
+            }
+        }
+        if (old) {
+            EpochDomain::instance().retire(old);
+            return false;
+        }
+        if (grown) grow(grown);
+        return true;
+    }
+
+    template<typename Key, typename Value, typename H, typename Eq>
+    template<typename K>
+    bool ConcurrentHashMap<Key, Value, H, Eq>::erase(const K& key) {
+        const size_t h = detail::mix(hash_(key));
+        Stripe& stripe = stripes_[h & stripeMask_];
+        Node* old = nullptr;
+        {
+            std::lock_guard lock(stripe.lock);
+            const Table* t = table_.load(std::memory_order_acquire);
+            for (std::atomic<Node*>* link = &t->buckets[h & t->mask]; Node* n = link->load(std::memory_order_relaxed);
+                 link = &n->next) {
+                if (n->hash != h || !eq_(n->key, key)) continue;
+                link->store(n->next.load(std::memory_order_relaxed), std::memory_order_release);
+                stripe.count.store(stripe.count.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+                old = n;
+                break;
+            }
+        }
+        if (!old) return false;
+        EpochDomain::instance().retire(old);
+        return true;
+    }
+
+    // always in stripe order, so two writers growing at once cannot deadlock
+    template<typename Key, typename Value, typename H, typename Eq>
+    std::vector<std::unique_lock<std::mutex>> ConcurrentHashMap<Key, Value, H, Eq>::lockAll() {
+        std::vector<std::unique_lock<std::mutex>> locks;
+        locks.reserve(stripeMask_ + 1);
+        for (size_t i = 0; i <= stripeMask_; ++i) locks.emplace_back(stripes_[i].lock);
+        return locks;
+    }
+
+    // The old chains are copied, not relinked: readers may be walking them.
+    template<typename Key, typename Value, typename H, typename Eq>
+    void ConcurrentHashMap<Key, Value, H, Eq>::grow(const Table* seen) {
+        Table* old;
+        {
+            const auto locks = lockAll();
+            old = table_.load(std::memory_order_relaxed);
+            if (old != seen) return;    // someone else grew it first
+            auto* t = new Table(2 * (old->mask + 1));
+            for (size_t i = 0; i <= old->mask; ++i)
+                for (const Node* n = old->buckets[i].load(std::memory_order_relaxed); n;
+                     n = n->next.load(std::memory_order_relaxed)) {
+                    std::atomic<Node*>& head = t->buckets[n->hash & t->mask];
+                    head.store(new Node(n->hash, n->key, n->value, head.load(std::memory_order_relaxed)),
+                               std::memory_order_relaxed);
+                }
+            table_.store(t, std::memory_order_release);
+        }
+        EpochDomain::instance().retire(old);
+    }
+
+    template<typename Key, typename Value, typename H, typename Eq>
+    void ConcurrentHashMap<Key, Value, H, Eq>::clear() {
+        Table* old;
+        {
+            const auto locks = lockAll();
+            old = table_.load(std::memory_order_relaxed);
+            table_.store(new Table(old->mask + 1), std::memory_order_release);
+            for (size_t i = 0; i <= stripeMask_; ++i) stripes_[i].count.store(0, std::memory_order_relaxed);
+        }
+        EpochDomain::instance().retire(old);
+    }
+}
+
+#endif //ALGO_CONCURRENT_HASH_MAP_H
@@ -0,0 +1,183 @@
+#ifndef ALGO_EPOCH_H
+#define ALGO_EPOCH_H
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+namespace symbol_tables {
+    /** Epoch-based reclamation (Fraser) ******************************************************
+     * A lock-free reader may still be looking at a node that a writer has just unlinked,
+     * so the writer retires the node instead of deleting it. Readers bracket each access
+     * in an EpochGuard, which announces the global epoch it started in. The epoch moves
+     * on only when every thread inside a guard has announced the current one, so nothing
+     * retired in epoch e is reachable by any reader once the epoch is e + 2; the retiring
+     * thread frees such objects in batches. A guard is a store and a fence and never
+     * blocks; a reader that stays inside one holds back reclamation, not writers.
+     *
+     * One process-wide domain. A thread gets a record on first use and gives it up when
+     * it exits; the next new thread takes the record over, with anything still retired
+     * in it. Whatever is left is freed when the program ends.
+     */
+    class EpochDomain {
+    private:
+        struct Retired {
+            void* p;
+            void (*free)(void*);
+            uint64_t epoch;
+        };
+
+        struct alignas(64) Record {
+            std::atomic<uint64_t> announced{0};     // epoch << 1 | 1 inside a guard, 0 outside
+            std::atomic<bool> inUse{true};
+            Record* next = nullptr;
+            unsigned depth = 0;
+            size_t threshold = batch;
+            std::vector<Retired> retired;
+        };
+
+        struct Registration {
+            Record* record;
+
+            Registration() : record(instance().acquire()) {}
+            ~Registration() { instance().release(record); }
+        };
+
+        static constexpr size_t batch = 64;
+
+        alignas(64) std::atomic<uint64_t> epoch_{1};
+        std::atomic<Record*> records_{nullptr};
+
+        EpochDomain() = default;
+    public:
+        EpochDomain(const EpochDomain&) = delete;
+        EpochDomain& operator=(const EpochDomain&) = delete;
+        ~EpochDomain();
+
+        static EpochDomain& instance() {
+            static EpochDomain domain;
+            return domain;
+        }
+
+        // guards nest; only the outermost one announces
+        void enter() noexcept;
+        void leave() noexcept;
+        // free(p) runs once no guard that could have seen p is left; call it after p
+        // has been unlinked from everything a reader can reach
+        void retire(void* p, void (*free)(void*));
+        template<typename T>
+        void retire(T* p) {
+            retire(p, [](void* q) { delete static_cast<T*>(q); });
+        }
+        // advances the epoch if it can and frees what this thread has retired and may free
+        void collect();
+        [[nodiscard]]
+        uint64_t epoch() const noexcept {
+            return epoch_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        static Record* self() {
+            thread_local Registration registration;
+            return registration.record;
+        }
+        Record* acquire();
+        void release(Record* r) noexcept;
+        bool tryAdvance() noexcept;
+        void collect(Record* r);
+    };
+
+    class EpochGuard {
+    public:
+        EpochGuard() noexcept { EpochDomain::instance().enter(); }
+        ~EpochGuard() { EpochDomain::instance().leave(); }
+        EpochGuard(const EpochGuard&) = delete;
+        EpochGuard& operator=(const EpochGuard&) = delete;
+    };
+
+    inline EpochDomain::~EpochDomain() {
+        for (Record* r = records_.load(std::memory_order_acquire); r;) {
+            for (const auto& x : r->retired) x.free(x.p);
+            Record* next = r->next;
+            delete r;
+            r = next;
+        }
+    }
+
+    // Announce, then check that the epoch did not move meanwhile: otherwise an advance
+    // could have scanned past this record before the announcement was visible. Every
+    // store to the announcement releases and the scan acquires it, so whatever a reader
+    // did before it moved on happens before anything is freed on its account.
+    inline void EpochDomain::enter() noexcept {
+        Record* r = self();
+        if (r->depth++ > 0) return;
+        uint64_t e = epoch_.load(std::memory_order_relaxed);
+        while (true) {
+            r->announced.store(e << 1 | 1, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const uint64_t now = epoch_.load(std::memory_order_relaxed);
+            if (now == e) return;
+            e = now;
+        }
+    }
+
+    inline void EpochDomain::leave() noexcept {
+        Record* r = self();
+        if (--r->depth == 0) r->announced.store(0, std::memory_order_release);
+    }
+
+    inline void EpochDomain::retire(void* p, void (*free)(void*)) {
+        Record* r = self();
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        r->retired.push_back({p, free, epoch_.load(std::memory_order_relaxed)});
+        if (r->retired.size() >= r->threshold) collect(r);
+    }
+
+    inline void EpochDomain::collect() {
+        collect(self());
+    }
+
+    inline EpochDomain::Record* EpochDomain::acquire() {
+        for (Record* r = records_.load(std::memory_order_acquire); r; r = r->next) {
+            bool free = false;
+            if (!r->inUse.load(std::memory_order_relaxed)
+                && r->inUse.compare_exchange_strong(free, true, std::memory_order_acquire))
+                return r;
+        }
+        auto* r = new Record;
+        r->next = records_.load(std::memory_order_relaxed);
+        while (!records_.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {}
+        return r;
+    }
+
+    inline void EpochDomain::release(Record* r) noexcept {
+        collect(r);
+        r->inUse.store(false, std::memory_order_release);
+    }
+
+    inline bool EpochDomain::tryAdvance() noexcept {
+        uint64_t e = epoch_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (const Record* r = records_.load(std::memory_order_acquire); r; r = r->next) {
+            const uint64_t a = r->announced.load(std::memory_order_acquire);
+            if ((a & 1) && a >> 1 != e) return false;
+        }
+        return epoch_.compare_exchange_strong(e, e + 1, std::memory_order_acq_rel);
+    }
+
+    // A reader stuck in a guard stops the epoch; the threshold then grows with the
+    // backlog so that retiring stays amortised O(1).
+    inline void EpochDomain::collect(Record* r) {
+        tryAdvance();
+        const uint64_t e = epoch_.load(std::memory_order_acquire);
+        auto& retired = r->retired;
+        const auto done = std::partition(retired.begin(), retired.end(),
+                                         [e](const Retired& x) { return x.epoch + 2 > e; });
+        std::vector<Retired> free(done, retired.end());
+        retired.erase(done, retired.end());
+        r->threshold = std::max(batch, 2 * retired.size());
+        for (const auto& x : free) x.free(x.p);
+    }
+}
+
+#endif //ALGO_EPOCH_H
@@ -0,0 +1,512 @@
+#ifndef ALGO_FILTERS_H
+#define ALGO_FILTERS_H
+#include <cmath>
+#include <span>
+#include <ranges>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include "mapped_file.h"
+#include "static_table.h"
+#if defined(__AVX2__) && !defined(ALGO_NO_SIMD)
+#include <immintrin.h>
+#define ALGO_FILTERS_AVX2 1
+#endif
+
+namespace symbol_tables {
+    namespace detail {
+        // the hash filters store: fixed across builds, like StaticTable's
+        template<typename K>
+        uint64_t filterHash(const K& key) noexcept {
+            if constexpr (std::is_integral_v<K>) return fmix(static_cast<uint64_t>(key));
+            else return hashBytes(std::string_view(key), 0);
+        }
+
+        // how many keys a batch query hashes and prefetches before it probes any
+        inline constexpr size_t batch = 16;
+
+        inline void prefetch(const void* p) noexcept {
+#if defined(__GNUC__)
+            __builtin_prefetch(p);
+#endif
+        }
+    }
+
+    /** Split-block Bloom filter (Putze, Sanders, Singler; the Parquet layout) ************
+     * A key hashes to one 32-byte block, eight 32-bit words, and sets one bit in each
+     * word, the bit picked by the low hash bits times a constant per word. A query thus
+     * costs one hash and one cache line, never two, where a plain Bloom filter takes k
+     * cache misses. With AVX2 the eight bits of a block are made and tested in four
+     * instructions. At 12 bits per key about 0.5% of absent keys pass; a plain filter
+     * with the best k does a little better on the same bits.
+     *
+     * The filter is a single block of 64-byte lines, in memory as in its file (version
+     * 1, native byte order): a line of header, char magic[8] = "ALGOBLM", uint32 version,
+     * uint32 0, uint64 blocks, then zeros; then the blocks, two a line. load() maps the
+     * file and serves queries from it; a mapped filter takes no inserts.
+     *
+     * Keys are integers or strings; the filter keeps only their hashes, and insertHash()
+     * and containsHash() take a 64-bit hash made elsewhere. containsMany() hashes a batch
+     * of keys and prefetches their blocks before it tests any, so that the cache misses
+     * of a batch overlap.
+     */
+    class BlockedBloomFilter {
+    private:
+        struct alignas(64) Line {
+            uint64_t words[8];
+        };
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t flags;
+            uint64_t blocks;
+        };
+
+        static constexpr char magic[8] = {'A', 'L', 'G', 'O', 'B', 'L', 'M', '\0'};
+        static constexpr uint32_t version = 1;
+        static constexpr uint32_t salt[8] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                             0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+        MappedFile file_;
+        std::vector<Line> image_;
+        const char* data_ = nullptr;
+        size_t bytes_ = 0;
+        uint32_t* blocks_ = nullptr;    // 8 words a block; const when mapped
+        size_t count_ = 0;
+
+        BlockedBloomFilter() = default;
+    public:
+        // room for keys keys at bitsPerKey bits each, rounded up to whole blocks
+        explicit BlockedBloomFilter(size_t keys, double bitsPerKey = 12);
+        BlockedBloomFilter(BlockedBloomFilter&& other) noexcept;
+        BlockedBloomFilter& operator=(BlockedBloomFilter&& other) noexcept;
+        BlockedBloomFilter(const BlockedBloomFilter&) = delete;
+        BlockedBloomFilter& operator=(const BlockedBloomFilter&) = delete;
+
+        [[nodiscard]]
+        static BlockedBloomFilter load(const std::string& path);
+        void write(std::ostream& os) const;
+        void write(const std::string& path) const;
+        [[nodiscard]]
+        size_t bytes() const noexcept { return bytes_; }
+        [[nodiscard]]
+        size_t blocks() const noexcept { return count_; }
+
+        template<typename K>
+        void insert(const K& key) { insertHash(detail::filterHash(key)); }
+        void insertHash(uint64_t h);
+        // false only if the key was never inserted
+        template<typename K>
+        [[nodiscard]]
+        bool contains(const K& key) const noexcept { return containsHash(detail::filterHash(key)); }
+        [[nodiscard]]
+        bool containsHash(uint64_t h) const noexcept;
+        // out[i] = contains(keys[i]); the number of keys that may be in
+        template<std::ranges::contiguous_range R>
+        size_t containsMany(const R& keys, std::span<uint8_t> out) const;
+
+    private:
+        [[nodiscard]]
+        const uint32_t* block(uint64_t h) const noexcept { return blocks_ + 8 * detail::reduce(h, count_); }
+        void attach(const char* data, size_t bytes);
+        [[nodiscard]]
+        static bool test(const uint32_t* block, uint64_t h) noexcept;
+    };
+
+    inline BlockedBloomFilter::BlockedBloomFilter(size_t keys, double bitsPerKey) {
+        if (!(bitsPerKey > 0)) throw std::invalid_argument("Bits per key must be positive");
+        const auto blocks = std::max<size_t>(1, static_cast<size_t>(std::ceil(static_cast<double>(keys) * bitsPerKey / 256)));
+        image_.resize(1 + (blocks + 1) / 2);
+        Header h{};
+        std::memcpy(h.magic, magic, sizeof magic);
+        h.version = version;
+        h.blocks = blocks;
+        std::memcpy(image_.data(), &h, sizeof h);
+        attach(reinterpret_cast<const char*>(image_.data()), image_.size() * sizeof(Line));
+    }
+
+    inline BlockedBloomFilter::BlockedBloomFilter(BlockedBloomFilter&& other) noexcept
+        : file_(std::move(other.file_))
+        , image_(std::move(other.image_))
+        , data_(std::exchange(other.data_, nullptr))
+        , bytes_(std::exchange(other.bytes_, 0))
+        , blocks_(std::exchange(other.blocks_, nullptr))
+        , count_(std::exchange(other.count_, 0))
+    {}
+
+    inline BlockedBloomFilter& BlockedBloomFilter::operator=(BlockedBloomFilter&& other) noexcept {
+        if (this != &other) {
+            file_ = std::move(other.file_);
+            image_ = std::move(other.image_);
+            data_ = std::exchange(other.data_, nullptr);
+            bytes_ = std::exchange(other.bytes_, 0);
+            blocks_ = std::exchange(other.blocks_, nullptr);
+            count_ = std::exchange(other.count_, 0);
+        }
+        return *this;
+    }
+
+    inline void BlockedBloomFilter::attach(const char* data, size_t bytes) {
+        Header h{};
+        if (bytes < sizeof(Line)) throw std::invalid_argument("Not a Bloom filter");
+        std::memcpy(&h, data, sizeof h);
+        if (std::memcmp(h.magic, magic, sizeof magic) != 0) throw std::invalid_argument("Not a Bloom filter");
+        if (h.version != version) throw std::invalid_argument("Unsupported Bloom filter version or byte order");
+        if (h.blocks == 0 || h.blocks > bytes / 32 || sizeof(Line) * (1 + (h.blocks + 1) / 2) != bytes)
+            throw std::invalid_argument("Bloom filter size does not match its header");
+        if (reinterpret_cast<uintptr_t>(data) % 32 != 0) throw std::invalid_argument("Bloom filter is not aligned");
+        data_ = data;
+        bytes_ = bytes;
+        count_ = h.blocks;
+        // writable only through insertHash(), which a mapped filter refuses
+        blocks_ = reinterpret_cast<uint32_t*>(const_cast<char*>(data) + sizeof(Line));
+    }
+
+    inline BlockedBloomFilter BlockedBloomFilter::load(const std::string& path) {
+        BlockedBloomFilter f;
+        f.file_ = MappedFile(path);
+        f.attach(f.file_.data(), f.file_.size());
+        return f;
+    }
+
+    inline void BlockedBloomFilter::write(std::ostream& os) const {
+        os.write(data_, static_cast<std::streamsize>(bytes_));
+        if (!os) throw std::runtime_error("Cannot write the Bloom filter");
+    }
+
+    inline void BlockedBloomFilter::write(const std::string& path) const {
+        std::ofstream os(path, std::ios::binary);
+        if (!os) throw std::runtime_error("Cannot open " + path);
+        write(os);
+    }
+
+    inline void BlockedBloomFilter::insertHash(uint64_t h) {
+        if (image_.empty()) throw std::logic_error("Mapped Bloom filter is read-only");
+        auto* b = const_cast<uint32_t*>(block(h));
+        const auto x = static_cast<uint32_t>(h);
+#ifdef ALGO_FILTERS_AVX2
+        const __m256i bits = _mm256_sllv_epi32(_mm256_set1_epi32(1), _mm256_srli_epi32(
+                _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(x)),
+                                   _mm256_loadu_si256(reinterpret_cast<const __m256i*>(salt))), 27));
+        auto* p = reinterpret_cast<__m256i*>(b);
+        _mm256_store_si256(p, _mm256_or_si256(_mm256_load_si256(p), bits));
+#else
+        for (size_t i = 0; i < 8; ++i) b[i] |= uint32_t{1} << ((x * salt[i]) >> 27);
+#endif
+    }
+
+    inline bool BlockedBloomFilter::test(const uint32_t* b, uint64_t h) noexcept {
+        const auto x = static_cast<uint32_t>(h);
+#ifdef ALGO_FILTERS_AVX2
+        const __m256i bits = _mm256_sllv_epi32(_mm256_set1_epi32(1), _mm256_srli_epi32(
+                _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(x)),
+                                   _mm256_loadu_si256(reinterpret_cast<const __m256i*>(salt))), 27));
+        return _mm256_testc_si256(_mm256_load_si256(reinterpret_cast<const __m256i*>(b)), bits);
+#else
+        for (size_t i = 0; i < 8; ++i)
+            if (!(b[i] >> ((x * salt[i]) >> 27) & 1)) return false;
+        return true;
+#endif
+    }
+
+    inline bool BlockedBloomFilter::containsHash(uint64_t h) const noexcept {
+        return count_ != 0 && test(block(h), h);
+    }
+
+    template<std::ranges::contiguous_range R>
+    size_t BlockedBloomFilter::containsMany(const R& keys, std::span<uint8_t> out) const {
+        const size_t n = std::ranges::size(keys);
+        if (out.size() < n) throw std::invalid_argument("Output is shorter than the keys");
+        if (count_ == 0) {
+            std::fill_n(out.begin(), n, 0);
+            return 0;
+        }
+        const auto* k = std::ranges::data(keys);
+        size_t hits = 0;
+        uint64_t hashes[detail::batch];
+        for (size_t lo = 0; lo < n; lo += detail::batch) {
+            const size_t m = std::min(detail::batch, n - lo);
+            for (size_t i = 0; i < m; ++i) {
+                hashes[i] = detail::filterHash(k[lo + i]);
+                detail::prefetch(block(hashes[i]));
+            }
+            for (size_t i = 0; i < m; ++i) hits += out[lo + i] = test(block(hashes[i]), hashes[i]);
+        }
+        return hits;
+    }
+
+    /** Binary fuse filter (Graf, Lemire) ****************************************************
+     * For a fixed set: an array of 8-bit fingerprints, about 1.13 bytes a key for large
+     * sets, and a key is in when the fingerprints at its three positions xor to its own.
+     * One in 256 absent keys passes. The three positions lie in three consecutive
+     * segments of the array, which makes the build a peeling of a 3-hypergraph that
+     * succeeds at a lower overhead than a plain xor filter's 1.23, and keeps the three
+     * reads close together. A build that does not peel tries another seed.
+     *
+     * Layout, in memory as in the file (version 1, native byte order): a 64-byte header,
+     * char magic[8] = "ALGOBFF", uint32 version, uint32 0, uint64 seed, uint64 keys,
+     * uint32 segment length, uint32 segment count, uint64 array length, zeros; then the
+     * fingerprints, padded to 8 bytes. load() maps the file. Keys and hashes as for
+     * BlockedBloomFilter; repeated keys are fine.
+     */
+    class BinaryFuseFilter {
+    private:
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t flags;
+            uint64_t seed;
+            uint64_t keys;
+            uint32_t segmentLength;
+            uint32_t segmentCount;
+            uint64_t arrayLength;
+            uint64_t reserved[2];
+        };
+        static_assert(sizeof(Header) == 64);
+
+        static constexpr char magic[8] = {'A', 'L', 'G', 'O', 'B', 'F', 'F', '\0'};
+        static constexpr uint32_t version = 1;
+        static constexpr int attempts = 100;
+
+        MappedFile file_;
+        std::vector<uint64_t> image_;
+        const char* data_ = nullptr;
+        size_t bytes_ = 0;
+        const uint8_t* fingerprints_ = nullptr;
+        uint64_t seed_ = 0;
+        size_t size_ = 0;
+        uint32_t segmentLength_ = 0;
+        uint64_t segmentCountLength_ = 0;
+
+        BinaryFuseFilter() = default;
+    public:
+        BinaryFuseFilter(BinaryFuseFilter&& other) noexcept;
+        BinaryFuseFilter& operator=(BinaryFuseFilter&& other) noexcept;
+        BinaryFuseFilter(const BinaryFuseFilter&) = delete;
+        BinaryFuseFilter& operator=(const BinaryFuseFilter&) = delete;
+
+        template<std::ranges::input_range R>
+        [[nodiscard]]
+        static BinaryFuseFilter build(const R& keys) {
+            std::vector<uint64_t> hashes;
+            if constexpr (std::ranges::sized_range<R>) hashes.reserve(std::ranges::size(keys));
+            for (const auto& k : keys) hashes.push_back(detail::filterHash(k));
+            return buildHashes(std::move(hashes));
+        }
+        [[nodiscard]]
+        static BinaryFuseFilter buildHashes(std::vector<uint64_t> hashes);
+        [[nodiscard]]
+        static BinaryFuseFilter load(const std::string& path);
+        void write(std::ostream& os) const;
+        void write(const std::string& path) const;
+        [[nodiscard]]
+        size_t bytes() const noexcept { return bytes_; }
+        // distinct key hashes
+        [[nodiscard]]
+        size_t size() const noexcept { return size_; }
+
+        template<typename K>
+        [[nodiscard]]
+        bool contains(const K& key) const noexcept { return containsHash(detail::filterHash(key)); }
+        [[nodiscard]]
+        bool containsHash(uint64_t h) const noexcept;
+        template<std::ranges::contiguous_range R>
+        size_t containsMany(const R& keys, std::span<uint8_t> out) const;
+
+    private:
+        struct Positions {
+            uint64_t h;
+            uint64_t at[3];
+        };
+        [[nodiscard]]
+        static Positions positions(uint64_t h, uint64_t seed, uint32_t segmentLength, uint64_t segmentCountLength) noexcept {
+            h = detail::fmix(h + seed);
+            const uint64_t h0 = detail::reduce(h, segmentCountLength);
+            const uint64_t mask = segmentLength - 1;
+            return {h, {h0, (h0 + segmentLength) ^ ((h >> 18) & mask), (h0 + 2 * segmentLength) ^ (h & mask)}};
+        }
+        [[nodiscard]]
+        static uint8_t fingerprint(uint64_t h) noexcept { return static_cast<uint8_t>(h ^ (h >> 32)); }
+        void attach(const char* data, size_t bytes);
+    };
+
+    inline BinaryFuseFilter::BinaryFuseFilter(BinaryFuseFilter&& other) noexcept
+        : file_(std::move(other.file_))
+        , image_(std::move(other.image_))
+        , data_(std::exchange(other.data_, nullptr))
+        , bytes_(std::exchange(other.bytes_, 0))
+        , fingerprints_(std::exchange(other.fingerprints_, nullptr))
+        , seed_(other.seed_)
+        , size_(std::exchange(other.size_, 0))
+        , segmentLength_(other.segmentLength_)
+        , segmentCountLength_(std::exchange(other.segmentCountLength_, 0))
+    {}
+
+    inline BinaryFuseFilter& BinaryFuseFilter::operator=(BinaryFuseFilter&& other) noexcept {
+        if (this != &other) {
+            file_ = std::move(other.file_);
+            image_ = std::move(other.image_);
+            data_ = std::exchange(other.data_, nullptr);
+            bytes_ = std::exchange(other.bytes_, 0);
+            fingerprints_ = std::exchange(other.fingerprints_, nullptr);
+            seed_ = other.seed_;
+            size_ = std::exchange(other.size_, 0);
+            segmentLength_ = other.segmentLength_;
+            segmentCountLength_ = std::exchange(other.segmentCountLength_, 0);
+        }
+        return *this;
+    }
+
+    // Segment length and array size as in the authors' code, which tuned them.
+    // Peeling: a position that only one key still maps to can be given last to that
+    // key, so remove the key and look again; in reverse order, every key then sets its
+    // position so that its three fingerprints xor to its own.
+    inline BinaryFuseFilter BinaryFuseFilter::buildHashes(std::vector<uint64_t> hashes) {
+        std::sort(hashes.begin(), hashes.end());
+        hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+        const size_t n = hashes.size();
+        const double size = static_cast<double>(n);
+        const uint32_t segmentLength = n < 2 ? 4 : std::min<uint32_t>(
+                262144, uint32_t{1} << static_cast<int>(std::floor(std::log(size) / std::log(3.33) + 2.25)));
+        const double sizeFactor = n < 2 ? 0 : std::max(1.125, 0.875 + 0.25 * std::log(1e6) / std::log(size));
+        const auto capacity = static_cast<uint64_t>(std::round(size * sizeFactor));
+        const uint64_t segments = (capacity + segmentLength - 1) / segmentLength;
+        const uint64_t segmentCount = segments > 3 ? segments - 2 : 1;
+        if (segmentCount > UINT32_MAX) throw std::length_error("Binary fuse filter is too large");
+        const uint64_t arrayLength = (segmentCount + 2) * segmentLength;
+        const uint64_t segmentCountLength = segmentCount * segmentLength;
+
+        Header h{};
+        std::memcpy(h.magic, magic, sizeof magic);
+        h.version = version;
+        h.keys = n;
+        h.segmentLength = segmentLength;
+        h.segmentCount = static_cast<uint32_t>(segmentCount);
+        h.arrayLength = arrayLength;
+
+        std::vector<uint32_t> counts(arrayLength);
+        std::vector<uint64_t> xors(arrayLength), queue;
+        std::vector<std::pair<uint64_t, uint64_t>> order;   // (hash, position it was peeled at)
+        uint64_t state = 0x2545f4914f6cdd1dULL;
+        for (int attempt = 0;; ++attempt) {
+            if (attempt == attempts) throw std::runtime_error("Binary fuse filter did not build");
+            h.seed = state += 0x9e3779b97f4a7c15ULL;
+            std::fill(counts.begin(), counts.end(), 0);
+            std::fill(xors.begin(), xors.end(), 0);
+            for (uint64_t x : hashes) {
+                for (uint64_t at : positions(x, h.seed, segmentLength, segmentCountLength).at) {
+                    ++counts[at];
+                    xors[at] ^= x;
+                }
+            }
+            queue.clear();
+            order.clear();
+            for (uint64_t at = 0; at < arrayLength; ++at)
+                if (counts[at] == 1) queue.push_back(at);
+            while (!queue.empty()) {
+                const uint64_t at = queue.back();
+                queue.pop_back();
+                if (counts[at] != 1) continue;
+                const uint64_t x = xors[at];
+                order.emplace_back(x, at);
+                for (uint64_t p : positions(x, h.seed, segmentLength, segmentCountLength).at) {
+                    --counts[p];
+                    xors[p] ^= x;
+                    if (counts[p] == 1) queue.push_back(p);
+                }
+            }
+            if (order.size() == n) break;
+        }
+
+        BinaryFuseFilter f;
+        f.image_.assign((sizeof h + arrayLength + 7) / 8, 0);
+        char* data = reinterpret_cast<char*>(f.image_.data());
+        std::memcpy(data, &h, sizeof h);
+        auto* fp = reinterpret_cast<uint8_t*>(data + sizeof h);
+        for (size_t i = order.size(); i-- > 0;) {
+            const auto [x, at] = order[i];
+            const Positions p = positions(x, h.seed, segmentLength, segmentCountLength);
+            fp[at] = fingerprint(p.h) ^ fp[p.at[0]] ^ fp[p.at[1]] ^ fp[p.at[2]];
+        }
+        f.attach(data, f.image_.size() * sizeof(uint64_t));
+        return f;
+    }
+
+    inline void BinaryFuseFilter::attach(const char* data, size_t bytes) {
+        Header h{};
+        if (bytes < sizeof h) throw std::invalid_argument("Not a binary fuse filter");
+        std::memcpy(&h, data, sizeof h);
+        if (std::memcmp(h.magic, magic, sizeof magic) != 0) throw std::invalid_argument("Not a binary fuse filter");
+        if (h.version != version) throw std::invalid_argument("Unsupported binary fuse filter version or byte order");
+        if (!std::has_single_bit(h.segmentLength) || h.segmentCount == 0 || h.arrayLength > bytes
+            || h.arrayLength != (h.segmentCount + uint64_t{2}) * h.segmentLength
+            || (sizeof h + h.arrayLength + 7) / 8 * 8 != bytes)
+            throw std::invalid_argument("Binary fuse filter size does not match its header");
+        data_ = data;
+        bytes_ = bytes;
+        fingerprints_ = reinterpret_cast<const uint8_t*>(data + sizeof h);
+        seed_ = h.seed;
+        size_ = h.keys;
+        segmentLength_ = h.segmentLength;
+        segmentCountLength_ = uint64_t{h.segmentCount} * h.segmentLength;
+    }
+
+    inline BinaryFuseFilter BinaryFuseFilter::load(const std::string& path) {
+        BinaryFuseFilter f;
+        f.file_ = MappedFile(path);
+        f.attach(f.file_.data(), f.file_.size());
+        return f;
+    }
+
+    inline void BinaryFuseFilter::write(std::ostream& os) const {
+        os.write(data_, static_cast<std::streamsize>(bytes_));
+        if (!os) throw std::runtime_error("Cannot write the binary fuse filter");
+    }
+
+    inline void BinaryFuseFilter::write(const std::string& path) const {
+        std::ofstream os(path, std::ios::binary);
+        if (!os) throw std::runtime_error("Cannot open " + path);
+        write(os);
+    }
+
+    inline bool BinaryFuseFilter::containsHash(uint64_t h) const noexcept {
+        if (size_ == 0) return false;
+        const Positions p = positions(h, seed_, segmentLength_, segmentCountLength_);
+        return fingerprint(p.h) == (fingerprints_[p.at[0]] ^ fingerprints_[p.at[1]] ^ fingerprints_[p.at[2]]);
+    }
+
+    template<std::ranges::contiguous_range R>
+    size_t BinaryFuseFilter::containsMany(const R& keys, std::span<uint8_t> out) const {
+        const size_t n = std::ranges::size(keys);
+        if (out.size() < n) throw std::invalid_argument("Output is shorter than the keys");
+        if (size_ == 0) {
+            std::fill_n(out.begin(), n, 0);
+            return 0;
+        }
+        const auto* k = std::ranges::data(keys);
+        size_t hits = 0;
+        Positions batch[detail::batch];
+        for (size_t lo = 0; lo < n; lo += detail::batch) {
+            const size_t m = std::min(detail::batch, n - lo);
+            for (size_t i = 0; i < m; ++i) {
+                batch[i] = positions(detail::filterHash(k[lo + i]), seed_, segmentLength_, segmentCountLength_);
+                for (uint64_t at : batch[i].at) detail::prefetch(fingerprints_ + at);
+            }
+            for (size_t i = 0; i < m; ++i) {
+                const Positions& p = batch[i];
+                hits += out[lo + i] =
+                        fingerprint(p.h) == (fingerprints_[p.at[0]] ^ fingerprints_[p.at[1]] ^ fingerprints_[p.at[2]]);
+            }
+        }
+        return hits;
+    }
+}
+
+#endif //ALGO_FILTERS_H
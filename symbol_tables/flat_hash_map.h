@@ -0,0 +1,449 @@
+#ifndef ALGO_FLAT_HASH_MAP_H
+#define ALGO_FLAT_HASH_MAP_H
+#include <bit>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+#if defined(__SSE2__) && !defined(ALGO_NO_SIMD)
+#include <emmintrin.h>
+#define ALGO_FLAT_HASH_SSE2 1
+#endif
+
+namespace symbol_tables {
+    /** Default hasher. Transparent: std::string, std::string_view and C strings hash
+     * alike, so a map keyed by std::string is searched with a string_view without building
+     * a string. Integers hash to themselves, anything else goes to std::hash; the map
+     * mixes every hash before use, so identity hashes are fine here and in user hashers.
+     */
+    struct Hash {
+        using is_transparent = void;
+
+        template<typename T>
+        requires std::is_integral_v<T> || std::is_enum_v<T>
+        size_t operator()(T x) const noexcept {
+            return static_cast<size_t>(x);
+        }
+        size_t operator()(std::string_view s) const noexcept {
+            return std::hash<std::string_view>{}(s);
+        }
+        template<typename T>
+        requires (!std::is_integral_v<T> && !std::is_enum_v<T> && !std::is_convertible_v<const T&, std::string_view>)
+        size_t operator()(const T& x) const noexcept(noexcept(std::hash<T>{}(x))) {
+            return std::hash<T>{}(x);
+        }
+    };
+
+    namespace detail {
+        // one control byte per slot: 0..127 the low 7 hash bits of a full slot, or one of
+        // the negative markers below
+        using ctrl_t = int8_t;
+        inline constexpr ctrl_t empty = -128;
+        inline constexpr ctrl_t deleted = -2;
+
+        // a multiply-xorshift finaliser: spreads weak hashes over all 64 bits
+        inline uint64_t mix(uint64_t h) noexcept {
+            h ^= h >> 32;
+            h *= 0x9e3779b97f4a7c15ULL;
+            return h ^ (h >> 29);
+        }
+
+        // 16 control bytes examined at once; every match() is a bit mask over the group
+        struct Group {
+            static constexpr size_t width = 16;
+#ifdef ALGO_FLAT_HASH_SSE2
+            __m128i ctrl;
+
+            explicit Group(const ctrl_t* p) noexcept
+                : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)))
+            {}
+            [[nodiscard]]
+            uint32_t match(ctrl_t h2) const noexcept {
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+            }
+            [[nodiscard]]
+            uint32_t matchEmpty() const noexcept {
+                return match(empty);
+            }
+            // empty and deleted are the only bytes with the sign bit set
+            [[nodiscard]]
+            uint32_t matchFree() const noexcept {
+                return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+            }
+#else
+            const ctrl_t* ctrl;
+
+            explicit Group(const ctrl_t* p) noexcept
+                : ctrl(p)
+            {}
+            [[nodiscard]]
+            uint32_t match(ctrl_t h2) const noexcept {
+                uint32_t m = 0;
+                for (size_t i = 0; i < width; ++i) m |= uint32_t{ctrl[i] == h2} << i;
+                return m;
+            }
+            [[nodiscard]]
+            uint32_t matchEmpty() const noexcept {
+                return match(empty);
+            }
+            [[nodiscard]]
+            uint32_t matchFree() const noexcept {
+                uint32_t m = 0;
+                for (size_t i = 0; i < width; ++i) m |= uint32_t{ctrl[i] < 0} << i;
+                return m;
+            }
+#endif
+        };
+    }
+
+    /** Open-addressing hash map in the Swiss-table layout ********************************
+     * Slots sit in one flat array next to an array of control bytes, one per slot, that
+     * holds 7 bits of the key's hash. A lookup hashes once, picks a group of 16 slots from
+     * the high bits and compares all 16 control bytes with one SSE2 instruction (a scalar
+     * loop without SSE2); only slots whose byte matches are compared by key, so a miss
+     * rarely touches a slot at all. Groups are probed quadratically; the search ends at
+     * the first group with an empty slot. The table grows at 7/8 full.
+     *
+     * Erasing leaves a tombstone only when it must: a probe only ever moves past a group
+     * that was completely full, so while a group still has an empty slot nothing has
+     * moved past it and an erased slot in it can become empty again. Tombstones count
+     * against the load and are dropped by the next rehash.
+     *
+     * With transparent Hash and Eq (the defaults) every lookup, and try_emplace, takes
+     * anything the two accept, and the Key is only built when it is inserted. Like
+     * std::unordered_map, iterators and references are invalidated by any rehash;
+     * unlike it, also by nothing else than insert, erase and clear.
+     */
+    template<typename Key, typename Value, typename H = Hash, typename Eq = std::equal_to<>>
+    class FlatHashMap {
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<const Key, Value>;
+        using hasher = H;
+        using key_equal = Eq;
+
+    private:
+        using ctrl_t = detail::ctrl_t;
+        using Group = detail::Group;
+        static constexpr bool transparent = requires {
+            typename H::is_transparent;
+            typename Eq::is_transparent;
+        };
+        // a key type a lookup accepts: Key itself or, with transparent functors, anything
+        template<typename K>
+        static constexpr bool lookup = std::is_same_v<std::remove_cvref_t<K>, Key> || transparent;
+
+        std::unique_ptr<ctrl_t[]> ctrl_;
+        value_type* slots_ = nullptr;
+        size_t capacity_ = 0;       // 0 or a power-of-two number of groups times Group::width
+        size_t size_ = 0;
+        size_t growthLeft_ = 0;     // empty slots that may still be filled before a rehash
+        [[no_unique_address]] H hash_;
+        [[no_unique_address]] Eq eq_;
+
+        template<bool Const>
+        class Iterator {
+            friend class FlatHashMap;
+            using slot_t = std::conditional_t<Const, const FlatHashMap::value_type, FlatHashMap::value_type>;
+            const ctrl_t* ctrl_ = nullptr;
+            slot_t* slots_ = nullptr;
+            size_t i_ = 0, end_ = 0;
+
+            Iterator(const ctrl_t* ctrl, slot_t* slots, size_t i, size_t end) noexcept
+                : ctrl_(ctrl), slots_(slots), i_(i), end_(end)
+            {
+                skip();
+            }
+            void skip() noexcept {
+                while (i_ < end_ && ctrl_[i_] < 0) ++i_;
+            }
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = FlatHashMap::value_type;
+            using difference_type = std::ptrdiff_t;
+            using reference = slot_t&;
+            using pointer = slot_t*;
+
+            Iterator() = default;
+            // iterator -> const_iterator
+            template<bool C = Const> requires C
+            Iterator(const Iterator<false>& other) noexcept
+                : ctrl_(other.ctrl_), slots_(other.slots_), i_(other.i_), end_(other.end_)
+            {}
+            reference operator*() const noexcept { return slots_[i_]; }
+            pointer operator->() const noexcept { return slots_ + i_; }
+            Iterator& operator++() noexcept {
+                ++i_;
+                skip();
+                return *this;
+            }
+            Iterator operator++(int) noexcept {
+                Iterator old = *this;
+                ++*this;
+                return old;
+            }
+            friend bool operator==(const Iterator& a, const Iterator& b) noexcept {
+                return a.i_ == b.i_;
+            }
+        };
+
+    public:
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        FlatHashMap() = default;
+        explicit FlatHashMap(size_t capacity, const H& hash = H(), const Eq& eq = Eq());
+        FlatHashMap(const FlatHashMap& other);
+        FlatHashMap(FlatHashMap&& other) noexcept;
+        FlatHashMap& operator=(FlatHashMap other) noexcept;
+        ~FlatHashMap();
+
+        [[nodiscard]]
+        size_t size() const noexcept { return size_; }
+        [[nodiscard]]
+        bool empty() const noexcept { return size_ == 0; }
+        [[nodiscard]]
+        size_t capacity() const noexcept { return capacity_; }
+        [[nodiscard]]
+        double load_factor() const noexcept { return capacity_ ? static_cast<double>(size_) / capacity_ : 0.0; }
+
+        iterator begin() noexcept { return {ctrl_.get(), slots_, 0, capacity_}; }
+        iterator end() noexcept { return {ctrl_.get(), slots_, capacity_, capacity_}; }
+        const_iterator begin() const noexcept { return {ctrl_.get(), slots_, 0, capacity_}; }
+        const_iterator end() const noexcept { return {ctrl_.get(), slots_, capacity_, capacity_}; }
+
+        // room for n entries without a rehash
+        void reserve(size_t n);
+        void clear() noexcept;
+
+        template<typename K, typename... Args>
+        requires lookup<K> && std::is_constructible_v<Key, K&&>
+        std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+            const size_t h = hashOf(key);
+            if (const size_t i = index(key, h); i != capacity_)
+                return {iteratorAt(i), false};
+            if (growthLeft_ == 0)   // mostly tombstones: clean up in place, else grow
+                rehash(capacity_ && size_ < maxLoad(capacity_) / 2 ? capacity_ : std::max(Group::width, capacity_ * 2));
+            const size_t i = freeSlot(h);
+            std::construct_at(slots_ + i, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                              std::forward_as_tuple(std::forward<Args>(args)...));
+            if (ctrl_[i] == detail::empty) --growthLeft_;
+            ctrl_[i] = static_cast<ctrl_t>(h & 0x7f);
+            ++size_;
+            return {iteratorAt(i), true};
+        }
+        std::pair<iterator, bool> insert(const value_type& kv) { return try_emplace(kv.first, kv.second); }
+        std::pair<iterator, bool> insert(value_type&& kv) { return try_emplace(kv.first, std::move(kv.second)); }
+        template<typename K, typename V>
+        requires lookup<K> && std::is_constructible_v<Key, K&&>
+        std::pair<iterator, bool> insert_or_assign(K&& key, V&& value) {
+            auto result = try_emplace(std::forward<K>(key), std::forward<V>(value));
+            if (!result.second) result.first->second = std::forward<V>(value);
+            return result;
+        }
+        template<typename K>
+        requires lookup<K> && std::is_constructible_v<Key, K&&>
+        Value& operator[](K&& key) { return try_emplace(std::forward<K>(key)).first->second; }
+
+        template<typename K> requires lookup<K>
+        [[nodiscard]]
+        iterator find(const K& key) { return iteratorAt(index(key, hashOf(key))); }
+        template<typename K> requires lookup<K>
+        [[nodiscard]]
+        const_iterator find(const K& key) const { return iteratorAt(index(key, hashOf(key))); }
+        template<typename K> requires lookup<K>
+        [[nodiscard]]
+        bool contains(const K& key) const { return index(key, hashOf(key)) != capacity_; }
+        template<typename K> requires lookup<K>
+        [[nodiscard]]
+        size_t count(const K& key) const { return contains(key); }
+        template<typename K> requires lookup<K>
+        [[nodiscard]]
+        Value& at(const K& key) { return slots_[present(key)].second; }
+        template<typename K> requires lookup<K>
+        [[nodiscard]]
+        const Value& at(const K& key) const { return slots_[present(key)].second; }
+
+        template<typename K> requires lookup<K> && (!std::is_convertible_v<const K&, const_iterator>)
+        size_t erase(const K& key) {
+            const size_t i = index(key, hashOf(key));
+            if (i == capacity_) return 0;
+            erase(i);
+            return 1;
+        }
+        // returns the iterator past the erased entry
+        iterator erase(const_iterator it);
+
+    private:
+        template<typename K>
+        [[nodiscard]]
+        size_t hashOf(const K& key) const {
+            return detail::mix(hash_(key));
+        }
+        static size_t maxLoad(size_t capacity) noexcept {
+            return capacity - capacity / 8;
+        }
+        template<typename K>
+        [[nodiscard]]
+        size_t index(const K& key, size_t h) const;
+        template<typename K>
+        [[nodiscard]]
+        size_t present(const K& key) const {
+            const size_t i = index(key, hashOf(key));
+            if (i == capacity_) throw std::out_of_range("Key is not in the map");
+            return i;
+        }
+        iterator iteratorAt(size_t i) noexcept { return {ctrl_.get(), slots_, i, capacity_}; }
+        const_iterator iteratorAt(size_t i) const noexcept { return {ctrl_.get(), slots_, i, capacity_}; }
+        [[nodiscard]]
+        size_t freeSlot(size_t h) const;
+        void erase(size_t i);
+        void rehash(size_t capacity);
+        void destroy() noexcept;
+    };
+
+    template<typename Key, typename Value, typename H, typename Eq>
+    FlatHashMap<Key, Value, H, Eq>::FlatHashMap(size_t capacity, const H& hash, const Eq& eq)
+            : hash_(hash)
+            , eq_(eq)
+    {
+        reserve(capacity);
+    }
+
+    template<typename Key, typename Value, typename H, typename Eq>
+    FlatHashMap<Key, Value, H, Eq>::FlatHashMap(const FlatHashMap& other)
+            : hash_(other.hash_)
+            , eq_(other.eq_)
+    {
+        reserve(other.size_);
+        for (const auto& kv : other) insert(kv);
+    }
+
+    template<typename Key, typename Value, typename H, typename Eq>
+    FlatHashMap<Key, Value, H, Eq>::FlatHashMap(FlatHashMap&& other) noexcept
+            : ctrl_(std::move(other.ctrl_))
+            , slots_(std::exchange(other.slots_, nullptr))
+            , capacity_(std::exchange(other.capacity_, 0))
+            , size_(std::exchange(other.size_, 0))
+            , growthLeft_(std::exchange(other.growthLeft_, 0))
+            , hash_(other.hash_)
+            , eq_(other.eq_)
+    {}
+
+    template<typename Key, typename Value, typename H, typename Eq>
+    FlatHashMap<Key, Value, H, Eq>& FlatHashMap<Key, Value, H, Eq>::operator=(FlatHashMap other) noexcept {
+        std::swap(ctrl_, other.ctrl_);
+        std::swap(slots_, other.slots_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(size_, other.size_);
+        std::swap(growthLeft_, other.growthLeft_);
+        std::swap(hash_, other.hash_);
+        std::swap(eq_, other.eq_);
+        return *this;
+    }
+
+    template<typename Key, typename Value, typename H, typename Eq>
+    FlatHashMap<Key, Value, H, Eq>::~FlatHashMap() {
+        destroy();
+    }
+
+    template<typename Key, typename Value, typename H, typename Eq>
+    void FlatHashMap<Key, Value, H, Eq>::destroy() noexcept {
+        if (!slots_) return;
+        for (size_t i = 0; i < capacity_; ++i)
+            if (ctrl_[i] >= 0) std::destroy_at(slots_ + i);
+        std::allocator<value_type>().deallocate(slots_, capacity_);
+        slots_ = nullptr;
+    }
+
+    template<typename Key, typename Value, typename H, typename Eq>
+    void FlatHashMap<Key, Value, H, Eq>::reserve(size_t n) {
+        size_t capacity = capacity_ ? capacity_ : Group::width;
+        while (maxLoad(capacity) < n) capacity *= 2;
+        if (capacity != capacity_ && n > 0) rehash(capacity);
+    }
+
+    template<typename Key, typename Value, typename H, typename Eq>
+    void FlatHashMap<Key, Value, H, Eq>::clear() noexcept {
+        for (size_t i = 0; i < capacity_; ++i)
+            if (ctrl_[i] >= 0) std::destroy_at(slots_ + i);
+        std::fill(ctrl_.get(), ctrl_.get() + capacity_, detail::empty);
+        size_ = 0;
+        growthLeft_ = maxLoad(capacity_);
+    }
+
+    template<typename Key, typename Value, typename H, typename Eq>
+    template<typename K>
+    size_t FlatHashMap<Key, Value, H, Eq>::index(const K& key, size_t h) const {
+        if (capacity_ == 0) return 0;
+        const auto h2 = static_cast<ctrl_t>(h & 0x7f);
+        const size_t mask = capacity_ / Group::width - 1;
+        for (size_t g = (h >> 7) & mask, step = 1;; g = (g + step++) & mask) {
+            const Group group(ctrl_.get() + g * Group::width);
+            for (uint32_t m = group.match(h2); m; m &= m - 1) {
+                const size_t i = g * Group::width + std::countr_zero(m);
+                if (eq_(slots_[i].first, key)) [[likely]] return i;
+            }
+            if (group.matchEmpty()) return capacity_;
+        }
+    }
+
+    // the first empty or deleted slot on the probe sequence of h
+    template<typename Key, typename Value, typename H, typename Eq>
+    size_t FlatHashMap<Key, Value, H, Eq>::freeSlot(size_t h) const {
+        const size_t mask = capacity_ / Group::width - 1;
+        for (size_t g = (h >> 7) & mask, step = 1;; g = (g + step++) & mask)
+            if (const uint32_t m = Group(ctrl_.get() + g * Group::width).matchFree())
+                return g * Group::width + std::countr_zero(m);
+    }
+
+    // entries are moved in hash order into fresh arrays; pair<const Key, Value> can only
+    // copy its key, so Key is copied and Value moved
+    template<typename Key, typename Value, typename H, typename Eq>
+    void FlatHashMap<Key, Value, H, Eq>::rehash(size_t capacity) {
+        auto ctrl = std::make_unique_for_overwrite<ctrl_t[]>(capacity);
+        std::fill_n(ctrl.get(), capacity, detail::empty);
+        value_type* slots = std::allocator<value_type>().allocate(capacity);
+        std::swap(ctrl_, ctrl);
+        std::swap(slots_, slots);
+        std::swap(capacity_, capacity);
+        for (size_t i = 0; i < capacity; ++i) {
+            if (ctrl[i] < 0) continue;
+            const size_t h = hashOf(slots[i].first);
+            const size_t j = freeSlot(h);
+            ctrl_[j] = static_cast<ctrl_t>(h & 0x7f);
+            std::construct_at(slots_ + j, std::move(slots[i]));
+            std::destroy_at(slots + i);
+        }
+        if (slots) std::allocator<value_type>().deallocate(slots, capacity);
+        growthLeft_ = maxLoad(capacity_) - size_;
+    }
+
+    template<typename Key, typename Value, typename H, typename Eq>
+    typename FlatHashMap<Key, Value, H, Eq>::iterator FlatHashMap<Key, Value, H, Eq>::erase(const_iterator it) {
+        erase(it.i_);
+        return iteratorAt(it.i_ + 1);
+    }
+
+    template<typename Key, typename Value, typename H, typename Eq>
+    void FlatHashMap<Key, Value, H, Eq>::erase(size_t i) {
+        std::destroy_at(slots_ + i);
+        --size_;
+        const size_t group = i / Group::width * Group::width;
+        if (Group(ctrl_.get() + group).matchEmpty()) {
+            ctrl_[i] = detail::empty;
+            ++growthLeft_;
+        } else {
+            ctrl_[i] = detail::deleted;
+        }
+    }
+}
+
+#endif //ALGO_FLAT_HASH_MAP_H
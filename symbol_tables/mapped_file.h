@@ -0,0 +1,9 @@
+#ifndef ALGO_SYMBOL_TABLES_MAPPED_FILE_H
+#define ALGO_SYMBOL_TABLES_MAPPED_FILE_H
+#include "../data_structures/mapped_file.h"
+
+namespace symbol_tables {
+    using data_structures::MappedFile;
+}
+
+#endif //ALGO_SYMBOL_TABLES_MAPPED_FILE_H
@@ -0,0 +1,662 @@
+#ifndef ALGO_RADIX_TREE_H
+#define ALGO_RADIX_TREE_H
+#include <bit>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include "flat_hash_map.h"
+
+namespace symbol_tables {
+    /** Compressed radix tree with adaptive nodes (Leis, Kemper, Neumann: ART) ***************
+     * A trie in which every chain of single-child nodes is one edge labelled with the
+     * whole byte string, so there is a node per key and per branch point, not per byte.
+     * Labels are slices of one contiguous pool: a new key appends only the part no edge
+     * spells yet, and splitting an edge splits its slice without copying. Keys with long
+     * shared prefixes, URLs and paths, thus store each distinct byte once.
+     *
+     * A node's children are indexed by the first byte of their label in one of four
+     * block sizes, as in ART, so a sparse node stays small and a dense one is an array:
+     *     4    sorted bytes and children, scanned
+     *     16   sorted bytes compared in one SSE2 instruction (detail::Group)
+     *     48   a 256-byte index into 48 children
+     *     256  the children themselves
+     * A node moves to the next size when it fills up; blocks are recycled through a free
+     * list per size. Nodes are 20 bytes and link by 32-bit index; values sit in a
+     * separate array. The pool is limited to 4 GB of live labels: remove() leaves the
+     * bytes it frees behind until they outnumber the live ones, then rewrites the pool
+     * with the live labels only, depth first, in time linear in the tree. Churn thus
+     * keeps the pool within about twice the labels in use.
+     *
+     * Keys are byte strings compared as unsigned bytes, so keys() come out in the order
+     * of std::string's operator<; '.' in a keysThatMatch() pattern matches any byte.
+     * remove() prunes the nodes that lead to no key, and folds a node left with no key
+     * and one child into the child when their labels are adjacent in the pool, as they
+     * are when a split made them; otherwise the node stays as a pass-through.
+     */
+    template<typename Value>
+    class RadixTree {
+    private:
+        static constexpr uint32_t nil = 0;      // as a child: the root is nobody's child
+        static constexpr uint32_t none = UINT32_MAX;
+
+        enum Kind : uint8_t { leaf, n4, n16, n48, n256 };
+
+        struct Node {
+            uint32_t label = 0;             // label bytes: pool_[label, label + length)
+            uint32_t length = 0;
+            uint32_t value = none;          // index into values_
+            uint32_t block = none;          // children, in the block array of kind
+            Kind kind = leaf;
+        };
+
+        struct Node4 {
+            uint8_t count = 0;
+            uint8_t bytes[4] = {};
+            uint32_t children[4] = {};
+        };
+        struct Node16 {
+            uint8_t count = 0;
+            alignas(16) uint8_t bytes[16] = {};
+            uint32_t children[16] = {};
+        };
+        struct Node48 {
+            uint8_t count = 0;
+            uint8_t index[256] = {};        // slot + 1, 0 if no child
+            uint32_t children[48] = {};
+        };
+        struct Node256 {
+            uint16_t count = 0;
+            uint32_t children[256] = {};
+        };
+
+        // a block array with its free list
+        template<typename B>
+        struct Blocks {
+            std::vector<B> blocks;
+            std::vector<uint32_t> free;
+
+            uint32_t allocate() {
+                if (!free.empty()) {
+                    const uint32_t b = free.back();
+                    free.pop_back();
+                    blocks[b] = B{};
+                    return b;
+                }
+                blocks.emplace_back();
+                return static_cast<uint32_t>(blocks.size() - 1);
+            }
+            void release(uint32_t b) { free.push_back(b); }
+            [[nodiscard]]
+            size_t memory() const noexcept {
+                return blocks.capacity() * sizeof(B) + free.capacity() * sizeof(uint32_t);
+            }
+        };
+
+        std::vector<Node> nodes_ = std::vector<Node>(1);    // the root, with an empty label
+        std::vector<char> pool_;
+        size_t live_ = 0;                   // pool bytes some node's label still covers
+        std::vector<Value> values_;
+        std::vector<uint32_t> freeValues_, freeNodes_;
+        Blocks<Node4> n4_;
+        Blocks<Node16> n16_;
+        Blocks<Node48> n48_;
+        Blocks<Node256> n256_;
+        size_t size_ = 0;
+
+    public:
+        RadixTree() = default;
+
+        [[nodiscard]]
+        size_t size() const noexcept { return size_; }
+        [[nodiscard]]
+        bool empty() const noexcept { return size_ == 0; }
+        // bytes held by all the arrays, capacity included
+        [[nodiscard]]
+        size_t memory() const noexcept;
+
+        // inserts or replaces
+        void put(std::string_view key, Value value);
+        [[nodiscard]]
+        std::optional<Value> get(std::string_view key) const;
+        [[nodiscard]]
+        bool contains(std::string_view key) const;
+        // false if the key was not there
+        bool remove(std::string_view key);
+
+        [[nodiscard]]
+        std::vector<std::string> keys() const { return keysWithPrefix({}); }
+        [[nodiscard]]
+        std::vector<std::string> keysWithPrefix(std::string_view prefix) const;
+        // the keys as long as pattern that match it, '.' matching any byte
+        [[nodiscard]]
+        std::vector<std::string> keysThatMatch(std::string_view pattern) const;
+        // the longest key that is a prefix of query, if any
+        [[nodiscard]]
+        std::optional<std::string> longestPrefixOf(std::string_view query) const;
+
+    private:
+        [[nodiscard]]
+        std::string_view label(const Node& n) const noexcept { return {pool_.data() + n.label, n.length}; }
+        [[nodiscard]]
+        uint8_t first(uint32_t x) const noexcept { return static_cast<uint8_t>(pool_[nodes_[x].label]); }
+        uint32_t allocate(uint32_t label, uint32_t length);
+        uint32_t append(std::string_view bytes);
+        void compact();
+        uint32_t store(Value& value);
+        // the node key ends on, nil if it ends inside an edge or leaves the tree
+        uint32_t find(std::string_view key) const;
+
+        uint32_t child(uint32_t x, uint8_t b) const noexcept;
+        void addChild(uint32_t x, uint8_t b, uint32_t c);
+        void setChild(uint32_t x, uint8_t b, uint32_t c) noexcept;
+        void removeChild(uint32_t x, uint8_t b);
+        [[nodiscard]]
+        size_t children(uint32_t x) const noexcept;
+        template<typename F>
+        void forEachChild(uint32_t x, F&& f) const;
+
+        void collect(uint32_t x, std::string& prefix, std::vector<std::string>& out) const;
+        void collect(uint32_t x, std::string& prefix, std::string_view pattern, std::vector<std::string>& out) const;
+    };
+
+    template<typename Value>
+    size_t RadixTree<Value>::memory() const noexcept {
+        return nodes_.capacity() * sizeof(Node) + pool_.capacity() + values_.capacity() * sizeof(Value)
+               + (freeValues_.capacity() + freeNodes_.capacity()) * sizeof(uint32_t)
+               + n4_.memory() + n16_.memory() + n48_.memory() + n256_.memory();
+    }
+
+    template<typename Value>
+    uint32_t RadixTree<Value>::allocate(uint32_t label, uint32_t length) {
+        uint32_t x;
+        if (!freeNodes_.empty()) {
+            x = freeNodes_.back();
+            freeNodes_.pop_back();
+            nodes_[x] = Node{};
+        } else {
+            if (nodes_.size() >= none) throw std::length_error("Radix tree is full");
+            x = static_cast<uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+        }
+        nodes_[x].label = label;
+        nodes_[x].length = length;
+        return x;
+    }
+
+    template<typename Value>
+    uint32_t RadixTree<Value>::append(std::string_view bytes) {
+        if (pool_.size() + bytes.size() > none) throw std::length_error("Radix tree string pool is full");
+        const auto at = static_cast<uint32_t>(pool_.size());
+        pool_.insert(pool_.end(), bytes.begin(), bytes.end());
+        return at;
+    }
+
+    // parents go before their children, so a node and its first child stay adjacent and
+    // remove() can still fold them
+    template<typename Value>
+    void RadixTree<Value>::compact() {
+        std::vector<char> pool;
+        pool.reserve(live_);
+        std::vector<uint32_t> stack{0};
+        while (!stack.empty()) {
+            const uint32_t x = stack.back();
+            stack.pop_back();
+            Node& n = nodes_[x];
+            const auto at = static_cast<uint32_t>(pool.size());
+            pool.insert(pool.end(), pool_.begin() + n.label, pool_.begin() + n.label + n.length);
+            n.label = at;
+            const size_t top = stack.size();
+            forEachChild(x, [&](uint32_t c) { stack.push_back(c); });
+            std::reverse(stack.begin() + static_cast<std::ptrdiff_t>(top), stack.end());
+        }
+        pool_ = std::move(pool);
+    }
+
+    template<typename Value>
+    uint32_t RadixTree<Value>::store(Value& value) {
+        if (!freeValues_.empty()) {
+            const uint32_t v = freeValues_.back();
+            freeValues_.pop_back();
+            values_[v] = std::move(value);
+            return v;
+        }
+        values_.push_back(std::move(value));
+        return static_cast<uint32_t>(values_.size() - 1);
+    }
+
+    template<typename Value>
+    uint32_t RadixTree<Value>::child(uint32_t x, uint8_t b) const noexcept {
+        const Node& n = nodes_[x];
+        switch (n.kind) {
+            case n4: {
+                const Node4& block = n4_.blocks[n.block];
+                for (size_t i = 0; i < block.count; ++i)
+                    if (block.bytes[i] == b) return block.children[i];
+                return nil;
+            }
+            case n16: {
+                const Node16& block = n16_.blocks[n.block];
+                const uint32_t match = detail::Group(reinterpret_cast<const detail::ctrl_t*>(block.bytes))
+                                               .match(static_cast<detail::ctrl_t>(b))
+                                       & ((1u << block.count) - 1);
+                return match ? block.children[std::countr_zero(match)] : nil;
+            }
+            case n48: {
+                const Node48& block = n48_.blocks[n.block];
+                return block.index[b] ? block.children[block.index[b] - 1] : nil;
+            }
+            case n256:
+                return n256_.blocks[n.block].children[b];
+            default:
+                return nil;
+        }
+    }
+
+    // sorted insert into the byte and child arrays of a 4- or 16-block with room
+    namespace detail {
+        template<typename B>
+        void insertSorted(B& block, uint8_t b, uint32_t c) noexcept {
+            size_t i = block.count;
+            for (; i > 0 && block.bytes[i - 1] > b; --i) {
+                block.bytes[i] = block.bytes[i - 1];
+                block.children[i] = block.children[i - 1];
+            }
+            block.bytes[i] = b;
+            block.children[i] = c;
+            ++block.count;
+        }
+    }
+
+    // grows the block when it is full; the block arrays may move, so nothing is held
+    // across an allocate()
+    template<typename Value>
+    void RadixTree<Value>::addChild(uint32_t x, uint8_t b, uint32_t c) {
+        switch (nodes_[x].kind) {
+            case leaf:
+                nodes_[x].block = n4_.allocate();
+                nodes_[x].kind = n4;
+                [[fallthrough]];
+            case n4: {
+                if (n4_.blocks[nodes_[x].block].count < 4) {
+                    detail::insertSorted(n4_.blocks[nodes_[x].block], b, c);
+                    return;
+                }
+                const uint32_t grown = n16_.allocate();
+                const Node4& old = n4_.blocks[nodes_[x].block];
+                Node16& block = n16_.blocks[grown];
+                block.count = old.count;
+                std::copy(old.bytes, old.bytes + old.count, block.bytes);
+                std::copy(old.children, old.children + old.count, block.children);
+                n4_.release(nodes_[x].block);
+                nodes_[x].block = grown;
+                nodes_[x].kind = n16;
+                detail::insertSorted(block, b, c);
+                return;
+            }
+            case n16: {
+                if (n16_.blocks[nodes_[x].block].count < 16) {
+                    detail::insertSorted(n16_.blocks[nodes_[x].block], b, c);
+                    return;
+                }
+                const uint32_t grown = n48_.allocate();
+                const Node16& old = n16_.blocks[nodes_[x].block];
+                Node48& block = n48_.blocks[grown];
+                for (uint8_t i = 0; i < old.count; ++i) {
+                    block.index[old.bytes[i]] = i + 1;
+                    block.children[i] = old.children[i];
+                }
+                block.count = old.count;
+                n16_.release(nodes_[x].block);
+                nodes_[x].block = grown;
+                nodes_[x].kind = n48;
+                block.index[b] = ++block.count;
+                block.children[block.count - 1] = c;
+                return;
+            }
+            case n48: {
+                Node48& block = n48_.blocks[nodes_[x].block];
+                if (block.count < 48) {
+                    // removals leave holes: take the first free slot
+                    uint8_t slot = 0;
+                    while (block.children[slot] != nil) ++slot;
+                    block.children[slot] = c;
+                    block.index[b] = slot + 1;
+                    ++block.count;
+                    return;
+                }
+                const uint32_t grown = n256_.allocate();
+                const Node48& old = n48_.blocks[nodes_[x].block];
+                Node256& wide = n256_.blocks[grown];
+                for (size_t i = 0; i < 256; ++i)
+                    if (old.index[i]) wide.children[i] = old.children[old.index[i] - 1];
+                wide.count = old.count;
+                n48_.release(nodes_[x].block);
+                nodes_[x].block = grown;
+                nodes_[x].kind = n256;
+                wide.children[b] = c;
+                ++wide.count;
+                return;
+            }
+            case n256: {
+                Node256& block = n256_.blocks[nodes_[x].block];
+                block.children[b] = c;
+                ++block.count;
+                return;
+            }
+        }
+    }
+
+    // replaces the existing child under b
+    template<typename Value>
+    void RadixTree<Value>::setChild(uint32_t x, uint8_t b, uint32_t c) noexcept {
+        const Node& n = nodes_[x];
+        switch (n.kind) {
+            case n4: {
+                Node4& block = n4_.blocks[n.block];
+                for (size_t i = 0; i < block.count; ++i)
+                    if (block.bytes[i] == b) block.children[i] = c;
+                return;
+            }
+            case n16: {
+                Node16& block = n16_.blocks[n.block];
+                for (size_t i = 0; i < block.count; ++i)
+                    if (block.bytes[i] == b) block.children[i] = c;
+                return;
+            }
+            case n48: {
+                Node48& block = n48_.blocks[n.block];
+                block.children[block.index[b] - 1] = c;
+                return;
+            }
+            case n256:
+                n256_.blocks[n.block].children[b] = c;
+                return;
+            default:
+                return;
+        }
+    }
+
+    // blocks do not shrink, except that a node without children drops its block
+    template<typename Value>
+    void RadixTree<Value>::removeChild(uint32_t x, uint8_t b) {
+        Node& n = nodes_[x];
+        size_t left = 0;
+        auto removeSorted = [b](auto& block) {
+            size_t i = 0;
+            while (block.bytes[i] != b) ++i;
+            for (; i + 1 < block.count; ++i) {
+                block.bytes[i] = block.bytes[i + 1];
+                block.children[i] = block.children[i + 1];
+            }
+            return --block.count;
+        };
+        switch (n.kind) {
+            case n4:
+                left = removeSorted(n4_.blocks[n.block]);
+                if (!left) n4_.release(n.block);
+                break;
+            case n16:
+                left = removeSorted(n16_.blocks[n.block]);
+                if (!left) n16_.release(n.block);
+                break;
+            case n48: {
+                Node48& block = n48_.blocks[n.block];
+                block.children[block.index[b] - 1] = nil;
+                block.index[b] = 0;
+                left = --block.count;
+                if (!left) n48_.release(n.block);
+                break;
+            }
+            case n256: {
+                Node256& block = n256_.blocks[n.block];
+                block.children[b] = nil;
+                left = --block.count;
+                if (!left) n256_.release(n.block);
+                break;
+            }
+            default:
+                return;
+        }
+        if (!left) {
+            n.kind = leaf;
+            n.block = none;
+        }
+    }
+
+    template<typename Value>
+    size_t RadixTree<Value>::children(uint32_t x) const noexcept {
+        const Node& n = nodes_[x];
+        switch (n.kind) {
+            case n4: return n4_.blocks[n.block].count;
+            case n16: return n16_.blocks[n.block].count;
+            case n48: return n48_.blocks[n.block].count;
+            case n256: return n256_.blocks[n.block].count;
+            default: return 0;
+        }
+    }
+
+    // f(child) in the order of the children's first bytes
+    template<typename Value>
+    template<typename F>
+    void RadixTree<Value>::forEachChild(uint32_t x, F&& f) const {
+        const Node& n = nodes_[x];
+        switch (n.kind) {
+            case n4: {
+                const Node4& block = n4_.blocks[n.block];
+                for (size_t i = 0; i < block.count; ++i) f(block.children[i]);
+                return;
+            }
+            case n16: {
+                const Node16& block = n16_.blocks[n.block];
+                for (size_t i = 0; i < block.count; ++i) f(block.children[i]);
+                return;
+            }
+            case n48: {
+                const Node48& block = n48_.blocks[n.block];
+                for (size_t b = 0; b < 256; ++b)
+                    if (block.index[b]) f(block.children[block.index[b] - 1]);
+                return;
+            }
+            case n256: {
+                const Node256& block = n256_.blocks[n.block];
+                for (size_t b = 0; b < 256; ++b)
+                    if (block.children[b] != nil) f(block.children[b]);
+                return;
+            }
+            default:
+                return;
+        }
+    }
+
+    template<typename Value>
+    uint32_t RadixTree<Value>::find(std::string_view key) const {
+        uint32_t x = 0;
+        for (size_t d = 0; d < key.size();) {
+            x = child(x, static_cast<uint8_t>(key[d]));
+            if (x == nil) return nil;
+            const std::string_view l = label(nodes_[x]);
+            if (key.substr(d, l.size()) != l) return nil;
+            d += l.size();
+        }
+        return x;
+    }
+
+    template<typename Value>
+    std::optional<Value> RadixTree<Value>::get(std::string_view key) const {
+        const uint32_t x = find(key);
+        if ((x == nil && !key.empty()) || nodes_[x].value == none) return std::nullopt;
+        return values_[nodes_[x].value];
+    }
+
+    template<typename Value>
+    bool RadixTree<Value>::contains(std::string_view key) const {
+        const uint32_t x = find(key);
+        return (x != nil || key.empty()) && nodes_[x].value != none;
+    }
+
+    // Follow the key down; where it leaves the tree, hang the rest of it off as a new
+    // leaf, and where it parts from an edge, split the edge first.
+    template<typename Value>
+    void RadixTree<Value>::put(std::string_view key, Value value) {
+        uint32_t x = 0;
+        size_t d = 0;
+        while (d < key.size()) {
+            const uint8_t b = static_cast<uint8_t>(key[d]);
+            const uint32_t c = child(x, b);
+            if (c == nil) {
+                const uint32_t l = append(key.substr(d));
+                live_ += key.size() - d;
+                const uint32_t y = allocate(l, static_cast<uint32_t>(key.size() - d));
+                addChild(x, b, y);
+                x = y;
+                d = key.size();
+                break;
+            }
+            const std::string_view l = label(nodes_[c]);
+            const std::string_view rest = key.substr(d);
+            const size_t m = std::mismatch(l.begin(), l.end(), rest.begin(), rest.end()).first - l.begin();
+            if (m < l.size()) {
+                const uint32_t split = allocate(nodes_[c].label, static_cast<uint32_t>(m));
+                nodes_[c].label += static_cast<uint32_t>(m);
+                nodes_[c].length -= static_cast<uint32_t>(m);
+                addChild(split, first(c), c);
+                setChild(x, b, split);
+                x = split;
+            } else {
+                x = c;
+            }
+            d += m;
+        }
+        if (nodes_[x].value != none) {
+            values_[nodes_[x].value] = std::move(value);
+        } else {
+            const uint32_t v = store(value);
+            nodes_[x].value = v;
+            ++size_;
+        }
+    }
+
+    template<typename Value>
+    bool RadixTree<Value>::remove(std::string_view key) {
+        std::vector<uint32_t> path{0};
+        for (size_t d = 0; d < key.size();) {
+            const uint32_t c = child(path.back(), static_cast<uint8_t>(key[d]));
+            if (c == nil) return false;
+            const std::string_view l = label(nodes_[c]);
+            if (key.substr(d, l.size()) != l) return false;
+            path.push_back(c);
+            d += l.size();
+        }
+        uint32_t x = path.back();
+        if (nodes_[x].value == none) return false;
+        freeValues_.push_back(nodes_[x].value);
+        nodes_[x].value = none;
+        --size_;
+
+        // leaves that hold no key go, bottom up; then the lowest node left may have no
+        // key and one child, which can take its place
+        for (; x != 0 && nodes_[x].value == none && nodes_[x].kind == leaf; x = path.back()) {
+            path.pop_back();
+            removeChild(path.back(), first(x));
+            live_ -= nodes_[x].length;
+            freeNodes_.push_back(x);
+        }
+        if (pool_.size() - live_ > std::max(live_, size_t{4096})) compact();
+        if (x == 0 || nodes_[x].value != none || children(x) != 1) return true;
+        uint32_t only = nil;
+        forEachChild(x, [&](uint32_t c) { only = c; });
+        Node& n = nodes_[x];
+        Node& c = nodes_[only];
+        if (n.label + n.length != c.label) return true;
+        const uint8_t b = first(only);
+        c.label = n.label;
+        c.length += n.length;
+        removeChild(x, b);
+        setChild(path[path.size() - 2], first(only), only);
+        freeNodes_.push_back(x);
+        return true;
+    }
+
+    template<typename Value>
+    std::vector<std::string> RadixTree<Value>::keysWithPrefix(std::string_view prefix) const {
+        std::vector<std::string> out;
+        uint32_t x = 0;
+        std::string buffer;
+        for (size_t d = 0; d < prefix.size();) {
+            x = child(x, static_cast<uint8_t>(prefix[d]));
+            if (x == nil) return out;
+            const std::string_view l = label(nodes_[x]);
+            const std::string_view rest = prefix.substr(d);
+            // the prefix may end inside this edge: then everything below matches
+            if (l.substr(0, rest.size()) != rest.substr(0, l.size())) return out;
+            buffer.append(l);
+            d += l.size();
+        }
+        if (x == 0) buffer.clear();
+        else buffer.erase(buffer.size() - nodes_[x].length);
+        collect(x, buffer, out);
+        return out;
+    }
+
+    // x's label is not yet in prefix
+    template<typename Value>
+    void RadixTree<Value>::collect(uint32_t x, std::string& prefix, std::vector<std::string>& out) const {
+        const size_t length = prefix.size();
+        prefix.append(label(nodes_[x]));
+        if (nodes_[x].value != none) out.push_back(prefix);
+        forEachChild(x, [&](uint32_t c) { collect(c, prefix, out); });
+        prefix.resize(length);
+    }
+
+    template<typename Value>
+    std::vector<std::string> RadixTree<Value>::keysThatMatch(std::string_view pattern) const {
+        std::vector<std::string> out;
+        std::string buffer;
+        collect(0, buffer, pattern, out);
+        return out;
+    }
+
+    template<typename Value>
+    void RadixTree<Value>::collect(uint32_t x, std::string& prefix, std::string_view pattern,
+                                   std::vector<std::string>& out) const {
+        const std::string_view l = label(nodes_[x]);
+        const size_t d = prefix.size();
+        if (d + l.size() > pattern.size()) return;
+        for (size_t i = 0; i < l.size(); ++i)
+            if (pattern[d + i] != '.' && pattern[d + i] != l[i]) return;
+        prefix.append(l);
+        if (prefix.size() == pattern.size()) {
+            if (nodes_[x].value != none) out.push_back(prefix);
+        } else if (pattern[prefix.size()] == '.') {
+            forEachChild(x, [&](uint32_t c) { collect(c, prefix, pattern, out); });
+        } else if (const uint32_t c = child(x, static_cast<uint8_t>(pattern[prefix.size()])); c != nil) {
+            collect(c, prefix, pattern, out);
+        }
+        prefix.resize(d);
+    }
+
+    template<typename Value>
+    std::optional<std::string> RadixTree<Value>::longestPrefixOf(std::string_view query) const {
+        std::optional<size_t> length;
+        if (nodes_[0].value != none) length = 0;
+        uint32_t x = 0;
+        for (size_t d = 0; d < query.size();) {
+            x = child(x, static_cast<uint8_t>(query[d]));
+            if (x == nil) break;
+            const std::string_view l = label(nodes_[x]);
+            if (query.substr(d, l.size()) != l) break;
+            d += l.size();
+            if (nodes_[x].value != none) length = d;
+        }
+        if (!length) return std::nullopt;
+        return std::string(query.substr(0, *length));
+    }
+}
+
+#endif //ALGO_RADIX_TREE_H
@@ -0,0 +1,423 @@
+#ifndef ALGO_RED_BLACK_BST_H
+#define ALGO_RED_BLACK_BST_H
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+
+namespace symbol_tables {
+    /** Left-leaning red-black BST (Sedgewick) **********************************************
+     * A 2-3 tree drawn as a binary tree: a red link glues a node to its parent as one
+     * 3-node, red links lean left and no node has two, so every path from the root down
+     * has the same number of black links and the height is at most 2 lg n. Each node
+     * keeps the size of its subtree, which gives rank(), select() and size(lo, hi) in
+     * O(log n).
+     *
+     * Nodes live in one arena, a vector, and link to each other by 32-bit index instead
+     * of by pointer; index 0 is a black sentinel of size 0 that stands for null. Removed
+     * nodes go on a free list, chained through `left`, and are reused by put(). Dropping
+     * the tree, or clear(), releases the arena in one piece: no walk over the nodes, and
+     * no work per node at all when Key and Value are trivially destructible. Key and Value
+     * must be default constructible (for the sentinel).
+     */
+    template<typename Key, typename Value>
+    class RedBlackBST {
+    private:
+        static constexpr uint32_t nil = 0;
+
+        struct Node {
+            Key key{};
+            Value value{};
+            uint32_t left = nil, right = nil;
+            uint32_t size : 31 = 0;
+            uint32_t red : 1 = 0;
+        };
+
+        std::vector<Node> nodes_ = std::vector<Node>(1);
+        uint32_t root_ = nil;
+        uint32_t free_ = nil;
+
+    public:
+        // at most 2^31 - 1 keys: the subtree size shares its word with the colour
+        static constexpr size_t maxSize = (size_t{1} << 31) - 1;
+
+        RedBlackBST() = default;
+        // room for n keys without growing the arena
+        void reserve(size_t n) {
+            nodes_.reserve(std::min(n, maxSize) + 1);
+        }
+
+        [[nodiscard]]
+        size_t size() const noexcept { return size(root_); }
+        [[nodiscard]]
+        bool empty() const noexcept { return root_ == nil; }
+        [[nodiscard]]
+        int height() const noexcept { return height(root_); }
+        // keeps the arena's capacity for the next keys
+        void clear() noexcept {
+            nodes_.resize(1);
+            root_ = free_ = nil;
+        }
+
+        // inserts or replaces
+        void put(const Key& key, Value value);
+        [[nodiscard]]
+        std::optional<Value> get(const Key& key) const;
+        [[nodiscard]]
+        bool contains(const Key& key) const { return find(key) != nil; }
+        // false if the key was not there
+        bool remove(const Key& key);
+
+        // the smallest and largest keys; throw std::out_of_range on an empty table
+        [[nodiscard]]
+        const Key& min() const;
+        [[nodiscard]]
+        const Key& max() const;
+        // the largest key <= key and the smallest key >= key, if any
+        [[nodiscard]]
+        std::optional<Key> floor(const Key& key) const;
+        [[nodiscard]]
+        std::optional<Key> ceiling(const Key& key) const;
+        // number of keys < key
+        [[nodiscard]]
+        size_t rank(const Key& key) const;
+        // the key of rank k; throws std::out_of_range unless k < size()
+        [[nodiscard]]
+        const Key& select(size_t k) const;
+        // number of keys in [lo, hi]
+        [[nodiscard]]
+        size_t size(const Key& lo, const Key& hi) const;
+        // the keys in [lo, hi], in order
+        [[nodiscard]]
+        std::vector<Key> keys(const Key& lo, const Key& hi) const;
+        [[nodiscard]]
+        std::vector<Key> keys() const;
+
+    private:
+        Node& at(uint32_t x) noexcept { return nodes_[x]; }
+        const Node& at(uint32_t x) const noexcept { return nodes_[x]; }
+        [[nodiscard]]
+        size_t size(uint32_t x) const noexcept { return nodes_[x].size; }
+        [[nodiscard]]
+        bool isRed(uint32_t x) const noexcept { return nodes_[x].red; }
+        int height(uint32_t x) const noexcept;
+        uint32_t find(const Key& key) const;
+        uint32_t allocate(const Key& key, Value& value);
+        void release(uint32_t x);
+        void resize(uint32_t h) noexcept;
+
+        uint32_t put(uint32_t h, const Key& key, Value& value);
+        uint32_t remove(uint32_t h, const Key& key);
+        uint32_t removeMin(uint32_t h);
+        uint32_t rotateLeft(uint32_t h) noexcept;
+        uint32_t rotateRight(uint32_t h) noexcept;
+        void flipColors(uint32_t h) noexcept;
+        uint32_t moveRedLeft(uint32_t h) noexcept;
+        uint32_t moveRedRight(uint32_t h) noexcept;
+        uint32_t balance(uint32_t h) noexcept;
+        void keys(uint32_t x, const Key& lo, const Key& hi, std::vector<Key>& out) const;
+    };
+
+    template<typename Key, typename Value>
+    int RedBlackBST<Key, Value>::height(uint32_t x) const noexcept {
+        if (x == nil) return 0;
+        return 1 + std::max(height(at(x).left), height(at(x).right));
+    }
+
+    template<typename Key, typename Value>
+    uint32_t RedBlackBST<Key, Value>::find(const Key& key) const {
+        uint32_t x = root_;
+        while (x != nil) {
+            if (key < at(x).key) x = at(x).left;
+            else if (at(x).key < key) x = at(x).right;
+            else return x;
+        }
+        return nil;
+    }
+
+    // may grow the arena: callers hold indices, never references, across it
+    template<typename Key, typename Value>
+    uint32_t RedBlackBST<Key, Value>::allocate(const Key& key, Value& value) {
+        uint32_t x = free_;
+        if (x != nil) {
+            free_ = at(x).left;
+        } else {
+            if (nodes_.size() > maxSize) throw std::length_error("Red-black tree is full");
+            x = static_cast<uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+        }
+        Node& n = at(x);
+        n.key = key;
+        n.value = std::move(value);
+        n.left = n.right = nil;
+        n.size = 1;
+        n.red = 1;
+        return x;
+    }
+
+    // the node's key and value stay until the slot is reused
+    template<typename Key, typename Value>
+    void RedBlackBST<Key, Value>::release(uint32_t x) {
+        at(x).left = free_;
+        free_ = x;
+    }
+
+    template<typename Key, typename Value>
+    void RedBlackBST<Key, Value>::resize(uint32_t h) noexcept {
+        at(h).size = static_cast<uint32_t>(1 + size(at(h).left) + size(at(h).right));
+    }
+
+    template<typename Key, typename Value>
+    void RedBlackBST<Key, Value>::put(const Key& key, Value value) {
+        root_ = put(root_, key, value);
+        at(root_).red = 0;
+    }
+
+    template<typename Key, typename Value>
+    uint32_t RedBlackBST<Key, Value>::put(uint32_t h, const Key& key, Value& value) {
+        if (h == nil) return allocate(key, value);
+        if (key < at(h).key) {
+            const uint32_t left = put(at(h).left, key, value);
+            at(h).left = left;
+        } else if (at(h).key < key) {
+            const uint32_t right = put(at(h).right, key, value);
+            at(h).right = right;
+        } else {
+            at(h).value = std::move(value);
+        }
+        return balance(h);
+    }
+
+    template<typename Key, typename Value>
+    std::optional<Value> RedBlackBST<Key, Value>::get(const Key& key) const {
+        const uint32_t x = find(key);
+        if (x == nil) return std::nullopt;
+        return at(x).value;
+    }
+
+    // Top-down: on the way down the current node is never a 2-node, borrowing from a
+    // sibling or merging with it as needed, so the key comes out of a 3- or 4-node and
+    // balance() splits the temporary 4-nodes on the way back up.
+    template<typename Key, typename Value>
+    bool RedBlackBST<Key, Value>::remove(const Key& key) {
+        if (!contains(key)) return false;
+        if (!isRed(at(root_).left) && !isRed(at(root_).right)) at(root_).red = 1;
+        root_ = remove(root_, key);
+        if (root_ != nil) at(root_).red = 0;
+        return true;
+    }
+
+    template<typename Key, typename Value>
+    uint32_t RedBlackBST<Key, Value>::remove(uint32_t h, const Key& key) {
+        if (key < at(h).key) {
+            if (!isRed(at(h).left) && !isRed(at(at(h).left).left)) h = moveRedLeft(h);
+            at(h).left = remove(at(h).left, key);
+        } else {
+            if (isRed(at(h).left)) h = rotateRight(h);
+            if (!(at(h).key < key) && at(h).right == nil) {
+                release(h);
+                return nil;
+            }
+            if (!isRed(at(h).right) && !isRed(at(at(h).right).left)) h = moveRedRight(h);
+            if (!(at(h).key < key)) {
+                // take over the successor's entry, then remove the successor
+                uint32_t x = at(h).right;
+                while (at(x).left != nil) x = at(x).left;
+                at(h).key = at(x).key;
+                at(h).value = std::move(at(x).value);
+                at(h).right = removeMin(at(h).right);
+            } else {
+                at(h).right = remove(at(h).right, key);
+            }
+        }
+        return balance(h);
+    }
+
+    template<typename Key, typename Value>
+    uint32_t RedBlackBST<Key, Value>::removeMin(uint32_t h) {
+        if (at(h).left == nil) {
+            release(h);
+            return nil;
+        }
+        if (!isRed(at(h).left) && !isRed(at(at(h).left).left)) h = moveRedLeft(h);
+        at(h).left = removeMin(at(h).left);
+        return balance(h);
+    }
+
+    template<typename Key, typename Value>
+    uint32_t RedBlackBST<Key, Value>::rotateLeft(uint32_t h) noexcept {
+        const uint32_t x = at(h).right;
+        at(h).right = at(x).left;
+        at(x).left = h;
+        at(x).red = at(h).red;
+        at(h).red = 1;
+        at(x).size = at(h).size;
+        resize(h);
+        return x;
+    }
+
+    template<typename Key, typename Value>
+    uint32_t RedBlackBST<Key, Value>::rotateRight(uint32_t h) noexcept {
+        const uint32_t x = at(h).left;
+        at(h).left = at(x).right;
+        at(x).right = h;
+        at(x).red = at(h).red;
+        at(h).red = 1;
+        at(x).size = at(h).size;
+        resize(h);
+        return x;
+    }
+
+    // only ever called on a node with two children, so the sentinel keeps its colour
+    template<typename Key, typename Value>
+    void RedBlackBST<Key, Value>::flipColors(uint32_t h) noexcept {
+        at(h).red ^= 1;
+        at(at(h).left).red ^= 1;
+        at(at(h).right).red ^= 1;
+    }
+
+    // h is red and h.left, h.left.left are black: make h.left or one of its children red
+    template<typename Key, typename Value>
+    uint32_t RedBlackBST<Key, Value>::moveRedLeft(uint32_t h) noexcept {
+        flipColors(h);
+        if (isRed(at(at(h).right).left)) {
+            at(h).right = rotateRight(at(h).right);
+            h = rotateLeft(h);
+            flipColors(h);
+        }
+        return h;
+    }
+
+    // h is red and h.right, h.right.left are black: make h.right or one of its children red
+    template<typename Key, typename Value>
+    uint32_t RedBlackBST<Key, Value>::moveRedRight(uint32_t h) noexcept {
+        flipColors(h);
+        if (isRed(at(at(h).left).left)) {
+            h = rotateRight(h);
+            flipColors(h);
+        }
+        return h;
+    }
+
+    template<typename Key, typename Value>
+    uint32_t RedBlackBST<Key, Value>::balance(uint32_t h) noexcept {
+        if (isRed(at(h).right) && !isRed(at(h).left)) h = rotateLeft(h);
+        if (isRed(at(h).left) && isRed(at(at(h).left).left)) h = rotateRight(h);
+        if (isRed(at(h).left) && isRed(at(h).right)) flipColors(h);
+        resize(h);
+        return h;
+    }
+
+    template<typename Key, typename Value>
+    const Key& RedBlackBST<Key, Value>::min() const {
+        if (empty()) throw std::out_of_range("Symbol table is empty");
+        uint32_t x = root_;
+        while (at(x).left != nil) x = at(x).left;
+        return at(x).key;
+    }
+
+    template<typename Key, typename Value>
+    const Key& RedBlackBST<Key, Value>::max() const {
+        if (empty()) throw std::out_of_range("Symbol table is empty");
+        uint32_t x = root_;
+        while (at(x).right != nil) x = at(x).right;
+        return at(x).key;
+    }
+
+    template<typename Key, typename Value>
+    std::optional<Key> RedBlackBST<Key, Value>::floor(const Key& key) const {
+        uint32_t best = nil;
+        for (uint32_t x = root_; x != nil;) {
+            if (key < at(x).key) {
+                x = at(x).left;
+            } else {
+                best = x;
+                if (!(at(x).key < key)) break;
+                x = at(x).right;
+            }
+        }
+        if (best == nil) return std::nullopt;
+        return at(best).key;
+    }
+
+    template<typename Key, typename Value>
+    std::optional<Key> RedBlackBST<Key, Value>::ceiling(const Key& key) const {
+        uint32_t best = nil;
+        for (uint32_t x = root_; x != nil;) {
+            if (at(x).key < key) {
+                x = at(x).right;
+            } else {
+                best = x;
+                if (!(key < at(x).key)) break;
+                x = at(x).left;
+            }
+        }
+        if (best == nil) return std::nullopt;
+        return at(best).key;
+    }
+
+    template<typename Key, typename Value>
+    size_t RedBlackBST<Key, Value>::rank(const Key& key) const {
+        size_t r = 0;
+        for (uint32_t x = root_; x != nil;) {
+            if (key < at(x).key) {
+                x = at(x).left;
+            } else if (at(x).key < key) {
+                r += 1 + size(at(x).left);
+                x = at(x).right;
+            } else {
+                return r + size(at(x).left);
+            }
+        }
+        return r;
+    }
+
+    template<typename Key, typename Value>
+    const Key& RedBlackBST<Key, Value>::select(size_t k) const {
+        if (k >= size()) throw std::out_of_range("Rank is out of boundaries");
+        uint32_t x = root_;
+        while (true) {
+            const size_t left = size(at(x).left);
+            if (k < left) {
+                x = at(x).left;
+            } else if (k > left) {
+                k -= left + 1;
+                x = at(x).right;
+            } else {
+                return at(x).key;
+            }
+        }
+    }
+
+    template<typename Key, typename Value>
+    size_t RedBlackBST<Key, Value>::size(const Key& lo, const Key& hi) const {
+        if (hi < lo) return 0;
+        return rank(hi) - rank(lo) + contains(hi);
+    }
+
+    template<typename Key, typename Value>
+    std::vector<Key> RedBlackBST<Key, Value>::keys(const Key& lo, const Key& hi) const {
+        std::vector<Key> out;
+        if (!(hi < lo)) keys(root_, lo, hi, out);
+        return out;
+    }
+
+    template<typename Key, typename Value>
+    std::vector<Key> RedBlackBST<Key, Value>::keys() const {
+        if (empty()) return {};
+        return keys(min(), max());
+    }
+
+    template<typename Key, typename Value>
+    void RedBlackBST<Key, Value>::keys(uint32_t x, const Key& lo, const Key& hi, std::vector<Key>& out) const {
+        if (x == nil) return;
+        const Key& key = at(x).key;
+        if (lo < key) keys(at(x).left, lo, hi, out);
+        if (!(key < lo) && !(hi < key)) out.push_back(key);
+        if (key < hi) keys(at(x).right, lo, hi, out);
+    }
+}
+
+#endif //ALGO_RED_BLACK_BST_H
@@ -0,0 +1,461 @@
+#ifndef ALGO_STATIC_TABLE_H
+#define ALGO_STATIC_TABLE_H
+#include <bit>
+#include <atomic>
+#include <thread>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include "mapped_file.h"
+
+namespace symbol_tables {
+    namespace detail {
+        // the splitmix64 finaliser, a bijection
+        inline uint64_t fmix(uint64_t z) noexcept {
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        // up to 8 bytes as a little-endian word, whatever the native byte order
+        inline uint64_t loadLittle(const char* p, size_t n) noexcept {
+            uint64_t w = 0;
+            std::memcpy(&w, p, n);
+            if constexpr (std::endian::native == std::endian::big) {
+                w = ((w & 0x00ff00ff00ff00ffULL) << 8) | ((w >> 8) & 0x00ff00ff00ff00ffULL);
+                w = ((w & 0x0000ffff0000ffffULL) << 16) | ((w >> 16) & 0x0000ffff0000ffffULL);
+                w = std::rotl(w, 32);
+            }
+            return w;
+        }
+
+        // a seeded hash of a byte string, the same wherever the byte order is: hashes end
+        // up in files, so std::hash will not do
+        inline uint64_t hashBytes(std::string_view s, uint64_t seed) noexcept {
+            uint64_t h = seed ^ (s.size() * 0x9e3779b97f4a7c15ULL);
+            const char* p = s.data();
+            size_t n = s.size();
+            for (; n >= 8; p += 8, n -= 8)
+                h = std::rotl((h ^ fmix(loadLittle(p, 8))) * 0x9e3779b97f4a7c15ULL, 31);
+            if (n > 0)
+                h = std::rotl((h ^ fmix(loadLittle(p, n))) * 0x9e3779b97f4a7c15ULL, 31);
+            return fmix(h);
+        }
+
+        // h scaled into [0, range) by its high bits (Lemire), no division
+        inline uint64_t reduce(uint64_t h, uint64_t range) noexcept {
+#ifdef __SIZEOF_INT128__
+            return static_cast<uint64_t>((static_cast<unsigned __int128>(h) * range) >> 64);
+#else
+            return h % range;
+#endif
+        }
+
+        // f(begin, end) over [0, n), one contiguous chunk per thread; f must not throw
+        template<typename F>
+        void parallelChunks(size_t n, unsigned threads, F&& f) {
+            if (threads <= 1 || n < size_t{1} << 16) {
+                f(size_t{0}, n);
+                return;
+            }
+            const size_t chunk = (n + threads - 1) / threads;
+            std::vector<std::thread> workers;
+            for (size_t lo = chunk; lo < n; lo += chunk)
+                workers.emplace_back([&f, lo, hi = std::min(n, lo + chunk)] { f(lo, hi); });
+            f(size_t{0}, std::min(n, chunk));
+            for (auto& w : workers) w.join();
+        }
+    }
+
+    /** Static symbol table on a minimal perfect hash (Limasset et al.: BBHash) ***********
+     * Built once from a fixed set of keys, then only read. The perfect hash is a cascade
+     * of bit arrays, gamma = 2 bits per key still unplaced: at level l every remaining
+     * key hashes, with the seed of l, to one bit; keys alone on their bit set it, keys
+     * that collide leave it clear and go on to level l + 1. A key's slot is the number of
+     * set bits before its own, counted with one cumulative count per 512 bits, so slots
+     * are exactly 0..n-1. That is about 3.7 bits per key, and a lookup touches one bit
+     * array 1.6 times on average, then the slot. The keys are stored in their slots so
+     * that a key outside the set is told apart.
+     *
+     * The table is a single block, in memory exactly as in its file (version 1, native
+     * byte order), every array 8-byte aligned:
+     *     64-byte header: char magic[8] = "ALGOMPH", uint32 version, uint32 flags (1 for
+     *     string keys), uint64 n, uint32 sizeof(Key) (0 for strings), uint32
+     *     sizeof(Value), uint32 levels, uint32 0, uint64 bit array words, uint64 string
+     *     bytes, uint64 0
+     *     levels + 1 uint64 bit offsets at which each level starts, then the end
+     *     the bit array words, then words / 8 + 1 uint64 counts of set bits before each
+     *     block of eight words
+     *     the keys: n Keys; or for strings n + 1 uint64 offsets into the string bytes,
+     *     followed by those bytes
+     *     n Values
+     * load() maps the file and points into it, with no other work, so a table of a
+     * billion keys is ready as soon as the header is checked; pages are faulted in by the
+     * lookups that touch them. Only the header and the section sizes are validated.
+     *
+     * Keys are integers or strings, looked up as std::string_view; values are trivially
+     * copyable. build() spreads every level over threads, and the table it returns is
+     * the same whatever their number. It takes up to 2^32 - 1 keys and rejects repeats.
+     */
+    template<typename Key, typename Value>
+    class StaticTable {
+        static_assert(std::is_trivially_copyable_v<Value> && alignof(Value) <= 8,
+                      "Values are stored as their bytes");
+
+    private:
+        static constexpr bool strings = std::is_convertible_v<const Key&, std::string_view>;
+        static_assert(strings || (std::is_integral_v<Key> && alignof(Key) <= 8), "Keys are integers or strings");
+
+    public:
+        using lookup_type = std::conditional_t<strings, std::string_view, Key>;
+
+    private:
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t flags;
+            uint64_t size;
+            uint32_t keyBytes;
+            uint32_t valueBytes;
+            uint32_t levels;
+            uint32_t reserved;
+            uint64_t words;
+            uint64_t poolBytes;
+            uint64_t reserved2;
+        };
+        static_assert(sizeof(Header) == 64);
+
+        // byte offsets of the sections
+        struct Layout {
+            size_t starts, bits, ranks, keys, pool, values, total;
+        };
+
+        static constexpr char magic[8] = {'A', 'L', 'G', 'O', 'M', 'P', 'H', '\0'};
+        static constexpr uint32_t version = 1;
+        static constexpr uint32_t stringFlag = 1;
+        static constexpr double gamma = 2;
+        static constexpr uint32_t maxLevels = 64;
+
+        MappedFile file_;
+        std::vector<uint64_t> image_;
+        const char* data_ = nullptr;
+        size_t bytes_ = 0;
+        size_t size_ = 0;
+        uint32_t levels_ = 0;
+        const uint64_t* starts_ = nullptr;
+        const uint64_t* bits_ = nullptr;
+        const uint64_t* ranks_ = nullptr;
+        const Key* keys_ = nullptr;         // integer keys
+        const uint64_t* offsets_ = nullptr; // string keys
+        const char* pool_ = nullptr;
+        const Value* values_ = nullptr;
+
+        StaticTable() = default;
+    public:
+        StaticTable(StaticTable&& other) noexcept;
+        StaticTable& operator=(StaticTable&& other) noexcept;
+        StaticTable(const StaticTable&) = delete;
+        StaticTable& operator=(const StaticTable&) = delete;
+
+        // threads = 0 uses every hardware thread
+        [[nodiscard]]
+        static StaticTable build(const std::vector<std::pair<Key, Value>>& entries, unsigned threads = 0);
+        [[nodiscard]]
+        static StaticTable load(const std::string& path);
+        void write(std::ostream& os) const;
+        void write(const std::string& path) const;
+
+        [[nodiscard]]
+        size_t size() const noexcept { return size_; }
+        [[nodiscard]]
+        bool empty() const noexcept { return size_ == 0; }
+        // the whole table, which is also the file size
+        [[nodiscard]]
+        size_t bytes() const noexcept { return bytes_; }
+        // the bit arrays and their counts: the perfect hash itself
+        [[nodiscard]]
+        size_t hashBits() const noexcept {
+            return levels_ ? static_cast<size_t>(starts_[levels_] + (starts_[levels_] / 512 + 1) * 64) : 0;
+        }
+
+        // the slot of a key in the table; a key outside it gets size() or any other slot
+        [[nodiscard]]
+        size_t slot(lookup_type key) const noexcept;
+        [[nodiscard]]
+        const Value* find(lookup_type key) const noexcept;
+        [[nodiscard]]
+        std::optional<Value> get(lookup_type key) const noexcept {
+            const Value* v = find(key);
+            if (!v) return std::nullopt;
+            return *v;
+        }
+        [[nodiscard]]
+        bool contains(lookup_type key) const noexcept { return find(key) != nullptr; }
+        // the entry in slot i < size()
+        [[nodiscard]]
+        lookup_type key(size_t i) const noexcept {
+            if constexpr (strings) return {pool_ + offsets_[i], offsets_[i + 1] - offsets_[i]};
+            else return keys_[i];
+        }
+        [[nodiscard]]
+        const Value& value(size_t i) const noexcept { return values_[i]; }
+
+    private:
+        static uint64_t hash(lookup_type key, uint32_t level) noexcept {
+            const uint64_t seed = 0x9e3779b97f4a7c15ULL * (level + 1);
+            if constexpr (strings) return detail::hashBytes(key, seed);
+            else return detail::fmix(static_cast<uint64_t>(key) ^ seed);
+        }
+        static size_t padded(size_t bytes) noexcept { return (bytes + 7) & ~size_t{7}; }
+        static Layout layout(const Header& h) noexcept;
+        void attach(const char* data, size_t bytes);
+        [[nodiscard]]
+        size_t rank(uint64_t bit) const noexcept;
+    };
+
+    template<typename Key, typename Value>
+    StaticTable<Key, Value>::StaticTable(StaticTable&& other) noexcept
+        : file_(std::move(other.file_))
+        , image_(std::move(other.image_))
+        , data_(other.data_)
+        , bytes_(std::exchange(other.bytes_, 0))
+        , size_(std::exchange(other.size_, 0))
+        , levels_(std::exchange(other.levels_, 0))
+        , starts_(other.starts_)
+        , bits_(other.bits_)
+        , ranks_(other.ranks_)
+        , keys_(other.keys_)
+        , offsets_(other.offsets_)
+        , pool_(other.pool_)
+        , values_(other.values_)
+    {}
+
+    template<typename Key, typename Value>
+    StaticTable<Key, Value>& StaticTable<Key, Value>::operator=(StaticTable&& other) noexcept {
+        if (this != &other) {
+            file_ = std::move(other.file_);
+            image_ = std::move(other.image_);
+            data_ = other.data_;
+            bytes_ = std::exchange(other.bytes_, 0);
+            size_ = std::exchange(other.size_, 0);
+            levels_ = std::exchange(other.levels_, 0);
+            starts_ = other.starts_;
+            bits_ = other.bits_;
+            ranks_ = other.ranks_;
+            keys_ = other.keys_;
+            offsets_ = other.offsets_;
+            pool_ = other.pool_;
+            values_ = other.values_;
+        }
+        return *this;
+    }
+
+    template<typename Key, typename Value>
+    auto StaticTable<Key, Value>::layout(const Header& h) noexcept -> Layout {
+        Layout l{};
+        size_t at = sizeof(Header);
+        l.starts = at;
+        at += (h.levels + size_t{1}) * sizeof(uint64_t);
+        l.bits = at;
+        at += h.words * sizeof(uint64_t);
+        l.ranks = at;
+        at += (h.words / 8 + 1) * sizeof(uint64_t);
+        l.keys = at;
+        at += strings ? (h.size + 1) * sizeof(uint64_t) : padded(h.size * h.keyBytes);
+        l.pool = at;
+        at += padded(h.poolBytes);
+        l.values = at;
+        at += padded(h.size * h.valueBytes);
+        l.total = at;
+        return l;
+    }
+
+    template<typename Key, typename Value>
+    void StaticTable<Key, Value>::attach(const char* data, size_t bytes) {
+        Header h{};
+        if (bytes < sizeof h) throw std::invalid_argument("Not a static table");
+        std::memcpy(&h, data, sizeof h);
+        if (std::memcmp(h.magic, magic, sizeof magic) != 0) throw std::invalid_argument("Not a static table");
+        if (h.version != version) throw std::invalid_argument("Unsupported static table version or byte order");
+        if ((h.flags == stringFlag) != strings || h.keyBytes != (strings ? 0 : sizeof(Key))
+            || h.valueBytes != sizeof(Value))
+            throw std::invalid_argument("Static table holds other key or value types");
+        // bounds first, so that the section sizes cannot overflow
+        if (h.levels > maxLevels || h.size > bytes || h.words > bytes || h.poolBytes > bytes
+            || layout(h).total != bytes)
+            throw std::invalid_argument("Static table size does not match its header");
+        if (reinterpret_cast<uintptr_t>(data) % 8 != 0) throw std::invalid_argument("Static table is not aligned");
+        const Layout l = layout(h);
+        data_ = data;
+        bytes_ = bytes;
+        size_ = h.size;
+        levels_ = h.levels;
+        starts_ = reinterpret_cast<const uint64_t*>(data + l.starts);
+        bits_ = reinterpret_cast<const uint64_t*>(data + l.bits);
+        ranks_ = reinterpret_cast<const uint64_t*>(data + l.ranks);
+        if constexpr (strings) {
+            offsets_ = reinterpret_cast<const uint64_t*>(data + l.keys);
+            pool_ = data + l.pool;
+        } else {
+            keys_ = reinterpret_cast<const Key*>(data + l.keys);
+        }
+        values_ = reinterpret_cast<const Value*>(data + l.values);
+        if (levels_ > 0 && starts_[levels_] != 64 * h.words)
+            throw std::invalid_argument("Static table size does not match its header");
+    }
+
+    // Level by level: every remaining key sets its bit in seen, and in twice if it was
+    // set already, with atomic ors, so the threads may take any keys in any order. The
+    // level keeps the bits set once and passes the other keys on.
+    template<typename Key, typename Value>
+    StaticTable<Key, Value> StaticTable<Key, Value>::build(const std::vector<std::pair<Key, Value>>& entries,
+                                                           unsigned threads) {
+        const size_t n = entries.size();
+        if (n >= UINT32_MAX) throw std::length_error("Static table is too large");
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+        std::vector<uint32_t> remaining(n);
+        for (size_t i = 0; i < n; ++i) remaining[i] = static_cast<uint32_t>(i);
+        std::vector<uint64_t> starts{0}, bits, hashes;
+        std::vector<uint8_t> collided;
+        while (!remaining.empty()) {
+            const auto level = static_cast<uint32_t>(starts.size() - 1);
+            if (level == maxLevels) {
+                std::vector<lookup_type> left;
+                for (uint32_t i : remaining) left.push_back(entries[i].first);
+                std::sort(left.begin(), left.end());
+                if (std::adjacent_find(left.begin(), left.end()) != left.end())
+                    throw std::invalid_argument("Repeated key");
+                throw std::runtime_error("Perfect hash did not converge");
+            }
+            const size_t words = std::max<size_t>(1, static_cast<size_t>(gamma * static_cast<double>(remaining.size()) / 64) + 1);
+            const uint64_t range = 64 * words;
+            std::vector<std::atomic<uint64_t>> seen(words), twice(words);
+            hashes.resize(remaining.size());
+            collided.resize(remaining.size());
+            detail::parallelChunks(remaining.size(), threads, [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; ++i) {
+                    const uint64_t b = detail::reduce(hash(entries[remaining[i]].first, level), range);
+                    const uint64_t mask = uint64_t{1} << (b & 63);
+                    if (seen[b >> 6].fetch_or(mask, std::memory_order_relaxed) & mask)
+                        twice[b >> 6].fetch_or(mask, std::memory_order_relaxed);
+                    hashes[i] = b;
+                }
+            });
+            detail::parallelChunks(remaining.size(), threads, [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; ++i)
+                    collided[i] = twice[hashes[i] >> 6].load(std::memory_order_relaxed) >> (hashes[i] & 63) & 1;
+            });
+            for (size_t w = 0; w < words; ++w)
+                bits.push_back(seen[w].load(std::memory_order_relaxed) & ~twice[w].load(std::memory_order_relaxed));
+            starts.push_back(starts.back() + range);
+            size_t kept = 0;
+            for (size_t i = 0; i < remaining.size(); ++i)
+                if (collided[i]) remaining[kept++] = remaining[i];
+            remaining.resize(kept);
+        }
+
+        Header h{};
+        std::memcpy(h.magic, magic, sizeof magic);
+        h.version = version;
+        h.flags = strings ? stringFlag : 0;
+        h.size = n;
+        h.keyBytes = strings ? 0 : sizeof(Key);
+        h.valueBytes = sizeof(Value);
+        h.levels = static_cast<uint32_t>(starts.size() - 1);
+        h.words = bits.size();
+        if constexpr (strings)
+            for (const auto& e : entries) h.poolBytes += std::string_view(e.first).size();
+        const Layout l = layout(h);
+
+        StaticTable t;
+        t.image_.assign(l.total / sizeof(uint64_t), 0);
+        char* data = reinterpret_cast<char*>(t.image_.data());
+        std::memcpy(data, &h, sizeof h);
+        std::memcpy(data + l.starts, starts.data(), starts.size() * sizeof(uint64_t));
+        std::memcpy(data + l.bits, bits.data(), bits.size() * sizeof(uint64_t));
+        auto* ranks = reinterpret_cast<uint64_t*>(data + l.ranks);
+        for (size_t w = 0, ones = 0; w <= bits.size(); ++w) {
+            if (w % 8 == 0) ranks[w / 8] = ones;
+            if (w < bits.size()) ones += std::popcount(bits[w]);
+        }
+        t.attach(data, l.total);
+
+        std::vector<uint32_t> slots(n);
+        detail::parallelChunks(n, threads, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) slots[i] = static_cast<uint32_t>(t.slot(entries[i].first));
+        });
+        if constexpr (strings) {
+            auto* offsets = reinterpret_cast<uint64_t*>(data + l.keys);
+            for (size_t i = 0; i < n; ++i) offsets[slots[i] + 1] = std::string_view(entries[i].first).size();
+            for (size_t i = 0; i < n; ++i) offsets[i + 1] += offsets[i];
+        }
+        detail::parallelChunks(n, threads, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                if constexpr (strings) {
+                    const std::string_view k = entries[i].first;
+                    std::memcpy(data + l.pool + t.offsets_[slots[i]], k.data(), k.size());
+                } else {
+                    std::memcpy(data + l.keys + slots[i] * sizeof(Key), &entries[i].first, sizeof(Key));
+                }
+                std::memcpy(data + l.values + slots[i] * sizeof(Value), &entries[i].second, sizeof(Value));
+            }
+        });
+        return t;
+    }
+
+    template<typename Key, typename Value>
+    StaticTable<Key, Value> StaticTable<Key, Value>::load(const std::string& path) {
+        StaticTable t;
+        t.file_ = MappedFile(path);
+        t.attach(t.file_.data(), t.file_.size());
+        return t;
+    }
+
+    template<typename Key, typename Value>
+    void StaticTable<Key, Value>::write(std::ostream& os) const {
+        os.write(data_, static_cast<std::streamsize>(bytes_));
+        if (!os) throw std::runtime_error("Cannot write the static table");
+    }
+
+    template<typename Key, typename Value>
+    void StaticTable<Key, Value>::write(const std::string& path) const {
+        std::ofstream os(path, std::ios::binary);
+        if (!os) throw std::runtime_error("Cannot open " + path);
+        write(os);
+    }
+
+    template<typename Key, typename Value>
+    size_t StaticTable<Key, Value>::rank(uint64_t bit) const noexcept {
+        const uint64_t w = bit >> 6;
+        size_t r = ranks_[w >> 3];
+        for (uint64_t i = w & ~uint64_t{7}; i < w; ++i) r += std::popcount(bits_[i]);
+        return r + std::popcount(bits_[w] & ((uint64_t{1} << (bit & 63)) - 1));
+    }
+
+    template<typename Key, typename Value>
+    size_t StaticTable<Key, Value>::slot(lookup_type key) const noexcept {
+        for (uint32_t level = 0; level < levels_; ++level) {
+            const uint64_t b = starts_[level] + detail::reduce(hash(key, level), starts_[level + 1] - starts_[level]);
+            if (bits_[b >> 6] >> (b & 63) & 1) return rank(b);
+        }
+        return size_;
+    }
+
+    template<typename Key, typename Value>
+    const Value* StaticTable<Key, Value>::find(lookup_type key) const noexcept {
+        const size_t i = slot(key);
+        if (i >= size_ || this->key(i) != key) return nullptr;
+        return values_ + i;
+    }
+}
+
+#endif //ALGO_STATIC_TABLE_H
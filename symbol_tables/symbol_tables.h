@@ -4,11 +4,15 @@
 
 #ifndef ALGO_SYMBOL_TABLES_H
 #define ALGO_SYMBOL_TABLES_H
-
-
-class symbol_tables {
-
-};
-
+// symbol tables, namespace symbol_tables
+#include "flat_hash_map.h"
+#include "bplus_tree.h"
+#include "red_black_bst.h"
+#include "concurrent_hash_map.h"
+#include "tst.h"
+#include "radix_tree.h"
+#include "mapped_file.h"
+#include "static_table.h"
+#include "filters.h"
 
 #endif //ALGO_SYMBOL_TABLES_H
@@ -1,5 +1,561 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <numeric>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "symbol_tables.h"
 
-#include <gtest/gtest>
-TEST(test_symbol_tables, binary_search_tree) {
-    EXPECT_EQ(true, true);
-}
\ No newline at end of file
+using namespace symbol_tables;
+
+TEST(test_symbol_tables, bplus_tree) {
+    // small nodes so that a few thousand keys make a tree four or five levels deep
+    BPlusTree<int, int, 128> t;
+    EXPECT_TRUE(t.empty());
+    EXPECT_THROW((void)t.min(), std::out_of_range);
+    EXPECT_THROW((void)t.select(0), std::out_of_range);
+    EXPECT_FALSE(t.floor(0).has_value());
+    EXPECT_EQ(t.begin(), t.end());
+
+    std::mt19937 gen(2);
+    std::uniform_int_distribution<int> key(-3000, 3000), op(0, 9);
+    std::map<int, int> expected;
+    for (int i = 0; i < 60000; ++i) {
+        const int k = key(gen);
+        if (op(gen) < 4) {
+            ASSERT_EQ(t.remove(k), expected.erase(k) == 1);
+        } else {
+            t.put(k, i);
+            expected[k] = i;
+        }
+        ASSERT_EQ(t.size(), expected.size());
+    }
+    EXPECT_GE(t.height(), 4);
+    EXPECT_EQ(t.min(), expected.begin()->first);
+    EXPECT_EQ(t.max(), expected.rbegin()->first);
+    std::vector<int> keys;
+    for (const auto& [k, v] : t) {
+        ASSERT_EQ(expected.at(k), v);
+        keys.push_back(k);
+    }
+    ASSERT_EQ(keys.size(), expected.size());
+    for (size_t r = 0; r < keys.size(); ++r) ASSERT_EQ(t.select(r), keys[r]);
+    for (int k = -3100; k <= 3100; ++k) {
+        const auto ge = expected.lower_bound(k);
+        const auto gt = expected.upper_bound(k);
+        ASSERT_EQ(t.rank(k), static_cast<size_t>(std::distance(expected.begin(), ge)));
+        ASSERT_EQ(t.contains(k), expected.count(k) == 1);
+        ASSERT_EQ(t.ceiling(k), ge == expected.end() ? std::nullopt : std::optional(ge->first));
+        ASSERT_EQ(t.floor(k), gt == expected.begin() ? std::nullopt : std::optional(std::prev(gt)->first));
+    }
+    for (int lo = -3100; lo <= 3100; lo += 97) {
+        const int hi = lo + 250;
+        size_t n = 0;
+        auto it = expected.lower_bound(lo);
+        for (const auto& [k, v] : t.range(lo, hi)) {
+            ASSERT_EQ(k, it->first);
+            ++it;
+            ++n;
+        }
+        EXPECT_TRUE(it == expected.upper_bound(hi));
+        EXPECT_EQ(t.size(lo, hi), n);
+    }
+    EXPECT_TRUE(t.range(5, 4).empty());
+    EXPECT_EQ(t.size(5, 4), 0);
+
+    // writes through an iterator, then everything out again
+    for (auto it = t.begin(); it != t.end(); ++it) it.value() = -it.key();
+    EXPECT_EQ(t.get(keys[0]), -keys[0]);
+    for (int k : keys) ASSERT_TRUE(t.remove(k));
+    EXPECT_TRUE(t.empty());
+    EXPECT_EQ(t.height(), 0);
+    EXPECT_FALSE(t.get(keys[0]).has_value());
+}
+
+TEST(test_symbol_tables, bplus_tree_bulk_load) {
+    // unsorted, with duplicates: the last value given for a key stays
+    std::vector<std::pair<uint64_t, int>> entries;
+    for (int i = 0; i < 20000; ++i) entries.emplace_back(uint64_t{7919} * (i % 5000) + (uint64_t{1} << 63), i);
+    std::shuffle(entries.begin(), entries.begin() + 5000, std::mt19937(3));
+    auto t = BPlusTree<uint64_t, int>::bulkLoad(entries);
+    ASSERT_EQ(t.size(), 5000);
+    for (int i = 0; i < 5000; ++i) {
+        const uint64_t k = uint64_t{7919} * i + (uint64_t{1} << 63);
+        ASSERT_EQ(t.select(i), k);
+        ASSERT_EQ(t.rank(k), i);
+        ASSERT_EQ(t.get(k), 15000 + i);
+        ASSERT_EQ(t.floor(k + 1), k);
+        ASSERT_EQ(t.ceiling(k - 1), k);
+    }
+    // unsigned keys either side of the sign bit
+    EXPECT_EQ(t.rank(0), 0);
+    EXPECT_EQ(t.rank(~uint64_t{0}), 5000);
+    // a bulk-loaded tree takes updates like any other
+    for (int i = 0; i < 5000; i += 2) t.remove(t.select(i / 2));
+    t.put(1, 1);
+    EXPECT_EQ(t.size(), 2501);
+    EXPECT_EQ(t.min(), 1);
+
+    auto moved = std::move(t);
+    EXPECT_EQ(moved.size(), 2501);
+    EXPECT_TRUE((BPlusTree<uint64_t, int>::bulkLoad({}).empty()));
+
+    // keys without a SIMD search
+    auto words = BPlusTree<std::string, int>::bulkLoad({{"pear", 1}, {"apple", 2}, {"fig", 3}});
+    EXPECT_EQ(words.floor("grape"), "fig");
+    EXPECT_EQ(words.ceiling("b"), "fig");
+    EXPECT_EQ(words.select(2), "pear");
+}
+
+TEST(test_symbol_tables, red_black_bst) {
+    RedBlackBST<int, int> t;
+    EXPECT_TRUE(t.empty());
+    EXPECT_THROW((void)t.max(), std::out_of_range);
+    EXPECT_THROW((void)t.select(0), std::out_of_range);
+    EXPECT_FALSE(t.ceiling(0).has_value());
+    EXPECT_FALSE(t.remove(0));
+
+    std::mt19937 gen(4);
+    std::uniform_int_distribution<int> key(-2000, 2000), op(0, 9);
+    std::map<int, int> expected;
+    for (int i = 0; i < 40000; ++i) {
+        const int k = key(gen);
+        if (op(gen) < 4) {
+            ASSERT_EQ(t.remove(k), expected.erase(k) == 1);
+        } else {
+            t.put(k, i);
+            expected[k] = i;
+        }
+        ASSERT_EQ(t.size(), expected.size());
+    }
+    // a 2-3 tree of n keys is at most lg n deep, its red-black form twice that
+    EXPECT_LE(t.height(), 2 * std::log2(t.size() + 1));
+    EXPECT_EQ(t.min(), expected.begin()->first);
+    EXPECT_EQ(t.max(), expected.rbegin()->first);
+    const std::vector<int> keys = t.keys();
+    ASSERT_EQ(keys.size(), expected.size());
+    size_t r = 0;
+    for (const auto& [k, v] : expected) {
+        ASSERT_EQ(keys[r], k);
+        ASSERT_EQ(t.select(r), k);
+        ASSERT_EQ(t.get(k), v);
+        ++r;
+    }
+    for (int k = -2100; k <= 2100; ++k) {
+        const auto ge = expected.lower_bound(k);
+        const auto gt = expected.upper_bound(k);
+        ASSERT_EQ(t.rank(k), static_cast<size_t>(std::distance(expected.begin(), ge)));
+        ASSERT_EQ(t.ceiling(k), ge == expected.end() ? std::nullopt : std::optional(ge->first));
+        ASSERT_EQ(t.floor(k), gt == expected.begin() ? std::nullopt : std::optional(std::prev(gt)->first));
+    }
+    for (int lo = -2100; lo <= 2100; lo += 89) {
+        const std::vector<int> range = t.keys(lo, lo + 150);
+        EXPECT_EQ(t.size(lo, lo + 150), range.size());
+        EXPECT_TRUE(std::equal(range.begin(), range.end(), expected.lower_bound(lo),
+                               [](int k, const auto& e) { return k == e.first; }));
+    }
+    EXPECT_TRUE(t.keys(5, 4).empty());
+
+    for (int k : keys) ASSERT_TRUE(t.remove(k));
+    EXPECT_TRUE(t.empty());
+    for (int k = 0; k < 1000; ++k) t.put(k, k);
+    EXPECT_EQ(t.rank(500), 500);
+    t.clear();
+    EXPECT_TRUE(t.empty());
+    EXPECT_FALSE(t.contains(1));
+
+    RedBlackBST<std::string, int> words;
+    for (const char* w : {"pear", "apple", "fig", "kiwi"}) words.put(w, 1);
+    EXPECT_EQ(words.select(1), "fig");
+    EXPECT_EQ(words.floor("grape"), "fig");
+}
+
+TEST(test_symbol_tables, flat_hash_map) {
+    FlatHashMap<int, int> m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.find(1), m.end());
+    EXPECT_THROW((void)m.at(1), std::out_of_range);
+    EXPECT_TRUE(m.try_emplace(1, 10).second);
+    EXPECT_FALSE(m.try_emplace(1, 20).second);
+    EXPECT_EQ(m.at(1), 10);
+    m.insert_or_assign(1, 30);
+    m[2] += 5;
+    EXPECT_EQ(m[1], 30);
+    EXPECT_EQ(m[2], 5);
+    EXPECT_EQ(m.erase(1), 1);
+    EXPECT_EQ(m.erase(1), 0);
+    EXPECT_FALSE(m.contains(1));
+
+    // random inserts and erases against std::unordered_map; small keys so erases hit
+    // and groups fill up, leaving tombstones
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> key(0, 5000), op(0, 9);
+    std::unordered_map<int, int> expected{{2, 5}};
+    for (int i = 0; i < 200000; ++i) {
+        const int k = key(gen);
+        if (op(gen) < 4) {
+            ASSERT_EQ(m.erase(k), expected.erase(k));
+        } else {
+            m[k] = i;
+            expected[k] = i;
+        }
+    }
+    ASSERT_EQ(m.size(), expected.size());
+    size_t seen = 0;
+    for (const auto& [k, v] : m) {
+        ASSERT_EQ(expected.at(k), v);
+        ++seen;
+    }
+    EXPECT_EQ(seen, m.size());
+    EXPECT_LE(m.load_factor(), 7.0 / 8);
+
+    // erase while iterating
+    for (auto it = m.begin(); it != m.end();)
+        it = it->first % 2 ? m.erase(it) : std::next(it);
+    for (const auto& [k, v] : m) EXPECT_EQ(k % 2, 0);
+
+    FlatHashMap<int, int> copy = m;
+    FlatHashMap<int, int> moved = std::move(m);
+    EXPECT_EQ(copy.size(), moved.size());
+    for (const auto& [k, v] : moved) EXPECT_EQ(copy.at(k), v);
+    copy.clear();
+    EXPECT_TRUE(copy.empty());
+    EXPECT_EQ(copy.find(0), copy.end());
+    FlatHashMap<int, int> reserved(1000);
+    const size_t capacity = reserved.capacity();
+    for (int i = 0; i < 1000; ++i) reserved[i] = i;
+    EXPECT_EQ(reserved.capacity(), capacity);
+}
+
+TEST(test_symbol_tables, flat_hash_map_keys) {
+    // transparent lookup: no std::string is built to search a string-keyed map
+    FlatHashMap<std::string, int> words;
+    for (std::string_view w : {"alpha", "beta", "gamma", "delta"})
+        words.try_emplace(w, static_cast<int>(w.size()));
+    EXPECT_EQ(words.at(std::string_view("gamma")), 5);
+    EXPECT_TRUE(words.contains("beta"));
+    EXPECT_EQ(words.find(std::string("delta"))->second, 5);
+    EXPECT_EQ(words.count("epsilon"), 0);
+    EXPECT_EQ(words.erase("alpha"), 1);
+    EXPECT_EQ(words.size(), 3);
+
+    // a pluggable, deliberately awful hash: every key collides, still correct
+    struct Constant {
+        size_t operator()(int) const noexcept { return 42; }
+    };
+    FlatHashMap<int, int, Constant, std::equal_to<int>> same;
+    for (int i = 0; i < 300; ++i) same[i] = -i;
+    for (int i = 0; i < 300; i += 3) same.erase(i);
+    EXPECT_EQ(same.size(), 200);
+    for (int i = 0; i < 300; ++i) EXPECT_EQ(same.contains(i), i % 3 != 0);
+}
+
+TEST(test_symbol_tables, concurrent_hash_map) {
+    ConcurrentHashMap<int, int> m(0, 4);
+    EXPECT_TRUE(m.empty());
+    EXPECT_FALSE(m.get(1).has_value());
+    EXPECT_TRUE(m.insert(1, 10));
+    EXPECT_FALSE(m.insert(1, 20));
+    EXPECT_EQ(m.get(1), 10);
+    EXPECT_FALSE(m.insert_or_assign(1, 30));
+    EXPECT_TRUE(m.insert_or_assign(2, 40));
+    int seen = 0;
+    EXPECT_TRUE(m.visit(2, [&](const int& v) { seen = v; }));
+    EXPECT_EQ(seen, 40);
+    EXPECT_TRUE(m.erase(1));
+    EXPECT_FALSE(m.erase(1));
+    EXPECT_FALSE(m.contains(1));
+    EXPECT_EQ(m.size(), 1);
+    m.clear();
+    EXPECT_TRUE(m.empty());
+
+    // Writers own disjoint key ranges and store key * 1000 + version, so any value a
+    // reader finds must belong to its key; the table starts small and grows meanwhile.
+    constexpr int writers = 3, readers = 3, keys = 4000, rounds = 5;
+    const size_t buckets = m.bucket_count();
+    std::atomic<bool> done{false};
+    std::atomic<int> bad{0};
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w)
+        threads.emplace_back([&, w] {
+            for (int r = 0; r < rounds; ++r)
+                for (int k = w * keys; k < (w + 1) * keys; ++k) {
+                    if (r % 2 == 1 && k % 3 == 0) m.erase(k);
+                    else m.insert_or_assign(k, k * 1000 + r);
+                }
+        });
+    for (int i = 0; i < readers; ++i)
+        threads.emplace_back([&, i] {
+            std::mt19937 gen(i);
+            std::uniform_int_distribution<int> key(0, writers * keys - 1);
+            while (!done.load()) {
+                const int k = key(gen);
+                if (auto v = m.get(k); v && *v / 1000 != k) ++bad;
+                m.visit(k, [&](const int& v) { if (v / 1000 != k) ++bad; });
+            }
+            m.for_each([&](const int& k, const int& v) { if (v / 1000 != k) ++bad; });
+        });
+    for (int w = 0; w < writers; ++w) threads[w].join();
+    done = true;
+    for (size_t i = writers; i < threads.size(); ++i) threads[i].join();
+    EXPECT_EQ(bad.load(), 0);
+    EXPECT_GT(m.bucket_count(), buckets);
+    // the last round was even: every key there, with the last version
+    EXPECT_EQ(m.size(), writers * keys);
+    for (int k = 0; k < writers * keys; ++k) ASSERT_EQ(m.get(k), k * 1000 + rounds - 1);
+
+    ConcurrentHashMap<std::string, std::string> words;
+    words.insert("alpha", "a");
+    EXPECT_EQ(words.get(std::string_view("alpha")), "a");
+    EXPECT_TRUE(words.erase("alpha"));
+}
+
+// Random keys over a small alphabet, so that they share prefixes, with a byte above 0x7f
+// for the unsigned order; every query is checked against a scan of a std::map.
+template<typename Trie>
+static void checkTrie(Trie& t) {
+    EXPECT_TRUE(t.empty());
+    EXPECT_FALSE(t.get("a").has_value());
+    EXPECT_FALSE(t.longestPrefixOf("abc").has_value());
+    EXPECT_FALSE(t.remove("a"));
+    EXPECT_TRUE(t.keys().empty());
+
+    std::mt19937 gen(5);
+    const std::string alphabet = "abc/\xe9";
+    std::uniform_int_distribution<size_t> letter(0, alphabet.size() - 1), length(0, 7);
+    std::uniform_int_distribution<int> op(0, 9);
+    auto randomKey = [&] {
+        std::string s(length(gen), ' ');
+        for (char& c : s) c = alphabet[letter(gen)];
+        return s;
+    };
+    std::map<std::string, int> expected;
+    for (int i = 0; i < 20000; ++i) {
+        const std::string k = randomKey();
+        if (op(gen) < 4) {
+            ASSERT_EQ(t.remove(k), expected.erase(k) == 1) << k;
+        } else {
+            t.put(k, i);
+            expected[k] = i;
+        }
+        ASSERT_EQ(t.size(), expected.size());
+    }
+    std::vector<std::string> all;
+    for (const auto& [k, v] : expected) {
+        ASSERT_EQ(t.get(k), v);
+        all.push_back(k);
+    }
+    EXPECT_EQ(t.keys(), all);
+    for (int i = 0; i < 300; ++i) {
+        const std::string q = randomKey();
+        std::vector<std::string> prefixed, matching;
+        std::optional<std::string> longest;
+        for (const auto& k : all) {
+            if (k.starts_with(q)) prefixed.push_back(k);
+            if (q.starts_with(k)) longest = k;
+            std::string pattern = q;
+            if (!pattern.empty()) pattern[i % pattern.size()] = '.';
+            if (k.size() == pattern.size()
+                && std::equal(k.begin(), k.end(), pattern.begin(), [](char a, char p) { return p == '.' || a == p; }))
+                matching.push_back(k);
+        }
+        EXPECT_EQ(t.contains(q), expected.count(q) == 1);
+        ASSERT_EQ(t.keysWithPrefix(q), prefixed) << q;
+        ASSERT_EQ(t.longestPrefixOf(q), longest) << q;
+        std::string pattern = q;
+        if (!pattern.empty()) pattern[i % pattern.size()] = '.';
+        ASSERT_EQ(t.keysThatMatch(pattern), matching) << pattern;
+    }
+    for (const auto& k : all) ASSERT_TRUE(t.remove(k));
+    EXPECT_TRUE(t.empty());
+    EXPECT_TRUE(t.keys().empty());
+
+    // the freed nodes serve the next keys
+    const size_t memory = t.memory();
+    for (const auto& k : all) t.put(k, 1);
+    EXPECT_EQ(t.size(), all.size());
+    EXPECT_LE(t.memory(), 2 * memory);
+
+    t.put("http://example.com/", 1);
+    t.put("http://example.com/index.html", 2);
+    t.put("http://example.org/", 3);
+    EXPECT_EQ(t.longestPrefixOf("http://example.com/about"), "http://example.com/");
+    EXPECT_EQ(t.keysWithPrefix("http://example.").size(), 3);
+    EXPECT_EQ(t.keysThatMatch("http://example.o../"), std::vector<std::string>{"http://example.org/"});
+}
+
+TEST(test_symbol_tables, tst) {
+    TST<int> t;
+    checkTrie(t);
+}
+
+TEST(test_symbol_tables, radix_tree) {
+    RadixTree<int> t;
+    checkTrie(t);
+
+    // a wide node goes through every block size and back
+    RadixTree<int> wide;
+    for (int b = 0; b < 256; ++b) wide.put(std::string{'x', static_cast<char>(b)}, b);
+    for (int b = 0; b < 256; ++b) ASSERT_EQ(wide.get(std::string{'x', static_cast<char>(b)}), b);
+    EXPECT_EQ(wide.keysWithPrefix("x").size(), 256);
+    for (int b = 255; b >= 0; b -= 2) ASSERT_TRUE(wide.remove(std::string{'x', static_cast<char>(b)}));
+    EXPECT_EQ(wide.keysThatMatch("x.").size(), 128);
+    EXPECT_EQ(wide.get(std::string{'x', 'b'}), 'b');
+    EXPECT_FALSE(wide.contains(std::string{'x', 'a'}));
+
+    // churn over a small live set: the pool is rewritten instead of growing with every key
+    RadixTree<int> churn;
+    auto name = [](int i) { return "churn/" + std::to_string(i * 7919) + "/with/a/longer/tail"; };
+    for (int i = 0; i < 100000; ++i) {
+        churn.put(name(i), i);
+        if (i >= 10) ASSERT_TRUE(churn.remove(name(i - 10)));
+    }
+    EXPECT_EQ(churn.size(), 10);
+    for (int i = 100000 - 10; i < 100000; ++i) ASSERT_EQ(churn.get(name(i)), i);
+    EXPECT_EQ(churn.keysWithPrefix("churn/").size(), 10);
+    EXPECT_LT(churn.memory(), 64 * 1024);
+}
+
+TEST(test_symbol_tables, static_table) {
+    std::vector<std::pair<uint64_t, int>> entries;
+    std::mt19937_64 gen(6);
+    std::unordered_map<uint64_t, int> expected;
+    while (entries.size() < 200000) {
+        const uint64_t k = gen();
+        if (expected.emplace(k, static_cast<int>(entries.size())).second)
+            entries.emplace_back(k, static_cast<int>(entries.size()));
+    }
+    // the slots are a permutation whatever the thread count, and so is the table
+    const auto table = StaticTable<uint64_t, int>::build(entries, 4);
+    const auto single = StaticTable<uint64_t, int>::build(entries, 1);
+    ASSERT_EQ(table.size(), entries.size());
+    ASSERT_EQ(table.bytes(), single.bytes());
+    std::vector<bool> taken(entries.size());
+    for (const auto& [k, v] : entries) {
+        const size_t s = table.slot(k);
+        ASSERT_LT(s, entries.size());
+        ASSERT_FALSE(taken[s]);
+        taken[s] = true;
+        ASSERT_EQ(table.key(s), k);
+        ASSERT_EQ(table.get(k), v);
+        ASSERT_EQ(single.slot(k), s);
+    }
+    EXPECT_LT(static_cast<double>(table.hashBits()) / static_cast<double>(entries.size()), 4.0);
+    for (int i = 0; i < 10000; ++i) {
+        const uint64_t k = gen();
+        ASSERT_EQ(table.contains(k), expected.count(k) == 1);
+    }
+
+    // the file is the table: a loaded one answers the same
+    const std::string path = (std::filesystem::temp_directory_path() / "algo_test_static_table.mph").string();
+    table.write(path);
+    {
+        const auto mapped = StaticTable<uint64_t, int>::load(path);
+        ASSERT_EQ(mapped.size(), table.size());
+        for (const auto& [k, v] : entries) ASSERT_EQ(mapped.get(k), v);
+        EXPECT_FALSE(mapped.contains(entries[0].first + 1));
+        EXPECT_THROW((void)(StaticTable<uint64_t, double>::load(path)), std::invalid_argument);
+        EXPECT_THROW((void)(StaticTable<std::string, int>::load(path)), std::invalid_argument);
+    }
+    std::filesystem::resize_file(path, table.bytes() - 8);
+    EXPECT_THROW((void)(StaticTable<uint64_t, int>::load(path)), std::invalid_argument);
+    std::filesystem::remove(path);
+
+    std::vector<std::pair<std::string, double>> words;
+    for (int i = 0; i < 5000; ++i) words.emplace_back("key/" + std::to_string(i * 7919), i);
+    words.emplace_back("", -1);
+    auto dictionary = StaticTable<std::string, double>::build(words);
+    for (const auto& [k, v] : words) ASSERT_EQ(dictionary.get(k), v);
+    EXPECT_FALSE(dictionary.contains("key/1"));
+    EXPECT_FALSE(dictionary.contains("key/79190000"));
+    std::stringstream stream;
+    dictionary.write(stream);
+    EXPECT_EQ(stream.str().size(), dictionary.bytes());
+    const auto moved = std::move(dictionary);
+    EXPECT_EQ(moved.get("key/7919"), 1);
+    EXPECT_TRUE(dictionary.empty());
+    EXPECT_FALSE(dictionary.contains("key/7919"));
+
+    EXPECT_TRUE((StaticTable<int, int>::build({}).empty()));
+    EXPECT_FALSE((StaticTable<int, int>::build({}).contains(0)));
+    EXPECT_THROW((void)(StaticTable<int, int>::build({{1, 1}, {2, 2}, {1, 3}})), std::invalid_argument);
+}
+
+TEST(test_symbol_tables, filters) {
+    std::mt19937_64 gen(7);
+    std::vector<uint64_t> keys(100000), absent(100000);
+    for (auto& k : keys) k = gen();
+    for (auto& k : absent) k = gen();
+
+    BlockedBloomFilter bloom(keys.size(), 12);
+    EXPECT_FALSE(bloom.contains(keys[0]));
+    for (uint64_t k : keys) bloom.insert(k);
+    auto fuse = BinaryFuseFilter::build(keys);
+    EXPECT_EQ(fuse.size(), keys.size());
+    EXPECT_LT(fuse.bytes(), keys.size() * 5 / 4);
+
+    // no false negatives; false positives near the design rates, 0.5% and 1/256
+    std::vector<uint8_t> out(keys.size());
+    EXPECT_EQ(bloom.containsMany(keys, out), keys.size());
+    EXPECT_EQ(fuse.containsMany(keys, out), keys.size());
+    for (uint64_t k : keys) ASSERT_TRUE(bloom.contains(k) && fuse.contains(k));
+    size_t bloomPositives = 0, fusePositives = 0;
+    for (uint64_t k : absent) {
+        bloomPositives += bloom.contains(k);
+        fusePositives += fuse.contains(k);
+    }
+    EXPECT_LT(bloomPositives, absent.size() / 100);
+    EXPECT_LT(fusePositives, absent.size() / 150);
+    EXPECT_EQ(bloom.containsMany(absent, out), bloomPositives);
+    for (size_t i = 0; i < absent.size(); ++i) ASSERT_EQ(out[i], bloom.contains(absent[i]));
+    EXPECT_EQ(fuse.containsMany(absent, out), fusePositives);
+    for (size_t i = 0; i < absent.size(); ++i) ASSERT_EQ(out[i], fuse.contains(absent[i]));
+    EXPECT_THROW((void)(bloom.containsMany(keys, std::span<uint8_t>(out).first(10))), std::invalid_argument);
+
+    // mapped filters answer as the built ones
+    const auto dir = std::filesystem::temp_directory_path();
+    const std::string bloomPath = (dir / "algo_test_filter.blm").string(), fusePath = (dir / "algo_test_filter.bff").string();
+    bloom.write(bloomPath);
+    fuse.write(fusePath);
+    {
+        const auto mappedBloom = BlockedBloomFilter::load(bloomPath);
+        auto mappedFuse = BinaryFuseFilter::load(fusePath);
+        EXPECT_EQ(mappedBloom.bytes(), bloom.bytes());
+        for (size_t i = 0; i < absent.size(); i += 7) {
+            ASSERT_EQ(mappedBloom.contains(absent[i]), bloom.contains(absent[i]));
+            ASSERT_EQ(mappedFuse.contains(absent[i]), fuse.contains(absent[i]));
+        }
+        EXPECT_EQ(mappedFuse.containsMany(keys, out), keys.size());
+        BlockedBloomFilter readOnly = BlockedBloomFilter::load(bloomPath);
+        EXPECT_THROW(readOnly.insert(1), std::logic_error);
+        EXPECT_THROW((void)(BinaryFuseFilter::load(bloomPath)), std::invalid_argument);
+        EXPECT_THROW((void)(BlockedBloomFilter::load(fusePath)), std::invalid_argument);
+    }
+    std::filesystem::remove(bloomPath);
+    std::filesystem::remove(fusePath);
+
+    // strings, repeats, tiny and empty sets
+    const std::vector<std::string> words{"alpha", "beta", "gamma", "beta", ""};
+    const auto small = BinaryFuseFilter::build(words);
+    EXPECT_EQ(small.size(), 4);
+    for (const auto& w : words) EXPECT_TRUE(small.contains(w));
+    EXPECT_TRUE(small.contains(std::string_view("gamma")));
+    const auto one = BinaryFuseFilter::build(std::vector<int>{42});
+    EXPECT_TRUE(one.contains(42));
+    const auto none = BinaryFuseFilter::build(std::vector<int>{});
+    EXPECT_FALSE(none.contains(42));
+    BlockedBloomFilter tiny(0);
+    EXPECT_EQ(tiny.blocks(), 1);
+    tiny.insert(std::string("x"));
+    EXPECT_TRUE(tiny.contains(std::string_view("x")));
+    EXPECT_THROW(BlockedBloomFilter(10, 0), std::invalid_argument);
+}
@@ -0,0 +1,322 @@
+#ifndef ALGO_TST_H
+#define ALGO_TST_H
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+namespace symbol_tables {
+    /** Ternary search trie (Bentley, Sedgewick) ********************************************
+     * One node per character: a BST on the character at each depth (left, right) whose
+     * middle link leads to the next depth. It takes no space per alphabet letter, unlike
+     * an R-way trie, and a miss usually gives up after a few characters. Every character
+     * of a distinct prefix is a node, so long unshared suffixes cost a node per byte;
+     * RadixTree stores those once in its string pool instead.
+     *
+     * Nodes sit in one arena and link by 32-bit index, index 0 being null; values sit in
+     * a second array the nodes point into, so that the nodes stay 20 bytes whatever the
+     * Value. Keys are byte strings compared as unsigned bytes, so keys() come out in the
+     * order of std::string's operator<. In keysThatMatch() patterns '.' matches any byte.
+     *
+     * remove() frees the nodes that led only to the removed key; a node that is still a
+     * branch point between its left and right siblings stays as a pass-through.
+     */
+    template<typename Value>
+    class TST {
+    private:
+        static constexpr uint32_t nil = 0;
+        static constexpr uint32_t none = UINT32_MAX;
+
+        struct Node {
+            uint32_t left = nil, mid = nil, right = nil;
+            uint32_t value = none;      // index into values_
+            uint8_t c = 0;
+        };
+
+        std::vector<Node> nodes_ = std::vector<Node>(1);
+        std::vector<Value> values_;
+        std::vector<uint32_t> freeValues_;
+        uint32_t root_ = nil;
+        uint32_t free_ = nil;           // freed nodes, chained through mid
+        uint32_t empty_ = none;         // the value of the empty key
+        size_t size_ = 0;
+
+    public:
+        TST() = default;
+
+        [[nodiscard]]
+        size_t size() const noexcept { return size_; }
+        [[nodiscard]]
+        bool empty() const noexcept { return size_ == 0; }
+        // bytes held by the arrays, capacity included
+        [[nodiscard]]
+        size_t memory() const noexcept {
+            return nodes_.capacity() * sizeof(Node) + values_.capacity() * sizeof(Value)
+                   + freeValues_.capacity() * sizeof(uint32_t);
+        }
+
+        // inserts or replaces
+        void put(std::string_view key, Value value);
+        [[nodiscard]]
+        std::optional<Value> get(std::string_view key) const;
+        [[nodiscard]]
+        bool contains(std::string_view key) const { return valueOf(key) != none; }
+        // false if the key was not there
+        bool remove(std::string_view key);
+
+        [[nodiscard]]
+        std::vector<std::string> keys() const { return keysWithPrefix({}); }
+        [[nodiscard]]
+        std::vector<std::string> keysWithPrefix(std::string_view prefix) const;
+        // the keys as long as pattern that match it, '.' matching any byte
+        [[nodiscard]]
+        std::vector<std::string> keysThatMatch(std::string_view pattern) const;
+        // the longest key that is a prefix of query, if any
+        [[nodiscard]]
+        std::optional<std::string> longestPrefixOf(std::string_view query) const;
+
+    private:
+        Node& at(uint32_t x) noexcept { return nodes_[x]; }
+        const Node& at(uint32_t x) const noexcept { return nodes_[x]; }
+        static uint8_t byte(std::string_view s, size_t d) noexcept { return static_cast<uint8_t>(s[d]); }
+        uint32_t allocate(uint8_t c);
+        uint32_t store(Value& value);
+        uint32_t find(std::string_view key) const;
+        uint32_t valueOf(std::string_view key) const;
+        void collect(uint32_t x, std::string& prefix, std::vector<std::string>& out) const;
+        void collect(uint32_t x, std::string& prefix, std::string_view pattern, std::vector<std::string>& out) const;
+    };
+
+    template<typename Value>
+    uint32_t TST<Value>::allocate(uint8_t c) {
+        uint32_t x = free_;
+        if (x != nil) {
+            free_ = at(x).mid;
+            at(x) = Node{};
+        } else {
+            if (nodes_.size() >= none) throw std::length_error("Trie is full");
+            x = static_cast<uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+        }
+        at(x).c = c;
+        return x;
+    }
+
+    template<typename Value>
+    uint32_t TST<Value>::store(Value& value) {
+        if (!freeValues_.empty()) {
+            const uint32_t v = freeValues_.back();
+            freeValues_.pop_back();
+            values_[v] = std::move(value);
+            return v;
+        }
+        values_.push_back(std::move(value));
+        return static_cast<uint32_t>(values_.size() - 1);
+    }
+
+    // the node the last byte of key ends on, nil if there is none
+    template<typename Value>
+    uint32_t TST<Value>::find(std::string_view key) const {
+        uint32_t x = root_;
+        for (size_t d = 0; x != nil;) {
+            const uint8_t c = byte(key, d);
+            if (c < at(x).c) x = at(x).left;
+            else if (c > at(x).c) x = at(x).right;
+            else if (++d < key.size()) x = at(x).mid;
+            else return x;
+        }
+        return nil;
+    }
+
+    template<typename Value>
+    uint32_t TST<Value>::valueOf(std::string_view key) const {
+        if (key.empty()) return empty_;
+        const uint32_t x = find(key);
+        return x == nil ? none : at(x).value;
+    }
+
+    template<typename Value>
+    std::optional<Value> TST<Value>::get(std::string_view key) const {
+        const uint32_t v = valueOf(key);
+        if (v == none) return std::nullopt;
+        return values_[v];
+    }
+
+    // iterative, with indices: allocate() may move the arena
+    template<typename Value>
+    void TST<Value>::put(std::string_view key, Value value) {
+        if (key.empty()) {
+            if (empty_ != none) {
+                values_[empty_] = std::move(value);
+            } else {
+                empty_ = store(value);
+                ++size_;
+            }
+            return;
+        }
+        if (root_ == nil) root_ = allocate(byte(key, 0));
+        uint32_t x = root_;
+        for (size_t d = 0;;) {
+            const uint8_t c = byte(key, d);
+            if (c < at(x).c) {
+                if (at(x).left == nil) {
+                    const uint32_t y = allocate(c);
+                    at(x).left = y;
+                }
+                x = at(x).left;
+            } else if (c > at(x).c) {
+                if (at(x).right == nil) {
+                    const uint32_t y = allocate(c);
+                    at(x).right = y;
+                }
+                x = at(x).right;
+            } else if (++d < key.size()) {
+                if (at(x).mid == nil) {
+                    const uint32_t y = allocate(byte(key, d));
+                    at(x).mid = y;
+                }
+                x = at(x).mid;
+            } else {
+                break;
+            }
+        }
+        if (at(x).value != none) {
+            values_[at(x).value] = std::move(value);
+        } else {
+            at(x).value = store(value);
+            ++size_;
+        }
+    }
+
+    // Walks back up the search path: a node with no value and no middle child leads
+    // nowhere, and if it has at most one sibling subtree that subtree takes its place.
+    template<typename Value>
+    bool TST<Value>::remove(std::string_view key) {
+        if (key.empty()) {
+            if (empty_ == none) return false;
+            freeValues_.push_back(empty_);
+            empty_ = none;
+            --size_;
+            return true;
+        }
+        std::vector<uint32_t> path;
+        uint32_t x = root_;
+        for (size_t d = 0; x != nil;) {
+            path.push_back(x);
+            const uint8_t c = byte(key, d);
+            if (c < at(x).c) x = at(x).left;
+            else if (c > at(x).c) x = at(x).right;
+            else if (++d < key.size()) x = at(x).mid;
+            else break;
+        }
+        if (x == nil || at(x).value == none) return false;
+        freeValues_.push_back(at(x).value);
+        at(x).value = none;
+        --size_;
+
+        for (size_t k = path.size(); k-- > 0;) {
+            const uint32_t y = path[k];
+            const Node& n = at(y);
+            if (n.value != none || n.mid != nil || (n.left != nil && n.right != nil)) break;
+            const uint32_t replacement = n.left != nil ? n.left : n.right;
+            if (k == 0) {
+                root_ = replacement;
+            } else {
+                Node& parent = at(path[k - 1]);
+                (parent.left == y ? parent.left : parent.mid == y ? parent.mid : parent.right) = replacement;
+            }
+            at(y).mid = free_;
+            free_ = y;
+            if (replacement != nil) break;
+        }
+        return true;
+    }
+
+    template<typename Value>
+    std::vector<std::string> TST<Value>::keysWithPrefix(std::string_view prefix) const {
+        std::vector<std::string> out;
+        std::string buffer(prefix);
+        if (prefix.empty()) {
+            if (empty_ != none) out.emplace_back();
+            collect(root_, buffer, out);
+            return out;
+        }
+        const uint32_t x = find(prefix);
+        if (x == nil) return out;
+        if (at(x).value != none) out.push_back(buffer);
+        collect(at(x).mid, buffer, out);
+        return out;
+    }
+
+    // in order: smaller bytes, this byte and what follows it, larger bytes
+    template<typename Value>
+    void TST<Value>::collect(uint32_t x, std::string& prefix, std::vector<std::string>& out) const {
+        if (x == nil) return;
+        const Node& n = at(x);
+        collect(n.left, prefix, out);
+        prefix.push_back(static_cast<char>(n.c));
+        if (n.value != none) out.push_back(prefix);
+        collect(n.mid, prefix, out);
+        prefix.pop_back();
+        collect(n.right, prefix, out);
+    }
+
+    template<typename Value>
+    std::vector<std::string> TST<Value>::keysThatMatch(std::string_view pattern) const {
+        std::vector<std::string> out;
+        std::string buffer;
+        if (pattern.empty()) {
+            if (empty_ != none) out.emplace_back();
+            return out;
+        }
+        collect(root_, buffer, pattern, out);
+        return out;
+    }
+
+    template<typename Value>
+    void TST<Value>::collect(uint32_t x, std::string& prefix, std::string_view pattern,
+                             std::vector<std::string>& out) const {
+        if (x == nil) return;
+        const Node& n = at(x);
+        const size_t d = prefix.size();
+        const bool any = pattern[d] == '.';
+        const uint8_t c = byte(pattern, d);
+        if (any || c < n.c) collect(n.left, prefix, pattern, out);
+        if (any || c == n.c) {
+            prefix.push_back(static_cast<char>(n.c));
+            if (d + 1 == pattern.size()) {
+                if (n.value != none) out.push_back(prefix);
+            } else {
+                collect(n.mid, prefix, pattern, out);
+            }
+            prefix.pop_back();
+        }
+        if (any || c > n.c) collect(n.right, prefix, pattern, out);
+    }
+
+    template<typename Value>
+    std::optional<std::string> TST<Value>::longestPrefixOf(std::string_view query) const {
+        std::optional<size_t> length;
+        if (empty_ != none) length = 0;
+        uint32_t x = root_;
+        for (size_t d = 0; x != nil && d < query.size();) {
+            const uint8_t c = byte(query, d);
+            if (c < at(x).c) {
+                x = at(x).left;
+            } else if (c > at(x).c) {
+                x = at(x).right;
+            } else {
+                if (at(x).value != none) length = d + 1;
+                x = at(x).mid;
+                ++d;
+            }
+        }
+        if (!length) return std::nullopt;
+        return std::string(query.substr(0, *length));
+    }
+}
+
+#endif //ALGO_TST_H
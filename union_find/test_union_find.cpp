@@ -3,6 +3,7 @@
 //
 #include <sstream>
 #include <string_view>
+#include <thread>
 #include <gtest/gtest.h>
 #include "union_find.h"
 
@@ -37,3 +38,44 @@ TEST(test_union_find, weighted_quick_union) {
     WeightedQuickUnion wqu(ss);
     EXPECT_EQ(wqu.connected(3, 9), true);
 }
+
+TEST(test_union_find, concurrent_union_find) {
+    ConcurrentUnionFind uf(10);
+    std::stringstream ss(test_str.data());
+    size_t n;
+    ss >> n;
+    for (int p, q; ss >> p >> q;)
+        uf.Union(p, q);
+    EXPECT_TRUE(uf.connected(3, 9));
+    EXPECT_EQ(uf.components(), 2);
+
+    constexpr int size = 100000;
+    ConcurrentUnionFind big(size);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < 4; ++t)
+        pool.emplace_back([&big, t] {
+            for (int i = t; i + 1 < size; i += 4)
+                big.Union(i, i + 1);
+        });
+    for (auto& th : pool) th.join();
+    big.compress();
+    EXPECT_EQ(big.components(), 1);
+    EXPECT_EQ(big.parent(size - 1), 0);
+}
+
+TEST(test_union_find, parity_union_find) {
+    ParityUnionFind uf(6);
+    EXPECT_TRUE(uf.Union(0, 1));
+    EXPECT_TRUE(uf.Union(1, 2));
+    EXPECT_TRUE(uf.Union(3, 4, false));
+    EXPECT_EQ(uf.components(), 3);
+    EXPECT_TRUE(uf.parity(0) == uf.parity(2));
+    EXPECT_TRUE(uf.parity(0) != uf.parity(1));
+    EXPECT_TRUE(uf.Union(0, 2, false));     // consistent, nothing to merge
+    EXPECT_FALSE(uf.Union(2, 0));           // odd cycle 0-1-2-0
+    EXPECT_TRUE(uf.Union(2, 3));
+    EXPECT_TRUE(uf.parity(4) != uf.parity(2));
+    EXPECT_FALSE(uf.Union(4, 2, false));
+    EXPECT_FALSE(uf.Union(5, 5));
+    EXPECT_EQ(uf.components(), 2);
+}
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <numeric>
 #include <algorithm>
+#include <atomic>
 
 struct QuickFind {
 private:
@@ -98,16 +99,16 @@ private:
     size_t                  N   {0};
 public:
     explicit WeightedQuickUnion(int capacity)
-        : N(capacity)
-        , sz(std::make_unique<int[]>(N))
-        , id(std::make_unique<int[]>(N))
+        : id(std::make_unique<int[]>(capacity))
+        , sz(std::make_unique<int[]>(capacity))
+        , N(capacity)
     {
         std::iota(id.get(), id.get() + N, 0);
         std::fill(sz.get(), sz.get() + N, 1);
     }
     explicit WeightedQuickUnion(std::istream& is) {
         int i = 0, j = 0, p = 0, q = 0;
-        std::cin >> N;
+        is >> N;
         const auto initial_size = N;
         id = std::make_unique<int[]>(N);
         sz = std::make_unique<int[]>(N);
@@ -128,6 +129,8 @@ public:
     size_t components() const noexcept {
         return N;
     }
+    // read-only, so concurrent finds and connected() on a const object are safe; weighting
+    // alone keeps the trees O(log N) deep
     [[nodiscard]]
     int find(int p) const {
         while (p != id[p])
@@ -135,8 +138,8 @@ public:
         return p;
     }
     void Union(int p, int q) {
-        int i = find(p);
-        int j = find(q);
+        int i = halve(p);
+        int j = halve(q);
         if (i == j)
             return;
         if (sz[i] < sz[j]) {
@@ -148,5 +151,149 @@ public:
         }
         N--;
     }
+private:
+    // find with path halving: the sets stay the same, only the trees get flatter
+    int halve(int p) {
+        while (p != id[p])
+            p = id[p] = id[id[p]];
+        return p;
+    }
+};
+
+/** Weighted quick-union that also tracks parity: every element knows whether it sits
+ * an odd or even number of "differs" relations away from its root. Union(p, q, odd)
+ * records that p and q differ (or agree) and reports a contradiction with what is
+ * already known instead of merging - which is exactly an odd cycle when the relation is
+ * "on the other side of an edge", i.e. a bipartiteness check.
+ */
+struct ParityUnionFind {
+private:
+    std::unique_ptr<int[]>  id  {nullptr};
+    std::unique_ptr<int[]>  sz  {nullptr};
+    std::unique_ptr<bool[]> odd {nullptr};  // parity relative to the parent, false for roots
+    size_t                  N   {0};
+public:
+    explicit ParityUnionFind(int capacity)
+        : id(std::make_unique<int[]>(capacity))
+        , sz(std::make_unique<int[]>(capacity))
+        , odd(std::make_unique<bool[]>(capacity))
+        , N(capacity)
+    {
+        std::iota(id.get(), id.get() + N, 0);
+        std::fill(sz.get(), sz.get() + N, 1);
+        std::fill(odd.get(), odd.get() + N, false);
+    }
+    [[nodiscard]]
+    bool connected(int p, int q) {
+        return find(p) == find(q);
+    }
+    [[nodiscard]]
+    size_t components() const noexcept {
+        return N;
+    }
+    [[nodiscard]]
+    int find(int p) {
+        while (p != id[p]) {
+            const int parent = id[p];
+            odd[p] = odd[p] != odd[parent];
+            p = id[p] = id[parent];
+        }
+        return p;
+    }
+    // parity of p relative to the root of its set
+    [[nodiscard]]
+    bool parity(int p) {
+        (void)find(p);
+        bool result = false;
+        for (; p != id[p]; p = id[p])
+            result = result != odd[p];
+        return result;
+    }
+    // false if p and q are already known to relate the other way
+    bool Union(int p, int q, bool differ = true) {
+        const int i = find(p), j = find(q);
+        const bool x = (parity(p) ^ parity(q)) != differ;
+        if (i == j)
+            return !x;
+        if (sz[i] < sz[j]) {
+            id[i] = j;
+            odd[i] = x;
+            sz[j] += sz[i];
+        } else {
+            id[j] = i;
+            odd[j] = x;
+            sz[i] += sz[j];
+        }
+        N--;
+        return true;
+    }
+};
+
+/** Lock-free union-find for concurrent use. Union always hooks the larger root under the
+ * smaller one with a CAS, so parent links only ever point downwards and no cycle can
+ * form however unions interleave; find() halves paths with CAS as well. compress()
+ * points every element straight at its root and must not race with Union().
+ */
+struct ConcurrentUnionFind {
+private:
+    std::unique_ptr<std::atomic<int>[]>  id  {nullptr};
+    size_t                               capacity {0};
+    std::atomic<size_t>                  N   {0};
+public:
+    explicit ConcurrentUnionFind(int capacity)
+        : id(std::make_unique<std::atomic<int>[]>(capacity))
+        , capacity(capacity)
+        , N(capacity)
+    {
+        for (int i = 0; i < capacity; ++i)
+            id[i].store(i, std::memory_order_relaxed);
+    }
+    [[nodiscard]]
+    bool connected(int p, int q) {
+        return find(p) == find(q);
+    }
+    [[nodiscard]]
+    size_t components() const noexcept {
+        return N.load();
+    }
+    [[nodiscard]]
+    int find(int p) {
+        while (true) {
+            int parent = id[p].load(std::memory_order_relaxed);
+            int grand = id[parent].load(std::memory_order_relaxed);
+            if (parent == grand) return parent;
+            id[p].compare_exchange_weak(parent, grand, std::memory_order_relaxed);
+            p = grand;
+        }
+    }
+    // true for the one caller whose union actually merged two sets
+    bool Union(int p, int q) {
+        while (true) {
+            p = find(p);
+            q = find(q);
+            if (p == q) return false;
+            if (p < q) std::swap(p, q);
+            int expected = p;
+            if (id[p].compare_exchange_strong(expected, q, std::memory_order_relaxed)) {
+                N.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    void compress(size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            id[i].store(find(static_cast<int>(i)), std::memory_order_relaxed);
+    }
+    void compress() {
+        compress(0, capacity);
+    }
+    [[nodiscard]]
+    int parent(int p) const {
+        return id[p].load(std::memory_order_relaxed);
+    }
+    [[nodiscard]]
+    size_t size() const noexcept {
+        return capacity;
+    }
 };
 #endif //ALGO_UNION_FIND_H